@@ -73,7 +73,7 @@ void CoverageGatherer::writeKmers(){
 	while(iterator.hasNext()){
 		Vertex*node=iterator.next();
 		Kmer key=*(iterator.getKey());
-		CoverageDepth coverage=node->getCoverage(&key);
+		CoverageDepth coverage=m_subgraph->getCoverage(node);
 		m_distributionOfCoverage[coverage]++;
 		#ifdef CONFIG_ASSERT
 		n++;
@@ -111,6 +111,23 @@ void CoverageGatherer::writeKmers(){
 	flushFileOperationBuffer_FILE(true, &buffer, kmerFile, CONFIG_FILE_IO_BUFFER_SIZE);
 	fclose(kmerFile);
 
+/*
+ * The same vertices in the binary format of the checkpoint GenomeGraph,
+ * one file per rank.
+ */
+	ostringstream graphName;
+	graphName<<m_parameters->getPrefix()<<"Rank"<<m_parameters->getRank()<<".kmers.raygraph";
+
+	GraphCheckpoint graphFile;
+	graphFile.constructor();
+
+	if(graphFile.write(graphName.str().c_str(),m_subgraph,m_parameters->getWordSize(),
+		m_parameters->getNumberOfBuckets(),m_parameters->getNumberOfBucketsPerGroup(),
+		m_parameters->getMinimizerPlacement(),GRAPH_CHECKPOINT_VERSION_VARINTS))
+		cout<<"Rank "<<m_parameters->getRank()<<" wrote "<<graphName.str()<<endl;
+	else
+		cout<<"Error: Rank "<<m_parameters->getRank()<<" can not write "<<graphName.str()<<endl;
+
 	#ifdef CONFIG_ASSERT
 	if(n!=m_subgraph->size()){
 		cout<<"n="<<n<<" size="<<m_subgraph->size()<<endl;
@@ -140,7 +157,7 @@ void CoverageGatherer::call_RAY_SLAVE_MODE_SEND_DISTRIBUTION(){
 		while(iterator.hasNext()){
 			Vertex*node=iterator.next();
 			Kmer key=*(iterator.getKey());
-			CoverageDepth coverage=node->getCoverage(&key);
+			CoverageDepth coverage=m_subgraph->getCoverage(node);
 			m_distributionOfCoverage[coverage]++;
 
 			#ifdef CONFIG_ASSERT
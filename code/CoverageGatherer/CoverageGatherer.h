@@ -24,6 +24,7 @@
 
 #include <code/Mock/Parameters.h>
 #include <code/VerticesExtractor/GridTable.h>
+#include <code/VerticesExtractor/GraphCheckpoint.h>
 
 #include <RayPlatform/memory/RingAllocator.h>
 #include <RayPlatform/structures/StaticVector.h>
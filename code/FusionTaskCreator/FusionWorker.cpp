@@ -67,8 +67,7 @@ TODO: does the code pay attention when the coverage indicates a repeated k-mer ?
 			if(m_reverseStrand)
 				kmer=kmer.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
 
-			Rank destination=kmer.vertexRank(m_parameters->getSize(),
-				m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+			Rank destination=m_parameters->vertexRank(&kmer);
 			int elementsPerQuery=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_ASK_VERTEX_PATHS_SIZE);
 			MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(elementsPerQuery);
 			int outputPosition=0;
@@ -114,8 +113,7 @@ TODO: does the code pay attention when the coverage indicates a repeated k-mer ?
 				if(m_reverseStrand)
 					kmer=kmer.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
 	
-				Rank destination=kmer.vertexRank(m_parameters->getSize(),
-					m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+				Rank destination=m_parameters->vertexRank(&kmer);
 				int elementsPerQuery=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_ASK_VERTEX_PATH);
 				MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(elementsPerQuery);
 				int outputPosition=0;
@@ -174,9 +174,9 @@ void GeneOntology::fetchRelevantColors(){
 		}
 
 		VirtualKmerColorHandle color=node->getVirtualColor();
-		set<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
+		vector<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
 
-		for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
+		for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
 			j!=physicalColors->end();j++){
 
 			PhysicalKmerColor physicalColor=*j;
@@ -1318,15 +1318,15 @@ void GeneOntology::countOntologyTermsInGraph(){
 		}
 
 		VirtualKmerColorHandle color=node->getVirtualColor();
-		set<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
+		vector<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
 
-		int kmerCoverage=node->getCoverage(&key);
+		int kmerCoverage=m_subgraph->getCoverage(node);
 
 		// this is the set of gene ontology terms that 
 		// the current k-mer contributes to
 		set<GeneOntologyIdentifier> ontologyTerms;
 
-		for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
+		for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
 			j!=physicalColors->end();j++){
 
 			PhysicalKmerColor physicalColor=*j;
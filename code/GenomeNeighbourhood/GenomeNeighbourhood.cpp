@@ -195,8 +195,7 @@ void GenomeNeighbourhood::fetchPaths(int mode){
 
 	}else if(m_numberOfPathsReceived && !m_requestedPath){
 
-		Rank destination=kmer.vertexRank(m_parameters->getSize(),
-			m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+		Rank destination=m_parameters->vertexRank(&kmer);
 
 		int elementsPerQuery=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_ASK_VERTEX_PATH);
 
@@ -84,8 +84,7 @@ void JoinerWorker::work(){
 			if(m_reverseStrand)
 				kmer=kmer.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
 
-			int destination=kmer.vertexRank(m_parameters->getSize(),
-				m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+			int destination=m_parameters->vertexRank(&kmer);
 
 			#ifdef CONFIG_ASSERT
 			assert(destination < m_parameters->getSize() && destination >= 0);
@@ -139,8 +138,7 @@ void JoinerWorker::work(){
 					kmer=kmer.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
 				}
 
-				int destination=kmer.vertexRank(m_parameters->getSize(),
-					m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+				int destination=m_parameters->vertexRank(&kmer);
 				int elementsPerQuery=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_ASK_VERTEX_PATH);
 				MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(elementsPerQuery);
 
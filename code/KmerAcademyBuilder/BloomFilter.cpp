@@ -31,6 +31,10 @@
 using namespace std;
 
 void BloomFilter::constructor(uint64_t numberOfBits){
+	constructor(numberOfBits,false);
+}
+
+void BloomFilter::constructor(uint64_t numberOfBits,bool blocked){
 	m_numberOfSetBits=0;
 	m_numberOfInsertions=0;
 
@@ -82,6 +86,9 @@ ULL means unsigned long long, it is necessary on some architectures
 	assert(m_hashFunctions == 8);
 	#endif
 
+	m_blocked=blocked;
+	m_blocks=0;
+
 	uint64_t requiredBytes=m_bits/8;
 	uint64_t required8Bytes=requiredBytes/8;
 
@@ -93,9 +100,35 @@ ULL means unsigned long long, it is necessary on some architectures
 	if(m_bits%64!=0)
 		required8Bytes++;
 
-	m_bitmap=(uint64_t*)__Malloc(required8Bytes*sizeof(uint64_t), "RAY_MALLOC_TYPE_BLOOM_FILTER", false);
+/*
+ * In blocked mode, the number of bits is rounded up to
+ * a multiple of the block size.
+ */
+	if(m_blocked){
+		m_blocks=m_bits/BLOOM_FILTER_BLOCK_BITS;
+
+		if(m_bits%BLOOM_FILTER_BLOCK_BITS!=0)
+			m_blocks++;
+
+		required8Bytes=m_blocks*BLOOM_FILTER_BLOCK_WORDS;
+	}
 
-	cout<<"[BloomFilter] allocated "<<required8Bytes*sizeof(uint64_t)<<" bytes for table with "<<m_bits<<" bits"<<endl;
+/*
+ * Allocate one more cache line to align the bitmap on
+ * a cache line.
+ */
+	m_allocation=__Malloc(required8Bytes*sizeof(uint64_t)+BLOOM_FILTER_BLOCK_BYTES, "RAY_MALLOC_TYPE_BLOOM_FILTER", false);
+
+	uintptr_t address=(uintptr_t)m_allocation;
+	address=(address+BLOOM_FILTER_BLOCK_BYTES-1)/BLOOM_FILTER_BLOCK_BYTES*BLOOM_FILTER_BLOCK_BYTES;
+	m_bitmap=(uint64_t*)address;
+
+	cout<<"[BloomFilter] allocated "<<required8Bytes*sizeof(uint64_t)<<" bytes for table with "<<m_bits<<" bits";
+
+	if(m_blocked)
+		cout<<" ("<<m_blocks<<" blocks of "<<BLOOM_FILTER_BLOCK_BITS<<" bits)";
+
+	cout<<endl;
 
 #ifdef CONFIG_VERBOSE_BLOOM_FILTER
 	cout<<"[BloomFilter] hash numbers:";
@@ -123,6 +156,9 @@ ULL means unsigned long long, it is necessary on some architectures
 
 bool BloomFilter::hasValue(Kmer*kmer){
 
+	if(m_blocked)
+		return hasValueInBlock(kmer);
+
 	uint64_t origin=kmer->hash_function_2();
 
 	for(int i=0;i<m_hashFunctions;i++){
@@ -151,6 +187,11 @@ bool BloomFilter::hasValue(Kmer*kmer){
 
 void BloomFilter::insertValue(Kmer*kmer){
 
+	if(m_blocked){
+		insertValueInBlock(kmer);
+		return;
+	}
+
 	uint64_t origin = kmer->hash_function_2();
 
 	#ifdef CONFIG_ASSERT
@@ -207,7 +248,8 @@ void BloomFilter::destructor(){
 	assert(m_bits > 0);
 	#endif
 
-	__Free(m_bitmap,"RAY_MALLOC_TYPE_BLOOM_FILTER",false);
+	__Free(m_allocation,"RAY_MALLOC_TYPE_BLOOM_FILTER",false);
+	m_allocation=NULL;
 	m_bitmap=NULL;
 	m_bits=0;
 	m_hashFunctions=0;
@@ -217,6 +259,31 @@ void BloomFilter::destructor(){
 	#endif
 }
 
+/*
+ * In blocked mode, this is one cache line. Otherwise, this is one
+ * cache line per hash function.
+ */
+void BloomFilter::prefetch(Kmer*kmer){
+
+	uint64_t origin=kmer->hash_function_2();
+
+	if(m_blocked){
+#ifdef __GNUC__
+		__builtin_prefetch(getBlock(origin),1);
+#endif
+		return;
+	}
+
+	for(int i=0;i<m_hashFunctions;i++){
+		uint64_t hashValue = origin ^ m_hashNumbers[i];
+		uint64_t bit=hashValue % m_bits;
+
+#ifdef __GNUC__
+		__builtin_prefetch(m_bitmap+bit/64,1);
+#endif
+	}
+}
+
 uint64_t BloomFilter::getNumberOfBits(){
 	return m_bits;
 }
@@ -228,3 +295,77 @@ uint64_t BloomFilter::getNumberOfSetBits(){
 uint64_t BloomFilter::getNumberOfInsertions(){
 	return m_numberOfInsertions;
 }
+
+bool BloomFilter::isBlocked(){
+	return m_blocked;
+}
+
+uint64_t*BloomFilter::getBlock(uint64_t hashValue){
+	uint64_t block=hashValue%m_blocks;
+
+	return m_bitmap+block*BLOOM_FILTER_BLOCK_WORDS;
+}
+
+/*
+ * Hash function i selects one bit in the word i of the block.
+ * The bit is given by the 6 upper bits of a multiplicative hash.
+ * There is no dependency between the 8 words, so the compiler
+ * can vectorize this loop.
+ */
+void BloomFilter::getBlockMasks(uint64_t hashValue,uint64_t*masks){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_hashFunctions == BLOOM_FILTER_BLOCK_WORDS);
+	#endif
+
+	for(int i=0;i<BLOOM_FILTER_BLOCK_WORDS;i++){
+		/* the multiplier must be odd */
+		uint64_t bitInWord=(hashValue*(m_hashNumbers[i]|1))>>58;
+		masks[i]=((uint64_t)1)<<bitInWord;
+	}
+}
+
+bool BloomFilter::hasValueInBlock(Kmer*kmer){
+
+	uint64_t origin=kmer->hash_function_2();
+	uint64_t*block=getBlock(origin);
+
+	uint64_t masks[BLOOM_FILTER_BLOCK_WORDS];
+	getBlockMasks(origin,masks);
+
+	uint64_t missingBits=0;
+
+	for(int i=0;i<BLOOM_FILTER_BLOCK_WORDS;i++)
+		missingBits|=(masks[i]&~block[i]);
+
+	/* if one bit is 0, the object is not in the BloomFilter */
+	return missingBits==0;
+}
+
+void BloomFilter::insertValueInBlock(Kmer*kmer){
+
+	uint64_t origin=kmer->hash_function_2();
+	uint64_t*block=getBlock(origin);
+
+	uint64_t masks[BLOOM_FILTER_BLOCK_WORDS];
+	getBlockMasks(origin,masks);
+
+	for(int i=0;i<BLOOM_FILTER_BLOCK_WORDS;i++){
+
+/*
+ * The bit is already set to 1. We don't need to do anything else.
+ */
+		if(block[i]&masks[i])
+			continue;
+
+		block[i]|=masks[i];
+
+		m_numberOfSetBits++;
+	}
+
+	#ifdef CONFIG_ASSERT
+	assert(hasValue(kmer));
+	#endif
+
+	m_numberOfInsertions++;
+}
@@ -0,0 +1,56 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "CanonicalKmer.h"
+
+void CanonicalKmer::constructor(const Kmer*kmer,int kmerLength,bool colorSpace){
+
+	Kmer reverseComplement=kmer->complementVertex(kmerLength,colorSpace);
+
+/*
+ * Same test as in GridTable::find
+ */
+	m_isLower=(*kmer)<reverseComplement;
+
+	if(m_isLower)
+		m_lowerKey=*kmer;
+	else
+		m_lowerKey=reverseComplement;
+}
+
+void CanonicalKmer::constructorWithLowerKey(const Kmer*lowerKey){
+	m_lowerKey=*lowerKey;
+	m_isLower=true;
+}
+
+Kmer*CanonicalKmer::getLowerKey(){
+	return &m_lowerKey;
+}
+
+bool CanonicalKmer::isLower()const{
+	return m_isLower;
+}
+
+void CanonicalKmer::getOriginalKmer(Kmer*kmer,int kmerLength,bool colorSpace)const{
+	if(m_isLower)
+		*kmer=m_lowerKey;
+	else
+		*kmer=m_lowerKey.complementVertex(kmerLength,colorSpace);
+}
@@ -0,0 +1,65 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _CanonicalKmer_h
+#define _CanonicalKmer_h
+
+#include "Kmer.h"
+
+/**
+ * A k-mer in its canonical form (the lower k-mer of the pair
+ * k-mer/reverse complement) with the orientation of the k-mer
+ * it was built from.
+ *
+ * The reverse complement is computed at most once, in the constructor.
+ * Code that already has the lower k-mer (keys of the hash table,
+ * k-mers sent by KmerAcademyBuilder) can use constructorWithLowerKey
+ * and no reverse complement is computed at all.
+ *
+ * \author Sébastien Boisvert
+ */
+class CanonicalKmer{
+
+	Kmer m_lowerKey;
+
+	/** the original k-mer is the lower k-mer of the pair */
+	bool m_isLower;
+
+public:
+
+	/** canonicalize a k-mer */
+	void constructor(const Kmer*kmer,int kmerLength,bool colorSpace);
+
+	/** use a k-mer that is already known to be the lower k-mer of its pair */
+	void constructorWithLowerKey(const Kmer*lowerKey);
+
+	Kmer*getLowerKey();
+
+/**
+ * Returns true if the original k-mer is the lower one.
+ * This is the same thing as vertex<vertex.complementVertex(...)
+ */
+	bool isLower()const;
+
+	/** get back the k-mer that was used in the constructor */
+	void getOriginalKmer(Kmer*kmer,int kmerLength,bool colorSpace)const;
+};
+
+#endif
@@ -0,0 +1,179 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "CountingFilter.h"
+
+#include <RayPlatform/memory/allocator.h>
+
+#include <iostream>
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+using namespace std;
+
+void CountingFilter::constructor(uint64_t numberOfCounters){
+
+	#ifdef CONFIG_ASSERT
+	assert(numberOfCounters>0);
+	#endif
+
+	m_numberOfCounters=numberOfCounters;
+	m_numberOfInsertions=0;
+	m_numberOfIncrements=0;
+	m_numberOfUsedCounters=0;
+
+/*
+ * Random bits, see BloomFilter.
+ * They must be odd because they are used as multipliers.
+ */
+	m_hashNumbers[0]=0x4b1c7e3fa59d2c61ULL;
+	m_hashNumbers[1]=0xd2a58c0e6f13b947ULL;
+	m_hashNumbers[2]=0x87e6f1d04c2a3b15ULL;
+	m_hashNumbers[3]=0x3c9d52ab17e86f0dULL;
+
+	m_blocks=m_numberOfCounters/COUNTING_FILTER_BLOCK_BYTES;
+
+	if(m_numberOfCounters%COUNTING_FILTER_BLOCK_BYTES!=0)
+		m_blocks++;
+
+	uint64_t requiredBytes=m_blocks*COUNTING_FILTER_BLOCK_BYTES;
+
+	m_allocation=__Malloc(requiredBytes+COUNTING_FILTER_BLOCK_BYTES,"RAY_MALLOC_TYPE_COUNTING_FILTER",false);
+
+	uintptr_t address=(uintptr_t)m_allocation;
+	address=(address+COUNTING_FILTER_BLOCK_BYTES-1)/COUNTING_FILTER_BLOCK_BYTES*COUNTING_FILTER_BLOCK_BYTES;
+	m_counters=(uint8_t*)address;
+
+	cout<<"[CountingFilter] allocated "<<requiredBytes<<" bytes for "<<m_blocks*COUNTING_FILTER_BLOCK_BYTES<<" counters"<<endl;
+
+	for(uint64_t i=0;i<requiredBytes;i++)
+		m_counters[i]=0;
+}
+
+/*
+ * Fill counters with the addresses of the counters of a k-mer
+ * and return the block.
+ */
+uint8_t*CountingFilter::getCounters(Kmer*kmer,uint8_t**counters){
+
+	uint64_t hashValue=kmer->hash_function_2();
+
+	uint8_t*block=m_counters+(hashValue%m_blocks)*COUNTING_FILTER_BLOCK_BYTES;
+
+	for(int i=0;i<COUNTING_FILTER_HASH_FUNCTIONS;i++){
+		uint64_t counter=(hashValue*m_hashNumbers[i])>>60;
+
+		counters[i]=block+i*COUNTING_FILTER_COUNTERS_PER_HASH_FUNCTION+counter;
+	}
+
+	return block;
+}
+
+void CountingFilter::prefetch(Kmer*kmer){
+
+	uint64_t hashValue=kmer->hash_function_2();
+
+#ifdef __GNUC__
+	__builtin_prefetch(m_counters+(hashValue%m_blocks)*COUNTING_FILTER_BLOCK_BYTES,1);
+#endif
+}
+
+int CountingFilter::getCount(Kmer*kmer){
+
+	uint8_t*counters[COUNTING_FILTER_HASH_FUNCTIONS];
+	getCounters(kmer,counters);
+
+	int minimum=COUNTING_FILTER_MAXIMUM_COUNT;
+
+	for(int i=0;i<COUNTING_FILTER_HASH_FUNCTIONS;i++){
+		if(*(counters[i])<minimum)
+			minimum=*(counters[i]);
+	}
+
+	return minimum;
+}
+
+bool CountingFilter::increment(Kmer*kmer,int maximum){
+
+	if(maximum>COUNTING_FILTER_MAXIMUM_COUNT)
+		maximum=COUNTING_FILTER_MAXIMUM_COUNT;
+
+	uint8_t*counters[COUNTING_FILTER_HASH_FUNCTIONS];
+	getCounters(kmer,counters);
+
+	int minimum=COUNTING_FILTER_MAXIMUM_COUNT;
+
+	for(int i=0;i<COUNTING_FILTER_HASH_FUNCTIONS;i++){
+		if(*(counters[i])<minimum)
+			minimum=*(counters[i]);
+	}
+
+	if(minimum>=maximum)
+		return false;
+
+/*
+ * Conservative update: the counters that are above the minimum
+ * already count other k-mers too.
+ */
+	for(int i=0;i<COUNTING_FILTER_HASH_FUNCTIONS;i++){
+		if(*(counters[i])!=minimum)
+			continue;
+
+		if(minimum==0)
+			m_numberOfUsedCounters++;
+
+		(*(counters[i]))++;
+	}
+
+	if(minimum==0)
+		m_numberOfInsertions++;
+
+	m_numberOfIncrements++;
+
+	return true;
+}
+
+void CountingFilter::destructor(){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_allocation!=NULL);
+	#endif
+
+	__Free(m_allocation,"RAY_MALLOC_TYPE_COUNTING_FILTER",false);
+	m_allocation=NULL;
+	m_counters=NULL;
+	m_blocks=0;
+}
+
+uint64_t CountingFilter::getNumberOfCounters(){
+	return m_blocks*COUNTING_FILTER_BLOCK_BYTES;
+}
+
+uint64_t CountingFilter::getNumberOfUsedCounters(){
+	return m_numberOfUsedCounters;
+}
+
+uint64_t CountingFilter::getNumberOfInsertions(){
+	return m_numberOfInsertions;
+}
+
+uint64_t CountingFilter::getNumberOfIncrements(){
+	return m_numberOfIncrements;
+}
@@ -0,0 +1,110 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _CountingFilter_h
+#define _CountingFilter_h
+
+#include "Kmer.h"
+
+#include <stdint.h>
+
+#define COUNTING_FILTER_BLOCK_BYTES 64
+#define COUNTING_FILTER_HASH_FUNCTIONS 4
+#define COUNTING_FILTER_COUNTERS_PER_HASH_FUNCTION (COUNTING_FILTER_BLOCK_BYTES/COUNTING_FILTER_HASH_FUNCTIONS)
+#define COUNTING_FILTER_MAXIMUM_COUNT 255
+
+/**
+ * A count-min sketch with 8-bit saturating counters.
+ *
+ * This is the counting version of BloomFilter: a k-mer is counted
+ * here until it reaches a threshold, and only then it is promoted
+ * in the GridTable. Sequencing errors seen fewer times than the
+ * threshold never take space in the graph.
+ *
+ * Like the blocked BloomFilter, all the counters of a k-mer are in the same
+ * 64-byte block (a cache line). Each hash function selects one counter
+ * in its own quarter of the block.
+ *
+ * Counters are updated with the conservative update rule (only
+ * the smallest counters are incremented), which reduces the
+ * overestimation.
+ *
+ * The count is never underestimated.
+ *
+ * \see http://en.wikipedia.org/wiki/Count-Min_sketch
+ * \author Sébastien Boisvert
+ */
+class CountingFilter{
+
+	/** the counters, aligned on a cache line */
+	uint8_t*m_counters;
+
+	/** the allocated memory */
+	void*m_allocation;
+
+	/** the number of counters requested */
+	uint64_t m_numberOfCounters;
+
+	uint64_t m_blocks;
+
+	/** a random number for each hash function */
+	uint64_t m_hashNumbers[COUNTING_FILTER_HASH_FUNCTIONS];
+
+	/** k-mers whose count went from 0 to 1 */
+	uint64_t m_numberOfInsertions;
+
+	/** number of increments */
+	uint64_t m_numberOfIncrements;
+
+	/** counters that are not 0 */
+	uint64_t m_numberOfUsedCounters;
+
+	uint8_t*getCounters(Kmer*kmer,uint8_t**counters);
+public:
+
+	/** initialize the filter */
+	void constructor(uint64_t counters);
+
+	/** get the estimated count of a k-mer */
+	int getCount(Kmer*kmer);
+
+/**
+ * Increment the count of a k-mer if its count is lower than maximum.
+ *
+ * \return true if the count was incremented, false if the
+ * k-mer was already seen maximum times
+ */
+	bool increment(Kmer*kmer,int maximum);
+
+/**
+ * Ask the processor to load the block of a k-mer in the cache.
+ * This does nothing else, it is only a hint.
+ */
+	void prefetch(Kmer*kmer);
+
+	void destructor();
+
+	uint64_t getNumberOfCounters();
+	uint64_t getNumberOfUsedCounters();
+	uint64_t getNumberOfInsertions();
+	uint64_t getNumberOfIncrements();
+};
+
+#endif
@@ -395,27 +395,67 @@ uint64_t Kmer::getU64(int i)const{
 	return m_u64[i];
 }
 
+/*
+ * Reverse the order of the 32 nucleotides (2-bit codes) stored in a
+ * 64-bit word.
+ */
+static uint64_t reverseNucleotidesInWord(uint64_t word){
+
+	/* swap adjacent nucleotides */
+	word=((word>>2)&0x3333333333333333ULL)|((word&0x3333333333333333ULL)<<2);
+
+	/* swap adjacent pairs of nucleotides (nibbles) */
+	word=((word>>4)&0x0f0f0f0f0f0f0f0fULL)|((word&0x0f0f0f0f0f0f0f0fULL)<<4);
+
+	/* reverse the bytes */
+#ifdef __GNUC__
+	word=__builtin_bswap64(word);
+#else
+	word=((word>>8)&0x00ff00ff00ff00ffULL)|((word&0x00ff00ff00ff00ffULL)<<8);
+	word=((word>>16)&0x0000ffff0000ffffULL)|((word&0x0000ffff0000ffffULL)<<16);
+	word=(word>>32)|(word<<32);
+#endif
+
+	return word;
+}
+
+/*
+ * The reverse complement is computed one 64-bit word at a time.
+ *
+ * 1. each word is reversed (nucleotide by nucleotide) and complemented
+ *    with a XOR (A=00 <-> T=11, C=01 <-> G=10);
+ * 2. the order of the words is reversed;
+ * 3. the whole array is shifted to the right to remove the
+ *    unused positions, which were at the end before the reversal.
+ */
 Kmer Kmer::complementVertex(int wordSize,bool colorSpace)const{
+
+	uint64_t reversed[KMER_U64_ARRAY_SIZE];
+
+	/* in color space, reverse complement is just reverse */
+	uint64_t complement=0;
+	if(!colorSpace)
+		complement=~complement;
+
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
+		reversed[KMER_U64_ARRAY_SIZE-1-i]=reverseNucleotidesInWord(m_u64[i])^complement;
+	}
+
+	int unusedBits=KMER_U64_ARRAY_SIZE*64-2*wordSize;
+	int wordShift=unusedBits/64;
+	int bitShift=unusedBits%64;
+
 	Kmer output;
-	int bitPositionInOutput=0;
-	uint64_t mask=3;
-	/* the order is inverted and nucleotides are complemented */
-	/* this is costly  */
-	for(int positionInMer=wordSize-1;positionInMer>=0;positionInMer--){
-		int u64_id=positionInMer/32;
-		int bitPositionInChunk=(2*positionInMer)%64;
-		uint64_t chunk=getU64(u64_id);
-		uint64_t j=(chunk<<(62-bitPositionInChunk))>>62;
-		
-		if(!colorSpace) /* in color space, reverse complement is just reverse */
-			j=~j&mask;
-
-		int outputChunk=bitPositionInOutput/64;
-		uint64_t oldValue=output.getU64(outputChunk);
-		oldValue=(oldValue|(j<<(bitPositionInOutput%64)));
-		output.setU64(outputChunk,oldValue);
-		bitPositionInOutput+=2;
+
+	for(int i=0;i+wordShift<KMER_U64_ARRAY_SIZE;i++){
+		uint64_t value=reversed[i+wordShift]>>bitShift;
+
+		if(bitShift!=0 && i+wordShift+1<KMER_U64_ARRAY_SIZE)
+			value|=reversed[i+wordShift+1]<<(64-bitShift);
+
+		output.m_u64[i]=value;
 	}
+
 	return output;
 }
 
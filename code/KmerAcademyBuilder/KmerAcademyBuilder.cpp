@@ -38,6 +38,8 @@ __CreatePlugin(KmerAcademyBuilder);
 
 __CreateSlaveModeAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES);
 
+__CreateMessageTagAdapter(KmerAcademyBuilder,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT);
+
 using namespace std;
 
 void KmerAcademyBuilder::call_RAY_SLAVE_MODE_ADD_VERTICES(){
@@ -45,6 +47,9 @@ void KmerAcademyBuilder::call_RAY_SLAVE_MODE_ADD_VERTICES(){
 	if(!m_initialised){
 		m_initialised=true;
 		(m_mode_send_vertices_sequence_id)=0;
+
+/* with the hash placement, the runs are 1 k-mer long */
+		m_sendSuperKmers=m_parameters->useMinimizerPlacement();
 	}
 
 	MACRO_COLLECT_PROFILING_INFORMATION();
@@ -79,21 +84,6 @@ void KmerAcademyBuilder::call_RAY_SLAVE_MODE_ADD_VERTICES(){
 		return;
 	}
 
-	if(m_mode_send_vertices_sequence_id%100000==0 &&m_mode_send_vertices_sequence_id_position==0
-		&&m_mode_send_vertices_sequence_id<(int)m_myReads->size()){
-
-		string reverse="";
-		if(m_reverseComplementVertex==true){
-			reverse="(reverse complement) ";
-		}
-		printf("Rank %i is counting k-mers in sequence reads %s[%i/%i]\n",m_parameters->getRank(),
-			reverse.c_str(),(int)m_mode_send_vertices_sequence_id+1,(int)m_myReads->size());
-
-		m_derivative.addX(m_mode_send_vertices_sequence_id);
-		m_derivative.printStatus(SLAVE_MODES[RAY_SLAVE_MODE_ADD_VERTICES],RAY_SLAVE_MODE_ADD_VERTICES);
-		m_derivative.printEstimatedTime(m_myReads->size());
-	}
-
 	if(m_mode_send_vertices_sequence_id>(int)m_myReads->size()-1){
 		// flush data
 		flushAll(m_outboxAllocator,m_outbox,m_parameters->getRank());
@@ -115,60 +105,78 @@ void KmerAcademyBuilder::call_RAY_SLAVE_MODE_ADD_VERTICES(){
 		}
 		MACRO_COLLECT_PROFILING_INFORMATION();
 	}else{
-		if(m_mode_send_vertices_sequence_id_position==0){
-			(*m_myReads)[(m_mode_send_vertices_sequence_id)]->getSeq(m_readSequence,m_parameters->getColorSpaceMode(),false);
-
-//#define DEBUG_GCC_4_7_2
+		processReads();
+	}
 
-			#ifdef DEBUG_GCC_4_7_2
-			cout<<"[DEBUG_GCC_4_7_2] read is "<<m_readSequence<<endl;
-			#endif
-		}
+	MACRO_COLLECT_PROFILING_INFORMATION();
+}
 
-		int len=strlen(m_readSequence);
+/*
+ * Extract k-mers from the packed reads with a rolling encoder.
+ *
+ * Several reads are processed in one call. The call returns
+ * when a message was flushed (we must wait for its reply) or when
+ * KMER_ACADEMY_BUILDER_KMERS_PER_TICK positions were processed,
+ * so that the RayPlatform message loop is not starved.
+ */
+void KmerAcademyBuilder::processReads(){
 
-		if(len<m_parameters->getWordSize()){
-			(m_mode_send_vertices_sequence_id)++;
-			(m_mode_send_vertices_sequence_id_position)=0;
-			return;
-		}
+	int kmerLength=m_parameters->getWordSize();
+	int processedPositions=0;
+	int numberOfReads=m_myReads->size();
 
-		char memory[CONFIG_MAXKMERLENGTH+1];
-		int maximumPosition=len-m_parameters->getWordSize()+1;
-		
-		#ifdef CONFIG_ASSERT
-		assert(m_readSequence!=NULL);
-		#endif
+	while(m_mode_send_vertices_sequence_id<numberOfReads
+			&& m_pendingMessages==0
+			&& processedPositions<KMER_ACADEMY_BUILDER_KMERS_PER_TICK){
 
-		int position=(m_mode_send_vertices_sequence_id_position);
+		int readIndex=m_mode_send_vertices_sequence_id;
+		Read*read=(*m_myReads)[readIndex];
+		int length=read->length();
 
-		memcpy(memory,m_readSequence+position,m_parameters->getWordSize());
-		memory[m_parameters->getWordSize()]='\0';
+		if(m_mode_send_vertices_sequence_id_position==0){
 
-		MACRO_COLLECT_PROFILING_INFORMATION();
+			if(readIndex%100000==0){
+				string reverse="";
+				if(m_reverseComplementVertex==true){
+					reverse="(reverse complement) ";
+				}
+				printf("Rank %i is counting k-mers in sequence reads %s[%i/%i]\n",m_parameters->getRank(),
+					reverse.c_str(),readIndex+1,numberOfReads);
+
+				m_derivative.addX(readIndex);
+				m_derivative.printStatus(SLAVE_MODES[RAY_SLAVE_MODE_ADD_VERTICES],RAY_SLAVE_MODE_ADD_VERTICES);
+				m_derivative.printEstimatedTime(numberOfReads);
+			}
 
-		if(isValidDNA(memory)){
-			Kmer kmerToSend=wordId(memory);
+			if(length<kmerLength){
+				m_mode_send_vertices_sequence_id++;
+				continue;
+			}
 
 /*
- * Sets this if you only want to send the lower 
- * k-mer.
- *
- * TODO: the code is suppose to work without __SEND_LOWER, but it does not.
+ * Load the first k-1 nucleotides, the next push
+ * completes the first k-mer.
  */
-			#define __SEND_LOWER
+			m_rollingKmer.reset();
 
-			#ifdef __SEND_LOWER
-			Kmer reverseKmer=kmerToSend.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+			for(int i=0;i<kmerLength-1;i++)
+				m_rollingKmer.pushPackedNucleotide(read->getRawSequence(),i);
+		}
 
-			if(reverseKmer<kmerToSend)
-				kmerToSend=reverseKmer;
-			#endif
-	
-			#undef __SEND_LOWER
+		const uint8_t*sequence=read->getRawSequence();
+		int maximumPosition=length-kmerLength+1;
+
+		while(m_mode_send_vertices_sequence_id_position<maximumPosition
+				&& m_pendingMessages==0
+				&& processedPositions<KMER_ACADEMY_BUILDER_KMERS_PER_TICK){
 
-			MACRO_COLLECT_PROFILING_INFORMATION();
+			int position=m_mode_send_vertices_sequence_id_position;
 
+			m_rollingKmer.pushPackedNucleotide(sequence,position+kmerLength-1);
+
+			#ifdef CONFIG_ASSERT
+			assert(m_rollingKmer.isReady());
+			#endif
 
 /*
  * We only send one of the two kmer at this point.
@@ -179,37 +187,125 @@ void KmerAcademyBuilder::call_RAY_SLAVE_MODE_ADD_VERTICES(){
  * ForwardKmer and ReverseKmer are stored together.
  * To avoid doubling the coverage of any k-mer, we sent
  * only one of them.
+ *
+ * Packed reads only contain A, T, C and G (see Read::constructor),
+ * so every k-mer is valid.
  */
+			Kmer kmerToSend;
+			m_rollingKmer.getLowerKey(&kmerToSend);
 
-			Rank rankToFlush=kmerToSend.vertexRank(m_parameters->getSize(),m_parameters->getWordSize(),
-				m_parameters->getColorSpaceMode());
+			Rank rankToFlush=m_parameters->vertexRankOfLowerKey(&kmerToSend);
 
-			for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
-				m_bufferedData.addAt(rankToFlush,kmerToSend.getU64(i));
-			}
+			if(m_sendSuperKmers){
+				addKmerToRun(read,position,rankToFlush);
+			}else{
+				for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
+					m_bufferedData.addAt(rankToFlush,kmerToSend.getU64(i));
+				}
 
-			if(m_bufferedData.flush(rankToFlush,KMER_U64_ARRAY_SIZE,RAY_MPI_TAG_VERTICES_DATA,
-				m_outboxAllocator,m_outbox,
-				m_parameters->getRank(),false)){
+				if(m_bufferedData.flush(rankToFlush,KMER_U64_ARRAY_SIZE,RAY_MPI_TAG_VERTICES_DATA,
+					m_outboxAllocator,m_outbox,
+					m_parameters->getRank(),false)){
 
-				m_pendingMessages++;
+					m_pendingMessages++;
+				}
 			}
 
-			MACRO_COLLECT_PROFILING_INFORMATION();
+			m_mode_send_vertices_sequence_id_position++;
+			processedPositions++;
 		}
 
-		(m_mode_send_vertices_sequence_id_position++);
-		if((m_mode_send_vertices_sequence_id_position)==maximumPosition){
-			(m_mode_send_vertices_sequence_id)++;
-			(m_mode_send_vertices_sequence_id_position)=0;
+		if(m_mode_send_vertices_sequence_id_position==maximumPosition){
+			closeRun(read);
+
+			m_mode_send_vertices_sequence_id++;
+			m_mode_send_vertices_sequence_id_position=0;
 		}
-			
-		MACRO_COLLECT_PROFILING_INFORMATION();
 	}
 
 	MACRO_COLLECT_PROFILING_INFORMATION();
 }
 
+/*
+ * The consecutive k-mers of a read that go to the same rank
+ * are a run. A run of n k-mers is sent as its n+k-1 nucleotides
+ * instead of n k-mers.
+ */
+void KmerAcademyBuilder::addKmerToRun(Read*read,int position,Rank rank){
+
+	if(m_runKmers>0 && (rank!=m_runRank || m_runKmers==SUPER_KMER_MAXIMUM_KMERS))
+		closeRun(read);
+
+	if(m_runKmers==0){
+		m_runRank=rank;
+		m_runFirstPosition=position;
+	}
+
+	m_runKmers++;
+}
+
+/*
+ * A record of RAY_MPI_TAG_SUPER_KMERS_DATA is the number of nucleotides
+ * followed by the nucleotides, 32 per MessageUnit. The nucleotide i is
+ * at bits 2i and 2i+1 of its unit, like in Kmer.
+ */
+void KmerAcademyBuilder::closeRun(Read*read){
+
+	if(m_runKmers==0)
+		return;
+
+	int kmerLength=m_parameters->getWordSize();
+	int nucleotides=m_runKmers+kmerLength-1;
+	const uint8_t*sequence=read->getRawSequence();
+	int units=1+(nucleotides+31)/32;
+
+/*
+ * The records do not have the same length, so the threshold of
+ * BufferedData::flush does not guarantee that the next one fits.
+ * The buffer is sent before it overflows.
+ */
+	if(m_bufferedData.size(m_runRank)+units>KMER_ACADEMY_BUILDER_BUFFER_CAPACITY){
+		if(m_bufferedData.flush(m_runRank,units,RAY_MPI_TAG_SUPER_KMERS_DATA,
+			m_outboxAllocator,m_outbox,
+			m_parameters->getRank(),true)){
+
+			m_pendingMessages++;
+		}
+	}
+
+	#ifdef CONFIG_ASSERT
+	assert(m_bufferedData.size(m_runRank)+units<=KMER_ACADEMY_BUILDER_BUFFER_CAPACITY);
+	#endif
+
+	m_bufferedData.addAt(m_runRank,nucleotides);
+
+	MessageUnit codes=0;
+
+	for(int i=0;i<nucleotides;i++){
+		int position=m_runFirstPosition+i;
+		MessageUnit code=(sequence[position/4]>>(2*(position%4)))&3;
+
+		codes|=code<<(2*(i%32));
+
+		if(i%32==31 || i==nucleotides-1){
+			m_bufferedData.addAt(m_runRank,codes);
+			codes=0;
+		}
+	}
+
+	m_runKmers=0;
+
+/* a full buffer is not kept until the next record */
+	if(m_bufferedData.size(m_runRank)==KMER_ACADEMY_BUILDER_BUFFER_CAPACITY){
+		if(m_bufferedData.flush(m_runRank,units,RAY_MPI_TAG_SUPER_KMERS_DATA,
+			m_outboxAllocator,m_outbox,
+			m_parameters->getRank(),true)){
+
+			m_pendingMessages++;
+		}
+	}
+}
+
 void KmerAcademyBuilder::setProfiler(Profiler*profiler){
 	m_profiler = profiler;
 }
@@ -235,7 +331,10 @@ SlaveMode*mode,RingAllocator*outboxAllocator){
 
 	m_mode_send_vertices_sequence_id=0;
 	m_mode_send_vertices_sequence_id_position=0;
-	m_bufferedData.constructor(size,MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit),"RAY_MALLOC_TYPE_KMER_ACADEMY_BUFFER",m_parameters->showMemoryAllocations(),KMER_U64_ARRAY_SIZE);
+	m_sendSuperKmers=false;
+	m_runKmers=0;
+	m_rollingKmer.constructor(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+	m_bufferedData.constructor(size,KMER_ACADEMY_BUILDER_BUFFER_CAPACITY,"RAY_MALLOC_TYPE_KMER_ACADEMY_BUFFER",m_parameters->showMemoryAllocations(),KMER_U64_ARRAY_SIZE);
 	
 	m_pendingMessages=0;
 	m_size=size;
@@ -254,7 +353,12 @@ void KmerAcademyBuilder::setReadiness(){
 
 void KmerAcademyBuilder::flushAll(RingAllocator*m_outboxAllocator,StaticVector*m_outbox,int rank){
 	if(!m_bufferedData.isEmpty()){
-		m_pendingMessages+=m_bufferedData.flushAll(RAY_MPI_TAG_VERTICES_DATA,
+		MessageTag tag=RAY_MPI_TAG_VERTICES_DATA;
+
+		if(m_sendSuperKmers)
+			tag=RAY_MPI_TAG_SUPER_KMERS_DATA;
+
+		m_pendingMessages+=m_bufferedData.flushAll(tag,
 			m_outboxAllocator,m_outbox,rank);
 		return;
 	}
@@ -267,6 +371,7 @@ bool KmerAcademyBuilder::finished(){
 void KmerAcademyBuilder::assertBuffersAreEmpty(){
 	assert(m_bufferedData.isEmpty());
 	assert(m_mode_send_vertices_sequence_id_position==0);
+	assert(m_runKmers==0);
 }
 
 void KmerAcademyBuilder::incrementPendingMessages(){
@@ -287,6 +392,38 @@ void KmerAcademyBuilder::setDistributionAsCompleted(){
 	m_distributionIsCompleted=true;
 }
 
+/*
+ * The master sends the table of -minimizer-placement before the k-mers
+ * are counted: [first bucket, buckets, 2 buckets per MessageUnit].
+ * Each bucket is its rank plus 1, 0 is MINIMIZER_PLACEMENT_SCATTER.
+ */
+void KmerAcademyBuilder::call_RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT(Message*message){
+
+	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
+	MinimizerPlacement*placement=m_parameters->getMinimizerPlacement();
+
+	int first=incoming[0];
+	int buckets=incoming[1];
+
+	#ifdef CONFIG_ASSERT
+	assert(placement!=NULL);
+	assert(message->getCount()==2+(buckets+1)/2);
+	assert(first+buckets<=placement->getNumberOfBuckets());
+	#endif
+
+	for(int i=0;i<buckets;i++){
+		uint32_t value=incoming[2+i/2]>>(32*(i%2));
+
+		placement->setBucketRank(first+i,(Rank)value-1);
+	}
+
+	if(first+buckets==placement->getNumberOfBuckets())
+		m_parameters->enableMinimizerPlacement();
+
+	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY,m_parameters->getRank());
+	m_outbox->push_back(&aMessage);
+}
+
 void KmerAcademyBuilder::registerPlugin(ComputeCore*core){
 	PluginHandle plugin=core->allocatePluginHandle();
 
@@ -301,6 +438,12 @@ void KmerAcademyBuilder::registerPlugin(ComputeCore*core){
 	core->setSlaveModeObjectHandler(plugin,RAY_SLAVE_MODE_ADD_VERTICES, __GetAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES));
 	core->setSlaveModeSymbol(plugin,RAY_SLAVE_MODE_ADD_VERTICES,"RAY_SLAVE_MODE_ADD_VERTICES");
 
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagObjectHandler(plugin,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT, __GetAdapter(KmerAcademyBuilder,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT));
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT");
+
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY");
 
 }
 
@@ -310,9 +453,13 @@ void KmerAcademyBuilder::resolveSymbols(ComputeCore*core){
 	RAY_MPI_TAG_KMER_ACADEMY_DISTRIBUTED=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_KMER_ACADEMY_DISTRIBUTED");
 	RAY_MPI_TAG_VERTICES_DATA_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTICES_DATA_REPLY");
 	RAY_MPI_TAG_VERTICES_DATA=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTICES_DATA");
+	RAY_MPI_TAG_SUPER_KMERS_DATA=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SUPER_KMERS_DATA");
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT");
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY");
 
 	__BindPlugin(KmerAcademyBuilder);
 
 	__BindAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES);
+	__BindAdapter(KmerAcademyBuilder,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT);
 
 }
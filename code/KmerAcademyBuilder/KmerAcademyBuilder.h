@@ -22,6 +22,8 @@
 #ifndef _KmerAcademyBuilder
 #define _KmerAcademyBuilder
 
+#include "RollingKmer.h"
+
 #include <code/VerticesExtractor/GridTable.h>
 #include <code/Mock/Parameters.h>
 #include <code/Mock/common_functions.h>
@@ -40,10 +42,27 @@
 #include <vector>
 using namespace std;
 
+/*
+ * The maximum number of k-mer positions processed in one call
+ * to RAY_SLAVE_MODE_ADD_VERTICES.
+ */
+#define KMER_ACADEMY_BUILDER_KMERS_PER_TICK 4096
+
+/*
+ * The maximum number of k-mers in a record of
+ * RAY_MPI_TAG_SUPER_KMERS_DATA.
+ */
+#define SUPER_KMER_MAXIMUM_KMERS 224
+
+/* the MessageUnits of a rank in m_bufferedData */
+#define KMER_ACADEMY_BUILDER_BUFFER_CAPACITY ((int)(MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit)))
+
 __DeclarePlugin(KmerAcademyBuilder);
 
 __DeclareSlaveModeAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES);
 
+__DeclareMessageTagAdapter(KmerAcademyBuilder,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT);
+
 /*
  * Any MPI rank has some reads to process.
  * KmerAcademyBuilder extracts k-mers from these reads.
@@ -55,10 +74,14 @@ __DeclareSlaveModeAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES);
 class KmerAcademyBuilder : public CorePlugin{
 
 	__AddAdapter(KmerAcademyBuilder,RAY_SLAVE_MODE_ADD_VERTICES);
+	__AddAdapter(KmerAcademyBuilder,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT);
 
 	MessageTag RAY_MPI_TAG_KMER_ACADEMY_DISTRIBUTED;
 	MessageTag RAY_MPI_TAG_VERTICES_DATA_REPLY;
 	MessageTag RAY_MPI_TAG_VERTICES_DATA;
+	MessageTag RAY_MPI_TAG_SUPER_KMERS_DATA;
+	MessageTag RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT;
+	MessageTag RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY;
 
 	SlaveMode RAY_SLAVE_MODE_ADD_VERTICES;
 
@@ -69,7 +92,9 @@ class KmerAcademyBuilder : public CorePlugin{
 	/** this we check the checkpoint ? */
 	bool m_checkedCheckpoint;
 
-	char m_readSequence[RAY_MAXIMUM_READ_LENGTH];
+	/** forward and reverse-complement k-mers at the current position */
+	RollingKmer m_rollingKmer;
+
 	bool m_distributionIsCompleted;
 	Parameters*m_parameters;
 
@@ -89,12 +114,24 @@ class KmerAcademyBuilder : public CorePlugin{
 
 	int m_pendingMessages;
 
+	/** send the runs of k-mers as super k-mers */
+	bool m_sendSuperKmers;
+
+	/** the current run of k-mers for the same rank */
+	Rank m_runRank;
+	int m_runFirstPosition;
+	int m_runKmers;
+
 	ArrayOfReads*m_myReads;
 	BufferedData m_bufferedData;
 	int m_size;
 
 	bool m_finished;
 	GridTable*m_subgraph;
+
+	void processReads();
+	void addKmerToRun(Read*read,int position,Rank rank);
+	void closeRun(Read*read);
 public:
 
 	BufferedData m_buffersForIngoingEdgesToDelete;
@@ -108,6 +145,7 @@ SlaveMode*mode,RingAllocator*outboxAllocator
 	void setProfiler(Profiler*profiler);
 
 	void call_RAY_SLAVE_MODE_ADD_VERTICES();
+	void call_RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT(Message*message);
 
 	void setReadiness();
 
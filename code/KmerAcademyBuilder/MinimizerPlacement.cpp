@@ -0,0 +1,378 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "MinimizerPlacement.h"
+#include "RollingKmer.h"
+
+#include <code/Mock/Parameters.h>
+#include <code/SequencesLoader/Loader.h>
+
+#include <RayPlatform/cryptography/crypto.h>
+
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <stdlib.h>
+using namespace std;
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void MinimizerPlacement::constructor(int kmerLength,int minimizerLength,bool colorSpace,int size){
+
+/* the m-mers are in one 64-bit word */
+	if(minimizerLength>31)
+		minimizerLength=31;
+
+	if(minimizerLength>kmerLength)
+		minimizerLength=kmerLength;
+
+	if(minimizerLength<1)
+		minimizerLength=1;
+
+	m_kmerLength=kmerLength;
+	m_minimizerLength=minimizerLength;
+	m_colorSpace=colorSpace;
+	m_size=size;
+
+	m_minimizerMask=(((uint64_t)1)<<(2*m_minimizerLength))-1;
+
+/* until the table is balanced, the buckets are dealt like cards */
+	m_ranks.resize(m_size*MINIMIZER_PLACEMENT_BUCKETS_PER_RANK);
+
+	for(int bucket=0;bucket<(int)m_ranks.size();bucket++)
+		m_ranks[bucket]=bucket%m_size;
+}
+
+/*
+ * The m-mers are rolled like in RollingKmer: the nucleotide at position p
+ * is at bits 2p and 2p+1, the reverse complement is updated at the same time.
+ */
+uint64_t MinimizerPlacement::getMinimizerHash(Kmer*kmer){
+
+	uint64_t forward=0;
+	uint64_t reverse=0;
+	int lastShift=2*(m_minimizerLength-1);
+
+	uint64_t minimum=~((uint64_t)0);
+
+	for(int position=0;position<m_kmerLength;position++){
+		uint64_t code=(kmer->getU64(position/32)>>(2*(position%32)))&3;
+
+		forward=(forward>>2)|(code<<lastShift);
+
+		if(!m_colorSpace)
+			code^=3;
+
+		reverse=((reverse<<2)|code)&m_minimizerMask;
+
+		if(position<m_minimizerLength-1)
+			continue;
+
+		uint64_t canonical=forward;
+
+		if(reverse<canonical)
+			canonical=reverse;
+
+		uint64_t hash=uniform_hashing_function_1_64_64(canonical);
+
+		if(hash<minimum)
+			minimum=hash;
+	}
+
+	return minimum;
+}
+
+/*
+ * The smallest hash values are not uniform, so they are hashed again.
+ */
+int MinimizerPlacement::getBucket(Kmer*kmer){
+	return uniform_hashing_function_2_64_64(getMinimizerHash(kmer))%m_ranks.size();
+}
+
+Rank MinimizerPlacement::getRank(Kmer*kmer){
+
+	Rank rank=m_ranks[getBucket(kmer)];
+
+	if(rank==MINIMIZER_PLACEMENT_SCATTER)
+		return kmer->vertexRank(m_size,m_kmerLength,m_colorSpace);
+
+	return rank;
+}
+
+Rank MinimizerPlacement::getRankOfLowerKey(Kmer*lowerKey){
+
+	Rank rank=m_ranks[getBucket(lowerKey)];
+
+	if(rank==MINIMIZER_PLACEMENT_SCATTER)
+		return lowerKey->hash_function_1()%m_size;
+
+	return rank;
+}
+
+int MinimizerPlacement::getMinimizerLength(){
+	return m_minimizerLength;
+}
+
+int MinimizerPlacement::getNumberOfBuckets(){
+	return m_ranks.size();
+}
+
+Rank MinimizerPlacement::getBucketRank(int bucket){
+	return m_ranks[bucket];
+}
+
+void MinimizerPlacement::setBucketRank(int bucket,Rank rank){
+
+	#ifdef CONFIG_ASSERT
+	assert(bucket>=0 && bucket<(int)m_ranks.size());
+	assert(rank==MINIMIZER_PLACEMENT_SCATTER || (rank>=0 && rank<m_size));
+	#endif
+
+	m_ranks[bucket]=rank;
+}
+
+uint64_t MinimizerPlacement::getChecksum(){
+
+	uint64_t checksum=uniform_hashing_function_1_64_64(m_minimizerLength);
+
+	for(int bucket=0;bucket<(int)m_ranks.size();bucket++)
+		checksum=uniform_hashing_function_1_64_64(checksum^(uint64_t)(m_ranks[bucket]+1));
+
+	return checksum;
+}
+
+bool MinimizerPlacement::writeCheckpoint(const char*file){
+
+	ofstream f(file);
+
+	int colorSpace=m_colorSpace;
+	int buckets=m_ranks.size();
+
+	f.write((char*)&m_kmerLength,sizeof(int));
+	f.write((char*)&m_minimizerLength,sizeof(int));
+	f.write((char*)&colorSpace,sizeof(int));
+	f.write((char*)&m_size,sizeof(int));
+	f.write((char*)&buckets,sizeof(int));
+
+	for(int bucket=0;bucket<buckets;bucket++)
+		f.write((char*)&(m_ranks[bucket]),sizeof(Rank));
+
+	bool ok=f.good();
+
+	f.close();
+
+	return ok;
+}
+
+bool MinimizerPlacement::readCheckpoint(const char*file){
+
+	ifstream f(file);
+
+	int kmerLength=0;
+	int minimizerLength=0;
+	int colorSpace=0;
+	int size=0;
+	int buckets=0;
+
+	f.read((char*)&kmerLength,sizeof(int));
+	f.read((char*)&minimizerLength,sizeof(int));
+	f.read((char*)&colorSpace,sizeof(int));
+	f.read((char*)&size,sizeof(int));
+	f.read((char*)&buckets,sizeof(int));
+
+	if(!f.good())
+		return false;
+
+	if(kmerLength!=m_kmerLength || minimizerLength!=m_minimizerLength
+		|| colorSpace!=(int)m_colorSpace){
+
+		cout<<"Error: checkpoint MinimizerPlacement has k-mer length "<<kmerLength;
+		cout<<" and minimizer length "<<minimizerLength<<", expected "<<m_kmerLength;
+		cout<<" and "<<m_minimizerLength<<endl;
+		return false;
+	}
+
+	if(size!=m_size || buckets!=(int)m_ranks.size()){
+		cout<<"Error: checkpoint MinimizerPlacement is for "<<size<<" ranks, expected "<<m_size<<endl;
+		return false;
+	}
+
+	for(int bucket=0;bucket<buckets;bucket++){
+		Rank rank=0;
+		f.read((char*)&rank,sizeof(Rank));
+
+		if(!f.good() || (rank!=MINIMIZER_PLACEMENT_SCATTER && (rank<0 || rank>=m_size)))
+			return false;
+
+		m_ranks[bucket]=rank;
+	}
+
+	f.close();
+
+	return true;
+}
+
+void MinimizerPlacement::build(Parameters*parameters){
+
+	vector<LargeCount> loads(m_ranks.size(),0);
+
+	sampleKmers(parameters,&loads);
+	balance(&loads);
+
+	int scattered=0;
+
+	for(int bucket=0;bucket<(int)m_ranks.size();bucket++){
+		if(m_ranks[bucket]==MINIMIZER_PLACEMENT_SCATTER)
+			scattered++;
+	}
+
+	cout<<"Rank "<<parameters->getRank()<<": the k-mers are placed with minimizers of length "<<m_minimizerLength;
+	cout<<", "<<scattered<<" heavy buckets of "<<m_ranks.size()<<" are scattered"<<endl;
+}
+
+/*
+ * The first k-mers of each file are read on the master, the files
+ * already have their offsets (see Partitioner). A file without offsets
+ * is not sampled: it would be read from the start to the end.
+ */
+void MinimizerPlacement::sampleKmers(Parameters*parameters,vector<LargeCount>*loads){
+
+	int files=parameters->getNumberOfFiles();
+
+	if(files==0)
+		return;
+
+	LargeCount kmersPerFile=MINIMIZER_PLACEMENT_SAMPLE_KMERS/files+1;
+
+	Loader loader;
+	loader.constructor(parameters->getMemoryPrefix().c_str(),parameters->showMemoryAllocations(),
+		parameters->getRank());
+
+	RollingKmer rollingKmer;
+	rollingKmer.constructor(m_kmerLength,m_colorSpace);
+
+	for(int file=0;file<files;file++){
+
+		LargeCount sequences=parameters->getNumberOfSequences(file);
+
+		if(sequences==0)
+			continue;
+
+		if(loader.loadAt(parameters->getFile(file),sequences,0,
+			parameters->getSequenceOffsetsFile(file))!=EXIT_SUCCESS){
+
+			cout<<"Rank "<<parameters->getRank()<<": file "<<parameters->getFile(file);
+			cout<<" has no offsets, its k-mers are not sampled"<<endl;
+			continue;
+		}
+
+		LargeCount sampled=0;
+
+		for(LargeIndex sequence=0;sequence<loader.size() && sampled<kmersPerFile;sequence++){
+			Read*read=loader.at(sequence);
+			const uint8_t*nucleotides=read->getRawSequence();
+
+			rollingKmer.reset();
+
+			for(int position=0;position<read->length() && sampled<kmersPerFile;position++){
+				rollingKmer.pushPackedNucleotide(nucleotides,position);
+
+				if(!rollingKmer.isReady())
+					continue;
+
+				Kmer kmer;
+				rollingKmer.getForward(&kmer);
+
+				(*loads)[getBucket(&kmer)]++;
+				sampled++;
+			}
+		}
+
+		loader.reset();
+	}
+
+	loader.clear();
+}
+
+/*
+ * The heaviest buckets first, the order of the buckets breaks the ties.
+ */
+static bool compareBucketLoads(const pair<LargeCount,int>&a,const pair<LargeCount,int>&b){
+	if(a.first!=b.first)
+		return a.first>b.first;
+
+	return a.second<b.second;
+}
+
+/*
+ * Longest processing time first: each bucket goes to the rank that has
+ * the fewest sampled k-mers so far. The scattered k-mers are on
+ * all the ranks.
+ */
+void MinimizerPlacement::balance(vector<LargeCount>*loads){
+
+	LargeCount total=0;
+
+	for(int bucket=0;bucket<(int)loads->size();bucket++)
+		total+=loads->at(bucket);
+
+/* nothing was sampled, the buckets stay dealt like cards */
+	if(total==0)
+		return;
+
+	LargeCount heavyLoad=total/m_size/MINIMIZER_PLACEMENT_HEAVY_FRACTION;
+	LargeCount scattered=0;
+
+	vector<pair<LargeCount,int> > buckets;
+
+	for(int bucket=0;bucket<(int)loads->size();bucket++){
+		LargeCount load=loads->at(bucket);
+
+		if(m_size>1 && heavyLoad>0 && load>heavyLoad){
+			m_ranks[bucket]=MINIMIZER_PLACEMENT_SCATTER;
+			scattered+=load;
+			continue;
+		}
+
+		buckets.push_back(make_pair(load,bucket));
+	}
+
+	sort(buckets.begin(),buckets.end(),compareBucketLoads);
+
+/* the lightest rank is at the top, the lowest rank breaks the ties */
+	priority_queue<pair<LargeCount,Rank>,vector<pair<LargeCount,Rank> >,greater<pair<LargeCount,Rank> > > ranks;
+
+	for(Rank rank=0;rank<m_size;rank++)
+		ranks.push(make_pair(scattered/m_size,rank));
+
+	for(int i=0;i<(int)buckets.size();i++){
+		pair<LargeCount,Rank> lightest=ranks.top();
+		ranks.pop();
+
+		m_ranks[buckets[i].second]=lightest.second;
+
+		lightest.first+=buckets[i].first;
+		ranks.push(lightest);
+	}
+}
@@ -0,0 +1,119 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _MinimizerPlacement_h
+#define _MinimizerPlacement_h
+
+#include "Kmer.h"
+
+#include <RayPlatform/core/types.h>
+
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+class Parameters;
+
+#define MINIMIZER_PLACEMENT_DEFAULT_LENGTH 11
+
+/** the buckets of minimizers for each rank in the balancing table */
+#define MINIMIZER_PLACEMENT_BUCKETS_PER_RANK 64
+
+/** the number of k-mers of the input files used to balance the table */
+#define MINIMIZER_PLACEMENT_SAMPLE_KMERS 4194304
+
+/** a bucket is heavy if it has more than 1/4 of the k-mers of a rank */
+#define MINIMIZER_PLACEMENT_HEAVY_FRACTION 4
+
+/** the k-mers of a heavy bucket are placed with hash_function_1 */
+#define MINIMIZER_PLACEMENT_SCATTER (-1)
+
+/**
+ * Place the k-mers on the ranks with their minimizer instead of
+ * hash_function_1.
+ *
+ * The minimizer of a k-mer is its m-mer with the smallest hash
+ * value. The m-mers are canonical (the lower of the m-mer and of its
+ * reverse complement), so a k-mer and its reverse complement have the same
+ * minimizer. Adjacent k-mers of a read usually share their minimizer
+ * and therefore go to the same rank.
+ *
+ * The minimizers are grouped in buckets and the balancing table gives
+ * the rank of each bucket. Some minimizers (low complexity, repeats)
+ * are much more frequent than the others, so the table is balanced with
+ * a sample of the k-mers of the input files: the largest buckets are
+ * assigned first, each one to the rank with the fewest k-mers.
+ * A heavy bucket would overload any rank, its k-mers are
+ * scattered with hash_function_1 like before.
+ *
+ * The master reads the sample and computes the table, it is sent to
+ * the other ranks before the k-mers are counted (see MachineHelper).
+ * The table is written in the checkpoint MinimizerPlacement, and the
+ * GenomeGraph checkpoint stores its checksum because the vertices
+ * must stay on the ranks where they were written.
+ *
+ * \author Sébastien Boisvert
+ */
+class MinimizerPlacement{
+
+	int m_kmerLength;
+	int m_minimizerLength;
+	bool m_colorSpace;
+	int m_size;
+
+	uint64_t m_minimizerMask;
+
+	/** the rank of each bucket, or MINIMIZER_PLACEMENT_SCATTER */
+	vector<Rank> m_ranks;
+
+	uint64_t getMinimizerHash(Kmer*kmer);
+	int getBucket(Kmer*kmer);
+	void sampleKmers(Parameters*parameters,vector<LargeCount>*loads);
+	void balance(vector<LargeCount>*loads);
+
+public:
+
+	void constructor(int kmerLength,int minimizerLength,bool colorSpace,int size);
+
+	/** compute the balancing table */
+	void build(Parameters*parameters);
+
+	int getNumberOfBuckets();
+	Rank getBucketRank(int bucket);
+	void setBucketRank(int bucket,Rank rank);
+
+	/** identifies the table in the GenomeGraph checkpoint */
+	uint64_t getChecksum();
+
+	bool writeCheckpoint(const char*file);
+
+	/** false if the checkpoint is for other options or another number of ranks */
+	bool readCheckpoint(const char*file);
+
+	/** the rank of a k-mer, on either strand */
+	Rank getRank(Kmer*kmer);
+
+	/** the rank of a k-mer that is already the lower key */
+	Rank getRankOfLowerKey(Kmer*lowerKey);
+
+	int getMinimizerLength();
+};
+
+#endif
@@ -0,0 +1,134 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "RollingKmer.h"
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void RollingKmer::constructor(int kmerLength,bool colorSpace){
+
+	#ifdef CONFIG_ASSERT
+	assert(kmerLength>0);
+	assert(kmerLength<=CONFIG_MAXKMERLENGTH);
+	#endif
+
+	m_kmerLength=kmerLength;
+	m_colorSpace=colorSpace;
+
+	int lastBitPosition=2*(kmerLength-1);
+	m_lastWord=lastBitPosition/64;
+	m_lastShift=lastBitPosition%64;
+
+	int bitsInLastWord=2*kmerLength-64*m_lastWord;
+
+	m_lastWordMask=~((uint64_t)0);
+
+	if(bitsInLastWord<64)
+		m_lastWordMask=(((uint64_t)1)<<bitsInLastWord)-1;
+
+	reset();
+}
+
+void RollingKmer::reset(){
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
+		m_forward[i]=0;
+		m_reverse[i]=0;
+	}
+
+	m_loadedNucleotides=0;
+}
+
+void RollingKmer::push(uint8_t code){
+
+	uint64_t value=code;
+
+/*
+ * Forward strand: the first nucleotide goes away and
+ * the new one is appended at position k-1.
+ */
+	for(int i=0;i<m_lastWord;i++)
+		m_forward[i]=(m_forward[i]>>2)|(m_forward[i+1]<<62);
+
+	m_forward[m_lastWord]>>=2;
+	m_forward[m_lastWord]|=(value<<m_lastShift);
+
+/*
+ * Reverse strand: everything moves one position up, the nucleotide
+ * at position k-1 falls off and the complement of the new one
+ * is placed at position 0.
+ * In color space, the reverse complement is just the reverse.
+ */
+	for(int i=m_lastWord;i>0;i--)
+		m_reverse[i]=(m_reverse[i]<<2)|(m_reverse[i-1]>>62);
+
+	m_reverse[0]<<=2;
+	m_reverse[m_lastWord]&=m_lastWordMask;
+
+	if(!m_colorSpace)
+		value^=3;
+
+	m_reverse[0]|=value;
+
+	if(m_loadedNucleotides<m_kmerLength)
+		m_loadedNucleotides++;
+}
+
+void RollingKmer::pushPackedNucleotide(const uint8_t*sequence,int position){
+	uint8_t code=(sequence[position/4]>>(2*(position%4)))&3;
+
+	push(code);
+}
+
+bool RollingKmer::isReady()const{
+	return m_loadedNucleotides==m_kmerLength;
+}
+
+void RollingKmer::getForward(Kmer*kmer)const{
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++)
+		kmer->setU64(i,m_forward[i]);
+}
+
+void RollingKmer::getReverse(Kmer*kmer)const{
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++)
+		kmer->setU64(i,m_reverse[i]);
+}
+
+void RollingKmer::getLowerKey(Kmer*kmer)const{
+
+	#ifdef CONFIG_ASSERT
+	assert(isReady());
+	#endif
+
+/*
+ * Same order as Kmer::operator<
+ */
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
+		if(m_reverse[i]<m_forward[i]){
+			getReverse(kmer);
+			return;
+		}else if(m_reverse[i]>m_forward[i]){
+			break;
+		}
+	}
+
+	getForward(kmer);
+}
@@ -0,0 +1,86 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _RollingKmer_h
+#define _RollingKmer_h
+
+#include "Kmer.h"
+
+#include <stdint.h>
+
+/**
+ * A rolling 2-bit encoder for k-mers.
+ *
+ * The forward k-mer and its reverse complement are kept up to date
+ * with shift/or operations when a nucleotide code is pushed.
+ * This avoids going through wordId() and complementVertex() for every
+ * position of a sequence.
+ *
+ * The layout is the one of Kmer: the nucleotide at position p
+ * is stored at bits 2p and 2p+1.
+ *
+ * \author Sébastien Boisvert
+ */
+class RollingKmer{
+
+	uint64_t m_forward[KMER_U64_ARRAY_SIZE];
+	uint64_t m_reverse[KMER_U64_ARRAY_SIZE];
+
+	int m_kmerLength;
+	bool m_colorSpace;
+
+	/** the 64-bit word that contains the last nucleotide */
+	int m_lastWord;
+
+	/** bit position of the last nucleotide in m_lastWord */
+	int m_lastShift;
+
+	/** the valid bits in m_lastWord */
+	uint64_t m_lastWordMask;
+
+	/** the number of nucleotides pushed since the last reset */
+	int m_loadedNucleotides;
+
+public:
+	void constructor(int kmerLength,bool colorSpace);
+
+	/** forget every nucleotide pushed so far */
+	void reset();
+
+	/** append a nucleotide code (RAY_NUCLEOTIDE_*) at the end of the k-mer */
+	void push(uint8_t code);
+
+	/**
+	 * push the nucleotide at the given position of a sequence
+	 * packed with 4 nucleotides per byte (see Read)
+	 */
+	void pushPackedNucleotide(const uint8_t*sequence,int position);
+
+	/** at least k nucleotides were pushed */
+	bool isReady()const;
+
+	void getForward(Kmer*kmer)const;
+	void getReverse(Kmer*kmer)const;
+
+	/** same result as Kmer::getLowerKey */
+	void getLowerKey(Kmer*kmer)const;
+};
+
+#endif
@@ -402,6 +402,7 @@ void MachineHelper::call_RAY_MASTER_MODE_LOAD_SEQUENCES(){
 			int bufferSize=0;
 			message[bufferSize++]=m_fileIndex;
 			message[bufferSize++]=m_parameters->getNumberOfSequences(m_fileIndex);
+			message[bufferSize++]=m_parameters->getNumberOfKmerPositions(m_fileIndex);
 
 			for(Rank i=0;i<getSize();i++){
 				Message aMessage(message,bufferSize,
@@ -438,8 +439,78 @@ void MachineHelper::call_RAY_MASTER_MODE_LOAD_SEQUENCES(){
 }
 
 void MachineHelper::call_RAY_MASTER_MODE_TRIGGER_VERTICE_DISTRIBUTION(){
-	m_timePrinter->printElapsedTime("Sequence loading");
-	cout<<endl;
+
+	MinimizerPlacement*placement=m_parameters->getMinimizerPlacement();
+
+/*
+ * The table of -minimizer-placement is built here and sent to every rank
+ * before the k-mers are counted.
+ */
+	if(placement!=NULL && !m_builtMinimizerPlacement){
+		m_timePrinter->printElapsedTime("Sequence loading");
+		cout<<endl;
+
+		if(!m_parameters->buildMinimizerPlacement()){
+			(*m_aborted)=true;
+			m_switchMan->setSlaveMode(RAY_SLAVE_MODE_DO_NOTHING);
+			m_switchMan->setMasterMode(RAY_MASTER_MODE_KILL_ALL_MPI_RANKS);
+			return;
+		}
+
+		m_builtMinimizerPlacement=true;
+		m_minimizerPlacementBucket=0;
+		m_sentMinimizerPlacement=false;
+		return;
+
+	}else if(placement!=NULL && m_minimizerPlacementBucket<placement->getNumberOfBuckets()){
+
+		if(!m_sentMinimizerPlacement){
+			MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
+			int maximumUnits=MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit);
+			int bucket=m_minimizerPlacementBucket;
+			int buckets=0;
+
+			while(bucket<placement->getNumberOfBuckets() && 2+(buckets+2)/2<=maximumUnits){
+				uint64_t value=placement->getBucketRank(bucket)+1;
+
+				if(buckets%2==0)
+					message[2+buckets/2]=value;
+				else
+					message[2+buckets/2]|=value<<32;
+
+				bucket++;
+				buckets++;
+			}
+
+			message[0]=m_minimizerPlacementBucket;
+			message[1]=buckets;
+
+			for(Rank i=0;i<getSize();i++){
+				Message aMessage(message,2+(buckets+1)/2,i,RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT,getRank());
+				m_outbox->push_back(&aMessage);
+			}
+
+			m_nextMinimizerPlacementBucket=bucket;
+			m_numberOfRanksThatReplied=0;
+			m_sentMinimizerPlacement=true;
+
+		}else if(m_inbox->hasMessage(RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY)){
+
+			m_numberOfRanksThatReplied++;
+
+			if(m_numberOfRanksThatReplied==m_parameters->getSize()){
+				m_minimizerPlacementBucket=m_nextMinimizerPlacementBucket;
+				m_sentMinimizerPlacement=false;
+			}
+		}
+
+		return;
+	}
+
+	if(placement==NULL){
+		m_timePrinter->printElapsedTime("Sequence loading");
+		cout<<endl;
+	}
 
 	for(int i=0;i<getSize();i++){
 		Message aMessage(NULL,0,i,RAY_MPI_TAG_START_VERTICES_DISTRIBUTION,getRank());
@@ -1552,6 +1623,9 @@ void MachineHelper::resolveSymbols(ComputeCore*core){
 	RAY_MPI_TAG_SET_FILE_ENTRIES=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_FILE_ENTRIES");
 	RAY_MPI_TAG_SET_FILE_ENTRIES_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_FILE_ENTRIES_REPLY");
 
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT");
+	RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY");
+
 	RAY_MPI_TAG_ASK_EXTENSION_DATA=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_ASK_EXTENSION_DATA");
 
 	if (m_parameters->hasOption("-example")) {
@@ -1610,6 +1684,7 @@ void MachineHelper::resolveSymbols(ComputeCore*core){
 
 	m_startedToSendCounts=false;
 	m_authorized=false;
+	m_builtMinimizerPlacement=false;
 }
 
 
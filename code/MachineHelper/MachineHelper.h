@@ -239,6 +239,17 @@ class MachineHelper: public CorePlugin{
 	bool m_startedToSendCounts;
 	MessageTag RAY_MPI_TAG_SET_FILE_ENTRIES;
 	MessageTag RAY_MPI_TAG_SET_FILE_ENTRIES_REPLY;
+
+/*
+ * Stuff for sending the table of -minimizer-placement.
+ */
+
+	bool m_builtMinimizerPlacement;
+	bool m_sentMinimizerPlacement;
+	int m_minimizerPlacementBucket;
+	int m_nextMinimizerPlacementBucket;
+	MessageTag RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT;
+	MessageTag RAY_MPI_TAG_SET_MINIMIZER_PLACEMENT_REPLY;
 	MessageTag RAY_MPI_TAG_SEND_AUTHORIZATION;
 
 	MasterMode RAY_MASTER_MODE_ADD_COLORS;
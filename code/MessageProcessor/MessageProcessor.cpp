@@ -30,6 +30,8 @@
 #include <code/SequencesLoader/Read.h>
 #include <code/SequencesIndexer/ReadAnnotation.h>
 #include <code/SeedExtender/Direction.h>
+#include <code/KmerAcademyBuilder/CanonicalKmer.h>
+#include <code/VerticesExtractor/GraphCheckpoint.h>
 
 #include <RayPlatform/core/ComputeCore.h>
 #include <RayPlatform/core/OperatingSystem.h>
@@ -56,6 +58,7 @@ __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTEX_READS_FROM_LIST);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_START_INDEXING_SEQUENCES);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_SEQUENCES_READY);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DATA);
+__CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_SUPER_KMERS_DATA);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_PURGE_NULL_EDGES);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DISTRIBUTED);
 __CreateMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_OUT_EDGES_DATA_REPLY);
@@ -260,7 +263,7 @@ void MessageProcessor::call_RAY_MPI_TAG_GET_READ_MATE(Message*message){
 }
 
 /*
- * input: list of Kmer+ReadAnnotation*
+ * input: list of Kmer+ReadAnnotationCursor
  * output:
  *        list of ReadAnnotation
  */
@@ -311,11 +314,8 @@ void MessageProcessor::call_RAY_MPI_TAG_REQUEST_VERTEX_READS(Message*message){
 		int bufferPosition=i;
 		vertex.unpack(buffer,&bufferPosition);
 
-		// another fancy trick to receive a pointer.
-		ReadAnnotation*ptr;
-
-		uint64_t integerValue=buffer[bufferPosition++];
-		unpack_pointer((void**)&ptr, integerValue);
+		// the cursor in the ReadAnnotationTable, 0 for the first request
+		ReadAnnotationCursor cursor=buffer[bufferPosition++];
 
 		#ifdef CONFIG_ASSERT
 		// check the padding
@@ -332,7 +332,7 @@ void MessageProcessor::call_RAY_MPI_TAG_REQUEST_VERTEX_READS(Message*message){
 
 		#ifdef GUILLIMIN_BUG
 		if(printBug){
-			cout<<"Pointer: "<<ptr<<" integerValue= "<<integerValue<<endl;
+			cout<<"Cursor: "<<cursor<<endl;
 
 			for(int k=0;k<period;k++){
 				cout<<" "<<k<<" -> "<<buffer[i+k];
@@ -341,46 +341,42 @@ void MessageProcessor::call_RAY_MPI_TAG_REQUEST_VERTEX_READS(Message*message){
 		}
 		#endif
 
-		Kmer complement=m_parameters->_complementVertex(&vertex);
-		bool isLower=vertex<complement;
+		CanonicalKmer canonicalVertex;
+		canonicalVertex.constructor(&vertex,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+		bool isLower=canonicalVertex.isLower();
 
 		/* prime the thing */
-		if(ptr==NULL){
-			ptr=m_subgraph->getReads(&vertex);
+		if(cursor==0){
+			Vertex*node=m_subgraph->find(&canonicalVertex);
+
+			if(node!=NULL)
+				cursor=node->getFirstRead();
 		}
 
-		bool gotOne=false;
+		ReadAnnotation annotation;
 
-		while(ptr!=NULL&&!gotOne){
+		if(m_subgraph->getReadAnnotationTable()->getNextAnnotation(&cursor,isLower,&annotation)){
 
-			int rank=ptr->getRank();
+			int rank=annotation.getRank();
 
 			#ifdef CONFIG_ASSERT
 			assert(rank>=0&&rank<m_parameters->getSize());
 			#endif
 
-			if(ptr->isLower()==isLower){
-				outgoingMessage[i+OFFSET_RANK]=rank;
-				outgoingMessage[i+OFFSET_READ_INDEX]=ptr->getReadIndex();
-				outgoingMessage[i+OFFSET_POSITION_ON_STRAND]=ptr->getPositionOnStrand();
-				outgoingMessage[i+OFFSET_STRAND]=ptr->getStrand();
-
-				gotOne=true;
-			}
-
-			ptr=ptr->getNext();
-		}
-
-		if(!gotOne){
+			outgoingMessage[i+OFFSET_RANK]=rank;
+			outgoingMessage[i+OFFSET_READ_INDEX]=annotation.getReadIndex();
+			outgoingMessage[i+OFFSET_POSITION_ON_STRAND]=annotation.getPositionOnStrand();
+			outgoingMessage[i+OFFSET_STRAND]=annotation.getStrand();
+		}else{
 			outgoingMessage[i+OFFSET_RANK]=INVALID_RANK;
 		}
 
-		// send the void*
-		outgoingMessage[i+OFFSET_POINTER]=pack_pointer((void**)&ptr);
+		// send the cursor, it is 0 when there are no more annotations
+		outgoingMessage[i+OFFSET_POINTER]=cursor;
 
 		#ifdef GUILLIMIN_BUG
 		if(printBug){
-			cout<<"Will send pointer "<<ptr<<" back"<<endl;
+			cout<<"Will send cursor "<<cursor<<" back"<<endl;
 			for(int p=0;p<period;p++){
 				cout<<" "<<p<<" -> "<<outgoingMessage[i+p];
 			}
@@ -420,7 +416,7 @@ void MessageProcessor::call_RAY_MPI_TAG_SET_WORD_SIZE(Message*message){
 }
 
 /*
- * <- k-mer -><- pointer ->
+ * <- k-mer -><- cursor ->
  */
 void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS(Message*message){
 	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
@@ -429,40 +425,33 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS(Message*message){
 	vertex.unpack(incoming,&pos);
 	Kmer complement=m_parameters->_complementVertex(&vertex);
 	bool lower=vertex<complement;
-	ReadAnnotation*e=(ReadAnnotation*)incoming[pos++];
-	ReadAnnotation*origin=e;
+	ReadAnnotationCursor cursor=incoming[pos++];
+	ReadAnnotationTable*table=m_subgraph->getReadAnnotationTable();
 
 	#ifdef CONFIG_ASSERT
-	assert(e!=NULL);
+	assert(cursor!=0);
 	#endif
 
 	int maximumToReturn=MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit)/4-1;
-	int processed=0;
+	int processed=table->countAnnotations(cursor,lower);
 
-	while(e!=NULL&&processed<maximumToReturn){
-		if(e->isLower()==lower){
-			processed++;
-		}
-		e=e->getNext();
-	}
+	if(processed>maximumToReturn)
+		processed=maximumToReturn;
 
 	MessageUnit*outgoingMessage=(MessageUnit*)m_outboxAllocator->allocate((processed+1)*4*sizeof(MessageUnit));
 	int outputPosition=0;
 	outgoingMessage[outputPosition++]=processed;
 	processed=0;
-	e=origin;
-	while(e!=NULL&&processed<maximumToReturn){
-		if(e->isLower()==lower){
-			outgoingMessage[outputPosition++]=e->getRank();
-			outgoingMessage[outputPosition++]=e->getReadIndex();
-			outgoingMessage[outputPosition++]=e->getPositionOnStrand();
-			outgoingMessage[outputPosition++]=e->getStrand();
-			processed++;
-		}
+	ReadAnnotation e;
 
-		e=e->getNext();
+	while(processed<maximumToReturn && table->getNextAnnotation(&cursor,lower,&e)){
+		outgoingMessage[outputPosition++]=e.getRank();
+		outgoingMessage[outputPosition++]=e.getReadIndex();
+		outgoingMessage[outputPosition++]=e.getPositionOnStrand();
+		outgoingMessage[outputPosition++]=e.getStrand();
+		processed++;
 	}
-	outgoingMessage[outputPosition++]=(MessageUnit)e;
+	outgoingMessage[outputPosition++]=cursor;
 	Message aMessage(outgoingMessage,outputPosition,message->getSource(),RAY_MPI_TAG_VERTEX_READS_REPLY,m_rank);
 	m_outbox->push_back(&aMessage);
 }
@@ -472,52 +461,44 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTEX_INFO(Message*message){
 	int bufferPosition=0;
 	Kmer vertex;
 	vertex.unpack(incoming,&bufferPosition);
-	Kmer complement=m_parameters->_complementVertex(&vertex);
-	bool lower=vertex<complement;
-	Vertex*node=m_subgraph->find(&vertex);
+
+	CanonicalKmer canonicalVertex;
+	canonicalVertex.constructor(&vertex,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+	bool lower=canonicalVertex.isLower();
+	Vertex*node=m_subgraph->find(&canonicalVertex);
 
 	#ifdef CONFIG_ASSERT
 	assert(node!=NULL);
 	#endif
 
-	ReadAnnotation*e=m_subgraph->getReads(&vertex);
-	int n=0;
-	while(e!=NULL){
-		if(e->isLower()==lower){
-			n++;
-		}
-		e=e->getNext();
-	}
-	e=m_subgraph->getReads(&vertex);
+	ReadAnnotationTable*table=m_subgraph->getReadAnnotationTable();
+	ReadAnnotationCursor cursor=node->getFirstRead();
+	int n=table->countAnnotations(cursor,lower);
 
 	PathHandle wave=incoming[bufferPosition++];
 
 	Rank origin=getRankFromPathUniqueId(wave);
 
-	m_subgraph->find(&vertex)->assemble(origin);
+	node->assemble(origin);
 
 	MessageUnit*outgoingMessage=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
-	outgoingMessage[0]=node->getCoverage(&vertex);
+	outgoingMessage[0]=m_subgraph->getCoverage(node);
 	outgoingMessage[1]=node->getEdges(&vertex);
 	outgoingMessage[2]=n;
 	int pos=5;
 	int processed=0;
 	int maximumToReturn=(MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit)-5)/4;
-	e=m_subgraph->getReads(&vertex);
-
-	while(e!=NULL&&processed<maximumToReturn){
-		if(e->isLower()==lower){
-			outgoingMessage[pos++]=e->getRank();
-			outgoingMessage[pos++]=e->getReadIndex();
-			outgoingMessage[pos++]=e->getPositionOnStrand();
-			outgoingMessage[pos++]=e->getStrand();
-			processed++;
-		}
+	ReadAnnotation e;
 
-		e=e->getNext();
+	while(processed<maximumToReturn && table->getNextAnnotation(&cursor,lower,&e)){
+		outgoingMessage[pos++]=e.getRank();
+		outgoingMessage[pos++]=e.getReadIndex();
+		outgoingMessage[pos++]=e.getPositionOnStrand();
+		outgoingMessage[pos++]=e.getStrand();
+		processed++;
 	}
 
-	outgoingMessage[3]=(MessageUnit)e;
+	outgoingMessage[3]=cursor;
 	outgoingMessage[4]=processed;
 	Message aMessage(outgoingMessage,pos,message->getSource(),RAY_MPI_TAG_VERTEX_INFO_REPLY,m_rank);
 	m_outbox->push_back(&aMessage);
@@ -539,7 +520,7 @@ void MessageProcessor::call_RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT(Message*message
 			outgoingMessage[i+1]=1;
 		}else{
 			outgoingMessage[i]=node->getEdges(&vertex);
-			outgoingMessage[i+1]=node->getCoverage(&vertex);
+			outgoingMessage[i+1]=m_subgraph->getCoverage(node);
 		}
 	}
 
@@ -548,7 +529,7 @@ void MessageProcessor::call_RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT(Message*message
 }
 
 /*
- * <--vertex--><--pointer--><--numberOfMates--><--mates -->
+ * <--vertex--><--cursor--><--numberOfMates--><--mates -->
  */
 void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS_FROM_LIST(Message*message){
 	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
@@ -559,9 +540,10 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS_FROM_LIST(Message*message){
 	Kmer complement=m_parameters->_complementVertex(&vertex);
 	int numberOfMates=incoming[KMER_U64_ARRAY_SIZE+1];
 	bool lower=vertex<complement;
-	ReadAnnotation*e=(ReadAnnotation*)incoming[KMER_U64_ARRAY_SIZE+0];
+	ReadAnnotationCursor cursor=incoming[KMER_U64_ARRAY_SIZE+0];
+	ReadAnnotationTable*table=m_subgraph->getReadAnnotationTable();
 	#ifdef CONFIG_ASSERT
-	assert(e!=NULL);
+	assert(cursor!=0);
 	#endif
 	MessageUnit*outgoingMessage=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
 	int processed=0;
@@ -571,19 +553,17 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS_FROM_LIST(Message*message){
 		localIndex.insert(incoming[KMER_U64_ARRAY_SIZE+2+i]);
 	}
 
-	while(e!=NULL){
-		if(e->isLower()==lower){
-			PathHandle uniqueId=getPathUniqueId(e->getRank(),e->getReadIndex());
-			if(localIndex.count(uniqueId)>0){
-				outgoingMessage[pos++]=e->getRank();
-				outgoingMessage[pos++]=e->getReadIndex();
-				outgoingMessage[pos++]=e->getPositionOnStrand();
-				outgoingMessage[pos++]=e->getStrand();
-				processed++;
-			}
-		}
+	ReadAnnotation e;
 
-		e=e->getNext();
+	while(table->getNextAnnotation(&cursor,lower,&e)){
+		PathHandle uniqueId=getPathUniqueId(e.getRank(),e.getReadIndex());
+		if(localIndex.count(uniqueId)>0){
+			outgoingMessage[pos++]=e.getRank();
+			outgoingMessage[pos++]=e.getReadIndex();
+			outgoingMessage[pos++]=e.getPositionOnStrand();
+			outgoingMessage[pos++]=e.getStrand();
+			processed++;
+		}
 	}
 	outgoingMessage[0]=processed;
 	Message aMessage(outgoingMessage,1+processed*4,message->getSource(),RAY_MPI_TAG_VERTEX_READS_FROM_LIST_REPLY,m_rank);
@@ -593,7 +573,46 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTEX_READS_FROM_LIST(Message*message){
 void MessageProcessor::call_RAY_MPI_TAG_START_INDEXING_SEQUENCES(Message*message){
 
 	/* read the Graph checkpoint here */
-	if(m_parameters->hasCheckpoint("GenomeGraph")){
+	if(m_parameters->hasCheckpoint("GenomeGraph")
+		&& GraphCheckpoint::hasMagicNumber(m_parameters->getCheckpointFile("GenomeGraph").c_str())){
+
+		cout<<"Rank "<<m_parameters->getRank()<<" is mapping checkpoint GenomeGraph"<<endl;
+
+		GraphCheckpoint checkpoint;
+		checkpoint.constructor();
+
+		if(!checkpoint.open(m_parameters->getCheckpointFile("GenomeGraph").c_str(),m_parameters->getWordSize(),
+			m_parameters->getMinimizerPlacement())){
+			cout<<"Error: Rank "<<m_parameters->getRank()<<" can not read checkpoint GenomeGraph"<<endl;
+			exit(1);
+		}
+
+		LargeCount n=checkpoint.getNumberOfVertices();
+
+		if(!checkpoint.load(m_subgraph,m_parameters->getRank())){
+			cout<<"Error: Rank "<<m_parameters->getRank()<<" can not read checkpoint GenomeGraph"<<endl;
+			exit(1);
+		}
+
+		checkpoint.destructor();
+
+		m_subgraph->completeResizing();
+
+		#ifdef CONFIG_ASSERT
+		assert(m_subgraph->size()==2*n);
+		#endif
+
+		cout<<"Rank "<<m_parameters->getRank()<<" loaded "<<2*n<<" vertices from checkpoint GenomeGraph"<<endl;
+
+/* the legacy format, written by older versions */
+	}else if(m_parameters->hasCheckpoint("GenomeGraph")){
+
+/* the legacy format predates -minimizer-placement */
+		if(m_parameters->useMinimizerPlacement()){
+			cout<<"Error: Rank "<<m_parameters->getRank()<<": checkpoint GenomeGraph was written without -minimizer-placement"<<endl;
+			exit(1);
+		}
+
 		cout<<"Rank "<<m_parameters->getRank()<<" is reading checkpoint GenomeGraph"<<endl;
 		ifstream f(m_parameters->getCheckpointFile("GenomeGraph").c_str());
 		LargeCount n=0;
@@ -612,7 +631,7 @@ void MessageProcessor::call_RAY_MPI_TAG_START_INDEXING_SEQUENCES(Message*message
 			/* we only want to construct it once. */
 			if(m_subgraph->inserted()){
 				tmp->constructor();
-				tmp->setCoverage(&kmer,coverage);
+				m_subgraph->setCoverage(tmp,&kmer,coverage);
 			}
 			int parents=0;
 			f.read((char*)&parents,sizeof(int));
@@ -659,22 +678,16 @@ void MessageProcessor::call_RAY_MPI_TAG_START_INDEXING_SEQUENCES(Message*message
 		/* announce the user that we are writing a checkpoint */
 		cout<<"Rank "<<m_parameters->getRank()<<" is writing checkpoint GenomeGraph"<<endl;
 
-		ofstream f(m_parameters->getCheckpointFile("GenomeGraph").c_str());
-		ostringstream buffer;
+		GraphCheckpoint checkpoint;
+		checkpoint.constructor();
 
-		GridTableIterator iterator;
-		iterator.constructor(m_subgraph,m_parameters->getWordSize(),m_parameters);
-		LargeCount theSize=m_subgraph->size();
+		if(!checkpoint.write(m_parameters->getCheckpointFile("GenomeGraph").c_str(),m_subgraph,
+			m_parameters->getWordSize(),m_parameters->getNumberOfBuckets(),
+			m_parameters->getNumberOfBucketsPerGroup(),m_parameters->getMinimizerPlacement(),
+			GRAPH_CHECKPOINT_VERSION_RECORDS)){
 
-		buffer.write((char*)&theSize, sizeof(LargeCount));
-		while(iterator.hasNext()){
-			Vertex*node=iterator.next();
-			Kmer key=*(iterator.getKey());
-			node->write(&key, &buffer, m_parameters->getWordSize());
-			flushFileOperationBuffer(false, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
+			cout<<"Error: Rank "<<m_parameters->getRank()<<" can not write checkpoint GenomeGraph"<<endl;
 		}
-		flushFileOperationBuffer(true, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
-		f.close();
 	}
 
 }
@@ -694,33 +707,95 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTICES_DATA(Message*message){
 	int count=message->getCount();
 	MessageUnit*incoming=(MessageUnit*)buffer;
 
-	for(int i=0;i<count;i+=KMER_U64_ARRAY_SIZE){
-		Kmer kmerObject;
-		int pos=i;
-		kmerObject.unpack(incoming,&pos);
+	int numberOfKmers=count/KMER_U64_ARRAY_SIZE;
 
-/* make sure that the payload
- * is for this process and not another one...
+	if((int)m_receivedKmers.size()<numberOfKmers)
+		m_receivedKmers.resize(numberOfKmers);
+
+	for(int i=0;i<numberOfKmers;i++){
+		int pos=i*KMER_U64_ARRAY_SIZE;
+		m_receivedKmers[i].unpack(incoming,&pos);
+	}
+
+	addReceivedKmers(numberOfKmers);
+
+	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_VERTICES_DATA_REPLY,m_rank);
+	m_outbox->push_back(&aMessage);
+}
+
+/*
+ * A record is the number of nucleotides of a substring of a read
+ * followed by its nucleotides, 32 per MessageUnit
+ * (see KmerAcademyBuilder::addSuperKmer). All the k-mers of a record
+ * are for this rank, they are rebuilt with the rolling encoder.
  */
-		#ifdef CONFIG_ASSERT
-		Rank rankToFlush=kmerObject.vertexRank(m_parameters->getSize(),m_parameters->getWordSize(),
-			m_parameters->getColorSpaceMode());
+void MessageProcessor::call_RAY_MPI_TAG_SUPER_KMERS_DATA(Message*message){
+	int count=message->getCount();
+	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
 
-		assert(rankToFlush==m_rank);
-		#endif
+	int numberOfKmers=0;
+	int position=0;
+
+	while(position<count){
+		int nucleotides=incoming[position++];
+		MessageUnit*codes=incoming+position;
+
+		int kmers=nucleotides-m_parameters->getWordSize()+1;
+
+		if((int)m_receivedKmers.size()<numberOfKmers+kmers)
+			m_receivedKmers.resize(numberOfKmers+kmers);
 
-		//bool isTheLowerKmer=false;
-		Kmer lowerKmer=kmerObject;
+		m_superKmerEncoder.reset();
+
+		for(int i=0;i<nucleotides;i++){
+			m_superKmerEncoder.push((codes[i/32]>>(2*(i%32)))&3);
+
+			if(m_superKmerEncoder.isReady())
+				m_superKmerEncoder.getLowerKey(&(m_receivedKmers[numberOfKmers++]));
+		}
+
+		position+=(nucleotides+31)/32;
+	}
+
+	#ifdef CONFIG_ASSERT
+	assert(position==count);
+	#endif
+
+	addReceivedKmers(numberOfKmers);
+
+/* the sender counts its pending messages with the same reply */
+	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_VERTICES_DATA_REPLY,m_rank);
+	m_outbox->push_back(&aMessage);
+}
+
+void MessageProcessor::addReceivedKmers(int numberOfKmers){
+
+	if((int)m_verticesBatch.size()<numberOfKmers)
+		m_verticesBatch.resize(numberOfKmers);
 
 /*
- * TODO: remove call to reverseComplement, this if should never be
- * picked up because only the lowest k-mers are sent
- * I am not sure it would work but if it does that would reduces
- * the number of sent messages
+ * The message is processed in 2 passes.
+ *
+ * The first pass unpacks and canonicalizes all the k-mers and
+ * asks the processor to fetch their filter words. The filters are
+ * far larger than the caches, so each k-mer is a cache miss.
+ * With all the loads issued first, the misses overlap instead of
+ * being paid one after the other.
  *
- * *** Anyway, the message was delivered anyway already.
+ * The second pass does the updates in the order of the message,
+ * so the result is the same as processing the k-mers one by one.
  */
-		Kmer reverseComplement=kmerObject.complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+	for(int i=0;i<numberOfKmers;i++){
+		Kmer kmerObject=m_receivedKmers[i];
+
+/* make sure that the payload
+ * is for this process and not another one...
+ */
+		#ifdef CONFIG_ASSERT
+		Rank rankToFlush=m_parameters->vertexRank(&kmerObject);
+
+		assert(rankToFlush==m_rank);
+		#endif
 
 /*
  * This assert can only fail if the user modified
@@ -728,23 +803,54 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTICES_DATA(Message*message){
  * values
  */
 		#ifdef CONFIG_ASSERT
-		assert(reverseComplement!=kmerObject);
+		assert(m_parameters->_complementVertex(&kmerObject)!=kmerObject);
+		#endif
+
+/*
+ * KmerAcademyBuilder and RAY_MPI_TAG_SUPER_KMERS_DATA give the lower
+ * k-mers, so no reverse complement is computed here, and
+ * GridTable::insert does not compute it either.
+ */
+		#ifdef CONFIG_ASSERT
+		assert(kmerObject<m_parameters->_complementVertex(&kmerObject));
 		#endif
 
-		if(reverseComplement < lowerKmer)
-			lowerKmer=reverseComplement;
+		CanonicalKmer*canonicalKmer=&(m_verticesBatch[i]);
+		canonicalKmer->constructorWithLowerKey(&kmerObject);
+
+		if(m_countingFilterThreshold>0)
+			m_countingFilter.prefetch(canonicalKmer->getLowerKey());
+		else if(m_bloomBits>0)
+			m_bloomFilter.prefetch(canonicalKmer->getLowerKey());
+	}
+
+	for(int i=0;i<numberOfKmers;i++){
+		Kmer kmerObject=m_receivedKmers[i];
+
+		CanonicalKmer*canonicalKmer=&(m_verticesBatch[i]);
+		Kmer*lowerKmer=canonicalKmer->getLowerKey();
+
 /*
  * If the Bloom filter has exactly 0 bits,
  * this means that it is disabled.
  * The Bloom filter only contain the lower k-mers.
  */
-		if(m_bloomBits>0 && !m_bloomFilter.hasValue(&lowerKmer)){
+		if(m_countingFilterThreshold>0){
+
+/*
+ * With the counting filter, a k-mer stays out of the graph
+ * until it was seen m_countingFilterThreshold times.
+ */
+			if(m_countingFilter.increment(lowerKmer,m_countingFilterThreshold-1))
+				continue;
+
+		}else if(m_bloomBits>0 && !m_bloomFilter.hasValue(lowerKmer)){
 /*
 			cout<<"inserting in Bloom filter: "<<endl;
 			kmerObject.print();
 */
 
-			m_bloomFilter.insertValue(&lowerKmer);
+			m_bloomFilter.insertValue(lowerKmer);
 
 			continue;
 		}
@@ -764,7 +870,7 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTICES_DATA(Message*message){
  * We have a go. We insert the k-mer in the distributed
  * de Bruijn graph.
  */
-		Vertex*tmp=m_subgraph->insert(&kmerObject);
+		Vertex*tmp=m_subgraph->insert(canonicalKmer);
 
 		#ifdef CONFIG_ASSERT
 		assert(tmp!=NULL);
@@ -774,6 +880,7 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTICES_DATA(Message*message){
  * Initialize the k-mer coverage
  * It starts at 0 if the Bloom filter
  * is disabled, 1 otherwise.
+ * With the counting filter, it starts at the threshold minus 1.
  */
 		if(m_subgraph->inserted()){
 			tmp->constructor();
@@ -784,28 +891,28 @@ void MessageProcessor::call_RAY_MPI_TAG_VERTICES_DATA(Message*message){
  * If the k-mers must go in the Bloom filter first,
  * their coverage must start at 1 instead of 0.
  */
-			if(m_bloomBits>0)
+			if(m_countingFilterThreshold>0)
+				startingValue=m_countingFilterThreshold-1;
+			else if(m_bloomBits>0)
 				startingValue++;
 
-			tmp->setCoverage(&kmerObject,startingValue);
+			m_subgraph->setCoverage(tmp,&kmerObject,startingValue);
 		}
 
 /*
  * We only increase the k-mer coverage of the pair
  * when we see the lower k-mer of the pair. Otherwise,
  * the coverage will be double what it should be.
- * This logic is implemented in the class Vertex.
+ * This logic is implemented in GridTable::setCoverage,
+ * which also keeps the values that do not fit in the vertex.
  */
-		CoverageDepth oldCoverage=tmp->getCoverage(&kmerObject);
+		CoverageDepth oldCoverage=m_subgraph->getCoverage(tmp);
 		CoverageDepth newCoverage=oldCoverage+1;
 
 		// avoid integer overflow on data type CoverageDepth
 		if(newCoverage > oldCoverage)
-			tmp->setCoverage(&kmerObject,newCoverage);
+			m_subgraph->setCoverage(tmp,&kmerObject,newCoverage);
 	}
-
-	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_VERTICES_DATA_REPLY,m_rank);
-	m_outbox->push_back(&aMessage);
 }
 
 void MessageProcessor::call_RAY_MPI_TAG_PURGE_NULL_EDGES(Message*message){
@@ -892,8 +999,75 @@ void MessageProcessor::call_RAY_MPI_TAG_START_VERTICES_DISTRIBUTION(Message*mess
 	if(m_parameters->hasConfigurationOption("-bloom-filter-bits",1))
 		m_bloomBits=m_parameters->getConfigurationInteger("-bloom-filter-bits",0);
 
+	m_countingFilterThreshold=0;
+
+/*
+ * The counting filter replaces the Bloom filter.
+ * A threshold of 2 gives the same graph as the Bloom filter,
+ * a threshold of 1 keeps every k-mer (no filter at all).
+ */
+	if(m_parameters->hasConfigurationOption("-counting-filter-threshold",1)){
+		m_countingFilterThreshold=m_parameters->getConfigurationInteger("-counting-filter-threshold",0);
+
+		if(m_countingFilterThreshold<1){
+			cout<<"Error: -counting-filter-threshold is "<<m_countingFilterThreshold;
+			cout<<", it must be between 1 and "<<COUNTING_FILTER_MAXIMUM_COUNT+1<<endl;
+			exit(1);
+		}
+
+		if(m_countingFilterThreshold>COUNTING_FILTER_MAXIMUM_COUNT+1)
+			m_countingFilterThreshold=COUNTING_FILTER_MAXIMUM_COUNT+1;
+
+		if(m_countingFilterThreshold==1){
+			cout<<"Rank "<<m_rank<<" keeps every k-mer (counting filter threshold: 1)"<<endl;
+			m_bloomBits=0;
+		}
+	}
+
+	if(m_countingFilterThreshold>1){
+
+/*
+ * One byte per counter, this is twice the memory of the Bloom filter.
+ * With -bloom-filter-bits 0, the default size of the Bloom filter is used.
+ */
+		uint64_t bloomBits=m_bloomBits;
+
+		if(bloomBits==0)
+			bloomBits=m_verticesExtractor->getDefaultNumberOfBitsForBloomFilter();
+
+		uint64_t counters=bloomBits/4;
+
+/* a smaller filter is one block where all the k-mers collide */
+		if(m_parameters->hasConfigurationOption("-counting-filter-counters",1)){
+			uint64_t value=m_parameters->getConfigurationInteger("-counting-filter-counters",0);
+
+			if(value<COUNTING_FILTER_BLOCK_BYTES){
+				cout<<"Error: -counting-filter-counters is "<<value;
+				cout<<", it must be at least "<<COUNTING_FILTER_BLOCK_BYTES<<endl;
+				exit(1);
+			}
+
+			counters=value;
+		}
+
+		if(counters<COUNTING_FILTER_BLOCK_BYTES)
+			counters=COUNTING_FILTER_BLOCK_BYTES;
+
+		m_countingFilter.constructor(counters);
+		cout<<"Rank "<<m_rank<<" created its counting filter (threshold: "<<m_countingFilterThreshold<<")"<<endl;
+
+		m_bloomBits=0;
+
+	}else{
+		m_countingFilterThreshold=0;
+	}
+
+	m_superKmerEncoder.constructor(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+
 	if(m_bloomBits>0){
-		m_bloomFilter.constructor(m_bloomBits);
+		bool blocked=m_parameters->hasOption("-bloom-filter-blocked");
+
+		m_bloomFilter.constructor(m_bloomBits,blocked);
 		cout<<"Rank "<<m_rank<<" created its Bloom filter"<<endl;
 	}
 }
@@ -1012,6 +1186,30 @@ void MessageProcessor::call_RAY_MPI_TAG_PREPARE_COVERAGE_DISTRIBUTION(Message*me
 
 	}
 
+	if(m_countingFilterThreshold>0){
+		uint64_t usedCounters=m_countingFilter.getNumberOfUsedCounters();
+		uint64_t counters=m_countingFilter.getNumberOfCounters();
+
+		double ratio=100.0*usedCounters/counters;
+
+		cout<<"Rank "<<m_rank<<" number of used counters in the counting filter: ";
+		cout<<"[ "<<usedCounters<<" / "<<counters<<" ] ("<<ratio<<"%)";
+
+		if(ratio >= 50.0)
+			cout<<" Warning: the counting filter is half full."<<endl;
+
+		cout<<endl;
+
+		cout<<"Rank "<<m_rank<<" number of k-mer occurrences absorbed by the counting filter: ";
+		cout<<m_countingFilter.getNumberOfIncrements()<<endl;
+
+		kmersInBloomFilter=m_countingFilter.getNumberOfInsertions();
+		kmersInBloomFilter*=2; // pairs of k-mers
+
+		m_countingFilter.destructor();
+		cout<<"Rank "<<m_rank<<" destroyed its counting filter"<<endl;
+	}
+
 	// complete incremental resizing, if any
 	m_subgraph->completeResizing();
 
@@ -1187,6 +1385,10 @@ void MessageProcessor::call_RAY_MPI_TAG_START_SEEDING(Message*message){
 		cout<<"Rank "<<m_parameters->getRank()<<": memory usage for  optimal read markers= "<<allocatedBytes/1024<<" KiB"<<endl;
 	}
 
+	/* the annotations do not change anymore */
+	m_subgraph->freezeReadAnnotations();
+	m_si->getAllocator()->clear();
+
 	#ifdef CONFIG_ASSERT
 	assert(m_subgraph!=NULL);
 	#endif
@@ -1199,23 +1401,25 @@ void MessageProcessor::call_RAY_MPI_TAG_GET_COVERAGE_AND_MARK(Message*message){
 	Kmer vertex;
 	int bufferPosition=0;
 	vertex.unpack(incoming,&bufferPosition);
-	Vertex*node=m_subgraph->find(&vertex);
+
+	CanonicalKmer canonicalVertex;
+	canonicalVertex.constructor(&vertex,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+	Vertex*node=m_subgraph->find(&canonicalVertex);
 
 	#ifdef CONFIG_ASSERT
 	assert(node!=NULL);
 	#endif
 
-	CoverageDepth coverage=node->getCoverage(&vertex);
+	CoverageDepth coverage=m_subgraph->getCoverage(node);
 	message2[0]=coverage;
 	message2[1]=node->getEdges(&vertex);
-	Kmer rc=m_parameters->_complementVertex(&vertex);
-	bool lower=vertex<rc;
+	bool lower=canonicalVertex.isLower();
 	PathHandle wave=incoming[1];
 	int progression=incoming[2];
 	// mark direction in the graph
 	Direction*e=(Direction*)m_directionsAllocator->allocate(sizeof(Direction));
 	e->constructor(wave,progression,lower);
-	m_subgraph->addDirection(&vertex,e);
+	node->addDirection(&vertex,e);
 
 	Message aMessage(message2,2,message->getSource(),RAY_MPI_TAG_GET_COVERAGE_AND_MARK_REPLY,m_rank);
 	m_outbox->push_back(&aMessage);
@@ -1241,7 +1445,7 @@ void MessageProcessor::call_RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE(Message*message)
 		CoverageDepth coverage=0;
 
 		if(node!=NULL){
-			coverage=node->getCoverage(&vertex);
+			coverage=m_subgraph->getCoverage(node);
 
 			#ifdef CONFIG_ASSERT
 			assert(coverage!=0);
@@ -1526,19 +1730,20 @@ void MessageProcessor::call_RAY_MPI_TAG_ATTACH_SEQUENCE(Message*message){
 		for(int j=0;j<vertex.getNumberOfU64();j++){
 			vertex.setU64(j,incoming[i+j]);
 		}
-		Kmer complement=m_parameters->_complementVertex(&vertex);
-		bool lower=vertex.isLower(&complement);
+		CanonicalKmer canonicalVertex;
+		canonicalVertex.constructor(&vertex,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+		bool lower=canonicalVertex.isLower();
 		int rank=incoming[i+vertex.getNumberOfU64()];
 		int sequenceIdOnDestination=(int)incoming[i+vertex.getNumberOfU64()+1];
 		int positionOnStrand=incoming[i+vertex.getNumberOfU64()+2];
 		char strand=(char)incoming[i+vertex.getNumberOfU64()+3];
-		Vertex*node=m_subgraph->find(&vertex);
+		Vertex*node=m_subgraph->find(&canonicalVertex);
 
 		if(node==NULL){
 			continue;
 		}
 
-		int coverage=node->getCoverage(&vertex);
+		int coverage=m_subgraph->getCoverage(node);
 
 		if(coverage==1){
 			continue;
@@ -1551,7 +1756,7 @@ void MessageProcessor::call_RAY_MPI_TAG_ATTACH_SEQUENCE(Message*message){
 		#endif
 		e->constructor(rank,sequenceIdOnDestination,positionOnStrand,strand,lower);
 
-		m_subgraph->addRead(&vertex,e);
+		node->addRead(&vertex,e);
 	}
 	MessageUnit*message2=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
 	Message aMessage(message2,count,message->getSource(),RAY_MPI_TAG_ATTACH_SEQUENCE_REPLY,m_rank);
@@ -1651,11 +1856,14 @@ void MessageProcessor::call_RAY_MPI_TAG_SAVE_WAVE_PROGRESSION(Message*message){
 		Kmer vertex;
 		int pos=i;
 		vertex.unpack(incoming,&pos);
-		Kmer rc=m_parameters->_complementVertex(&vertex);
-		bool lower=vertex<rc;
+
+		CanonicalKmer canonicalVertex;
+		canonicalVertex.constructor(&vertex,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+		bool lower=canonicalVertex.isLower();
+
+		Vertex*node=m_subgraph->find(&canonicalVertex);
 
 		#ifdef CONFIG_ASSERT
-		Vertex*node=m_subgraph->find(&vertex);
 		if(node==NULL){
 			cout<<"Error: vertex does not exist: "<<vertex.idToWord(m_parameters->getWordSize(),
 				m_parameters->getColorSpaceMode())<<endl;
@@ -1663,8 +1871,7 @@ void MessageProcessor::call_RAY_MPI_TAG_SAVE_WAVE_PROGRESSION(Message*message){
 
 		assert(node!=NULL);
 
-		Vertex copy=*node;
-		assert(copy.getCoverage(&vertex)>=1);
+		assert(m_subgraph->getCoverage(node)>=1);
 		#endif
 
 		PathHandle wave=incoming[pos++];
@@ -1680,9 +1887,11 @@ void MessageProcessor::call_RAY_MPI_TAG_SAVE_WAVE_PROGRESSION(Message*message){
 		Direction*e=(Direction*)m_directionsAllocator->allocate(sizeof(Direction));
 		e->constructor(wave,progression,lower);
 
-		m_subgraph->addDirection(&vertex,e);
+		node->addDirection(&vertex,e);
 
 #ifdef DEBUG_ISSUE_136
+		Kmer rc=m_parameters->_complementVertex(&vertex);
+
 		if(
 			vertex.idToWord(m_parameters->getWordSize(), m_parameters->getColorSpaceMode()) == "GCTGAATGGCGTTACCGGCCTGGTTGAGTATCACGAGCATTTCAATCGCTTTTAATCTCCGGGGTTTGCAGACTGCTTAACAGCTCTGCAA"
 		||	vertex.idToWord(m_parameters->getWordSize(), m_parameters->getColorSpaceMode()) == "TTGCAGAGCTGTTAAGCAGTCTGCAAACCCCGGAGATTAAAAGCGATTGAAATGCTCGTGATACTCAACCAGGCCGGTAACGCCATTCAGC"
@@ -1753,7 +1962,7 @@ void MessageProcessor::call_RAY_MPI_TAG_ASK_VERTEX_PATHS_SIZE(Message*message){
 		}
 		assert(node!=NULL);
 
-		int coverage=node->getCoverage(&vertex);
+		int coverage=m_subgraph->getCoverage(node);
 		assert(coverage >= 1);
 		#endif
 
@@ -1821,7 +2030,7 @@ void MessageProcessor::call_RAY_MPI_TAG_GET_COVERAGE_AND_DIRECTION(Message*messa
 		uint8_t edges=0;
 		if(node!=NULL){
 			paths=m_subgraph->getDirections(&vertex);
-			coverage=node->getCoverage(&vertex);
+			coverage=m_subgraph->getCoverage(node);
 			edges=node->getEdges(&vertex);
 		}
 		message2[i+0]=coverage;
@@ -2578,6 +2787,7 @@ SequencesIndexer*m_si){
 	this->m_ready=m_ready;
 	m_seedingData=seedingData;
 	m_kmerAcademyFinishedRanks=0;
+	m_countingFilterThreshold=0;
 }
 
 MessageProcessor::MessageProcessor(){
@@ -2661,6 +2871,10 @@ void MessageProcessor::registerPlugin(ComputeCore*core){
 	RAY_MPI_TAG_VERTICES_DATA_REPLY=core->allocateMessageTagHandle(plugin);
 	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_VERTICES_DATA_REPLY,"RAY_MPI_TAG_VERTICES_DATA_REPLY");
 
+	RAY_MPI_TAG_SUPER_KMERS_DATA=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagObjectHandler(plugin,RAY_MPI_TAG_SUPER_KMERS_DATA, __GetAdapter(MessageProcessor,RAY_MPI_TAG_SUPER_KMERS_DATA));
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SUPER_KMERS_DATA,"RAY_MPI_TAG_SUPER_KMERS_DATA");
+
 	RAY_MPI_TAG_PURGE_NULL_EDGES=core->allocateMessageTagHandle(plugin);
 	core->setMessageTagObjectHandler(plugin,RAY_MPI_TAG_PURGE_NULL_EDGES, __GetAdapter(MessageProcessor,RAY_MPI_TAG_PURGE_NULL_EDGES));
 	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_PURGE_NULL_EDGES,"RAY_MPI_TAG_PURGE_NULL_EDGES");
@@ -3096,6 +3310,7 @@ void MessageProcessor::resolveSymbols(ComputeCore*core){
 	RAY_MPI_TAG_VERTEX_READS_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTEX_READS_REPLY");
 	RAY_MPI_TAG_VERTICES_DATA=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTICES_DATA");
 	RAY_MPI_TAG_VERTICES_DATA_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTICES_DATA_REPLY");
+	RAY_MPI_TAG_SUPER_KMERS_DATA=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SUPER_KMERS_DATA");
 	RAY_MPI_TAG_VERTICES_DISTRIBUTED=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_VERTICES_DISTRIBUTED");
 	RAY_MPI_TAG_WRITE_AMOS=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_WRITE_AMOS");
 	RAY_MPI_TAG_WRITE_AMOS_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_WRITE_AMOS_REPLY");
@@ -3240,6 +3455,7 @@ void MessageProcessor::resolveSymbols(ComputeCore*core){
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_START_INDEXING_SEQUENCES);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_SEQUENCES_READY);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DATA);
+	__BindAdapter(MessageProcessor,RAY_MPI_TAG_SUPER_KMERS_DATA);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_PURGE_NULL_EDGES);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DISTRIBUTED);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_OUT_EDGES_DATA_REPLY);
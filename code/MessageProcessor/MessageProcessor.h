@@ -29,6 +29,9 @@
 #include <code/SequencesIndexer/ReadAnnotation.h>
 #include <code/SequencesIndexer/SequencesIndexer.h>
 #include <code/KmerAcademyBuilder/BloomFilter.h>
+#include <code/KmerAcademyBuilder/CountingFilter.h>
+#include <code/KmerAcademyBuilder/CanonicalKmer.h>
+#include <code/KmerAcademyBuilder/RollingKmer.h>
 #include <code/Library/Library.h>
 #include <code/SeedingData/SeedingData.h>
 #include <code/FusionData/FusionData.h>
@@ -68,6 +71,7 @@ __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTEX_READS_FROM_LIST);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_START_INDEXING_SEQUENCES);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_SEQUENCES_READY);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DATA);
+__DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_SUPER_KMERS_DATA);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_PURGE_NULL_EDGES);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DISTRIBUTED);
 __DeclareMessageTagAdapter(MessageProcessor,RAY_MPI_TAG_OUT_EDGES_DATA_REPLY);
@@ -182,6 +186,7 @@ class MessageProcessor :  public CorePlugin {
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_START_INDEXING_SEQUENCES);
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_SEQUENCES_READY);
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DATA);
+	__AddAdapter(MessageProcessor,RAY_MPI_TAG_SUPER_KMERS_DATA);
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_PURGE_NULL_EDGES);
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_VERTICES_DISTRIBUTED);
 	__AddAdapter(MessageProcessor,RAY_MPI_TAG_OUT_EDGES_DATA_REPLY);
@@ -275,6 +280,9 @@ class MessageProcessor :  public CorePlugin {
 
 	uint64_t m_bloomBits;
 
+	/** 0 if the counting filter is disabled */
+	int m_countingFilterThreshold;
+
 	MessageTag RAY_MPI_TAG_PREPARE_COVERAGE_DISTRIBUTION;
 	MessageTag RAY_MPI_TAG_PREPARE_COVERAGE_DISTRIBUTION_ANSWER;
 	MessageTag RAY_MPI_TAG_PREPARE_COVERAGE_DISTRIBUTION_QUESTION;
@@ -321,6 +329,7 @@ class MessageProcessor :  public CorePlugin {
 	MessageTag RAY_MPI_TAG_VERTEX_READS_REPLY;
 	MessageTag RAY_MPI_TAG_VERTICES_DATA;
 	MessageTag RAY_MPI_TAG_VERTICES_DATA_REPLY;
+	MessageTag RAY_MPI_TAG_SUPER_KMERS_DATA;
 	MessageTag RAY_MPI_TAG_VERTICES_DISTRIBUTED;
 	MessageTag RAY_MPI_TAG_WRITE_AMOS;
 	MessageTag RAY_MPI_TAG_WRITE_AMOS_REPLY;
@@ -438,6 +447,18 @@ class MessageProcessor :  public CorePlugin {
 
 	int m_kmerAcademyFinishedRanks;
 	BloomFilter m_bloomFilter;
+	CountingFilter m_countingFilter;
+
+	/** the k-mers of a RAY_MPI_TAG_VERTICES_DATA message */
+	vector<CanonicalKmer> m_verticesBatch;
+
+	/** the k-mers received, before they are canonicalized */
+	vector<Kmer> m_receivedKmers;
+
+	/** rebuild the k-mers of a RAY_MPI_TAG_SUPER_KMERS_DATA message */
+	RollingKmer m_superKmerEncoder;
+
+	void addReceivedKmers(int numberOfKmers);
 
 	VirtualCommunicator*m_virtualCommunicator;
 	Scaffolder*m_scaffolder;
@@ -588,6 +609,7 @@ SequencesIndexer*m_si
 	void call_RAY_MPI_TAG_START_INDEXING_SEQUENCES(Message*message);
 	void call_RAY_MPI_TAG_SEQUENCES_READY(Message*message);
 	void call_RAY_MPI_TAG_VERTICES_DATA(Message*message);
+	void call_RAY_MPI_TAG_SUPER_KMERS_DATA(Message*message);
 	void call_RAY_MPI_TAG_PURGE_NULL_EDGES(Message*message);
 	void call_RAY_MPI_TAG_VERTICES_DISTRIBUTED(Message*message);
 	void call_RAY_MPI_TAG_OUT_EDGES_DATA_REPLY(Message*message);
@@ -31,11 +31,13 @@
 #include <code/SequencesLoader/Loader.h>
 #include <code/SequencesLoader/ReadHandle.h>
 #include <code/SequencesLoader/SequenceFileDetector.h>
+#include <code/SequencesLoader/SequenceFileManifest.h>
 
 #include <RayPlatform/memory/MyAllocator.h>
 #include <RayPlatform/core/OperatingSystem.h>
 #include <RayPlatform/core/types.h> /* for CONFIG_MINI_RANKS */
 
+#include <algorithm>
 #include <string>
 #include <sstream>
 #include <iostream>
@@ -1062,6 +1064,8 @@ void Parameters::constructor(int argc,char**argv,int rank,int size,
 
 	m_maximumDistance=0;
 	m_totalNumberOfSequences=0;
+	m_useMinimizerPlacement=false;
+	m_constructedMinimizerPlacement=false;
 
 	m_rank=rank;
 	m_size=size;
@@ -1399,9 +1403,25 @@ void Parameters::setNumberOfSequences(int file,LargeCount n){
 	if(m_numberOfSequencesInFile.count(file)==0){
 		m_numberOfSequencesInFile[file]=n;
 		m_totalNumberOfSequences+=n;
+		m_sequencePartition.clear();
 	}
 }
 
+LargeCount Parameters::getNumberOfKmerPositions(int file){
+	if(m_numberOfKmerPositionsInFile.count(file)==0)
+		return UNKNOWN_NUMBER_OF_KMER_POSITIONS;
+
+	return m_numberOfKmerPositionsInFile[file];
+}
+
+void Parameters::setNumberOfKmerPositions(int file,LargeCount positions){
+	if(positions==UNKNOWN_NUMBER_OF_KMER_POSITIONS)
+		return;
+
+	m_numberOfKmerPositionsInFile[file]=positions;
+	m_sequencePartition.clear();
+}
+
 int Parameters::getNumberOfLibraries(){
 	return m_numberOfLibraries;
 }
@@ -1671,6 +1691,24 @@ void Parameters::showUsage(){
 	showOptionDescription("Any path with a coverage depth lower than this will be discarded. The default is 0.");
 	cout<<endl;
 
+	showOption("-partition-read-weight weight","Adds weight k-mers to the cost of each sequence in the sequence partition.");
+	showOptionDescription("The ranks get sequences with the same total cost. The default is 0.");
+	cout<<endl;
+
+	showOption("-partition-by-reads","Gives the same number of sequences to each rank, regardless of their lengths.");
+	cout<<endl;
+
+	showOption("-minimizer-placement","Places the k-mers on the ranks with their minimizers instead of a hash value.");
+	showOptionDescription("Adjacent k-mers of a read are usually on the same rank. Heavy minimizers are balanced");
+	showOptionDescription("with a sample of the k-mers. The same option must be used to read the checkpoints.");
+	cout<<endl;
+
+	ostringstream minimizerText;
+	minimizerText<<"The default is "<<MINIMIZER_PLACEMENT_DEFAULT_LENGTH<<", the maximum is 31.";
+	showOption("-minimizer-length minimizerLength","Sets the length of the minimizers for -minimizer-placement.");
+	showOptionDescription(minimizerText.str());
+	cout<<endl;
+
 
 	cout<<"  Distributed storage engine (all these values are for each MPI rank)"<<endl;
 	cout<<endl;
@@ -1681,6 +1719,20 @@ void Parameters::showUsage(){
 	showOptionDescription(text.str());
 	cout<<endl;
 
+	showOption("-bloom-filter-blocked","Puts all the bits of a k-mer in the same cache line of the Bloom filter");
+	showOptionDescription("This is 1 memory access per k-mer instead of 8, with a slightly higher false positive rate.");
+	cout<<endl;
+
+	showOption("-counting-filter-threshold threshold","Uses a counting filter instead of the Bloom filter");
+	showOptionDescription("A k-mer goes in the graph when it was seen threshold times. The threshold is between 1 and 256,");
+	showOptionDescription("1 keeps every k-mer (no filter), 2 is like the Bloom filter, a larger value is clamped to 256.");
+	cout<<endl;
+
+	showOption("-counting-filter-counters counters","Sets the number of 8-bit counters for the counting filter");
+	showOptionDescription("Default is the number of bits of the Bloom filter divided by 4 (its default size with -bloom-filter-bits 0),");
+	showOptionDescription("the minimum is 64.");
+	cout<<endl;
+
 	text.str("");
 	text<<"Default value: "<<__DEFAULT_BUCKETS;
 	showOption("-hash-table-buckets buckets","Sets the initial number of buckets. Must be a power of 2 !");
@@ -1704,6 +1756,11 @@ void Parameters::showUsage(){
 	showOption("-hash-table-verbosity","Activates verbosity for the distributed storage engine");
 	cout<<endl;
 
+	showOption("-vertex-cache-entries entries","Sets the number of entries in the cache for the vertices of other ranks");
+	showOptionDescription("The coverage depths and the edges are cached for the seeding and the extension.");
+	showOptionDescription("Default value: 131072, 0 disables the cache.");
+	cout<<endl;
+
 	cout<<"  Biological abundances"<<endl;
 	cout<<endl;
 	showOption("-search searchDirectory","Provides a directory containing fasta files to be searched in the de Bruijn graph.");
@@ -1950,6 +2007,9 @@ void Parameters::showUsage(){
 	cout<<"     	k-mer graph, required option: -write-kmers"<<endl;
 	cout<<"         The resulting file is not utilised by Ray."<<endl;
 	cout<<"         The resulting file is very large."<<endl;
+	cout<<"     RayOutput/Rank<number>.kmers.raygraph"<<endl;
+	cout<<"     	The same k-mer graph in a compact binary format, required option: -write-kmers"<<endl;
+	cout<<"         Sorted k-mers with varint differences, like the checkpoint GenomeGraph."<<endl;
 	cout<<endl;
 
 	cout<<"  Assembly steps"<<endl;
@@ -1979,7 +2039,9 @@ void Parameters::showUsage(){
 	cout<<"     RayOutput/NumberOfSequences.txt"<<endl;
 	cout<<"         Number of reads in each file"<<endl;
 	cout<<"     RayOutput/SequencePartition.txt"<<endl;
-	cout<<"     	Sequence partition"<<endl;
+	cout<<"     	Sequence partition, the ranks have the same number of k-mers"<<endl;
+	cout<<"     <input file>.raymanifest (or <checkpoint directory>/File<number>.raymanifest)"<<endl;
+	cout<<"         Number of sequences, byte offsets and lengths, the next runs do not count them again"<<endl;
 	cout<<endl;
 
 	cout<<"  Ray software"<<endl;
@@ -2052,11 +2114,140 @@ int Parameters::getReducerValue(){
 	return m_reducerPeriod;
 }
 
+/*
+ * The sequences are split in contiguous ranges of global identifiers,
+ * one per rank. With -partition-by-reads, or when no loader recorded
+ * the lengths, every rank has the same number of sequences (the last
+ * one has the rest).
+ *
+ * Otherwise the ranges have the same cost: a sequence costs
+ * its number of k-mers plus the -partition-read-weight. The k-mers
+ * of a file are spread evenly over its sequences and a file whose
+ * lengths are not known gets the average of the others.
+ * 100-bp reads and 10-kb reads therefore do not give 100 times more work
+ * to the ranks with the long ones.
+ *
+ * Every rank computes the same partition from the same counts, nothing
+ * is sent.
+ */
+void Parameters::computeSequencePartition(){
+
+	m_sequencePartition.clear();
+
+	LargeCount knownSequences=0;
+	LargeCount knownPositions=0;
+
+	for(int file=0;file<getNumberOfFiles();file++){
+		LargeCount positions=getNumberOfKmerPositions(file);
+
+		if(positions==UNKNOWN_NUMBER_OF_KMER_POSITIONS)
+			continue;
+
+		knownSequences+=getNumberOfSequences(file);
+		knownPositions+=positions;
+	}
+
+	double readWeight=0;
+
+	if(hasConfigurationOption("-partition-read-weight",1))
+		readWeight=getConfigurationInteger("-partition-read-weight",0);
+
+	vector<double> sequenceCosts;
+	double totalCost=0;
+
+	if(knownSequences>0 && !hasOption("-partition-by-reads")){
+		double averagePositions=knownPositions/(double)knownSequences;
+
+		for(int file=0;file<getNumberOfFiles();file++){
+			LargeCount sequences=getNumberOfSequences(file);
+			LargeCount positions=getNumberOfKmerPositions(file);
+			double cost=averagePositions;
+
+			if(positions!=UNKNOWN_NUMBER_OF_KMER_POSITIONS && sequences>0)
+				cost=positions/(double)sequences;
+
+			cost+=readWeight;
+
+			sequenceCosts.push_back(cost);
+			totalCost+=cost*sequences;
+		}
+	}
+
+	if(totalCost==0){
+		LargeCount perRank=m_totalNumberOfSequences/m_size;
+
+		for(Rank rank=0;rank<m_size;rank++)
+			m_sequencePartition.push_back(rank*perRank);
+
+		m_sequencePartition.push_back(m_totalNumberOfSequences);
+		return;
+	}
+
+	int file=0;
+	LargeIndex sequencesBefore=0;
+	double costBefore=0;
+
+	m_sequencePartition.push_back(0);
+
+	for(Rank rank=1;rank<m_size;rank++){
+		double target=totalCost*rank/m_size;
+
+/* skip the files that end before the target */
+		while(file<getNumberOfFiles()
+			&& costBefore+sequenceCosts[file]*getNumberOfSequences(file)<=target){
+
+			costBefore+=sequenceCosts[file]*getNumberOfSequences(file);
+			sequencesBefore+=getNumberOfSequences(file);
+			file++;
+		}
+
+		LargeIndex first=sequencesBefore;
+
+		if(file<getNumberOfFiles() && sequenceCosts[file]>0){
+			LargeCount inFile=(LargeCount)((target-costBefore)/sequenceCosts[file]+0.5);
+
+			if(inFile>getNumberOfSequences(file))
+				inFile=getNumberOfSequences(file);
+
+			first+=inFile;
+		}
+
+		if(first<m_sequencePartition.back())
+			first=m_sequencePartition.back();
+
+		if(first>m_totalNumberOfSequences)
+			first=m_totalNumberOfSequences;
+
+		m_sequencePartition.push_back(first);
+	}
+
+	m_sequencePartition.push_back(m_totalNumberOfSequences);
+}
+
+/*
+ * The first sequence of rank m_size is the total number of sequences.
+ */
+LargeIndex Parameters::getFirstSequenceOfRank(Rank rank){
+
+	if(m_sequencePartition.size()==0)
+		computeSequencePartition();
+
+	#ifdef CONFIG_ASSERT
+	assert(rank>=0);
+	assert(rank<=m_size);
+	#endif
+
+	return m_sequencePartition[rank];
+}
+
 Rank Parameters::getRankFromGlobalId(ReadHandle & a){
 
-	uint64_t elementsPerRank=m_totalNumberOfSequences/m_size;
+	if(m_sequencePartition.size()==0)
+		computeSequencePartition();
 
-	Rank rank=a/elementsPerRank;
+/* the last rank whose first sequence is not after a, empty ranks are skipped */
+	Rank rank=upper_bound(m_sequencePartition.begin(),m_sequencePartition.end(),a.getValue())
+		-m_sequencePartition.begin()-1;
 
 	if(rank >= m_size){
 		rank=m_size-1;
@@ -2065,7 +2256,7 @@ Rank Parameters::getRankFromGlobalId(ReadHandle & a){
 	#ifdef CONFIG_ASSERT
 
 	if(rank<0){
-		cout<<"Error: rank is < 0, rank: "<<rank<<" ReadHandle: "<<a<<" elementsPerRank: "<<elementsPerRank;
+		cout<<"Error: rank is < 0, rank: "<<rank<<" ReadHandle: "<<a;
 		cout<<"self.rank is "<<m_rank<<endl;
 	}
 
@@ -2083,8 +2274,7 @@ Rank Parameters::getRankFromGlobalId(ReadHandle & a){
 
 int Parameters::getIdFromGlobalId(ReadHandle & a){
 	int bin=getRankFromGlobalId(a);
-	LargeCount x=m_totalNumberOfSequences/m_size;
-	return a-bin*x;
+	return a-getFirstSequenceOfRank(bin);
 }
 
 int Parameters::getMaximumDistance(){
@@ -2092,8 +2282,7 @@ int Parameters::getMaximumDistance(){
 }
 
 uint64_t Parameters::getGlobalIdFromRankAndLocalId(Rank rank,int id){
-	uint64_t x=m_totalNumberOfSequences/m_size;
-	return rank*x+id;
+	return getFirstSequenceOfRank(rank)+id;
 }
 
 CoverageDepth Parameters::getMinimumCoverage(){
@@ -2114,9 +2303,92 @@ bool Parameters::hasPairedReads(){
 }
 
 Rank Parameters::vertexRank(Kmer*a){
+	if(m_useMinimizerPlacement)
+		return m_minimizerPlacement.getRank(a);
+
 	return a->vertexRank(m_size,m_wordSize,m_colorSpaceMode);
 }
 
+/*
+ * Same as vertexRank, without computing the reverse complement.
+ */
+Rank Parameters::vertexRankOfLowerKey(Kmer*lowerKey){
+	if(m_useMinimizerPlacement)
+		return m_minimizerPlacement.getRankOfLowerKey(lowerKey);
+
+	return lowerKey->hash_function_1()%m_size;
+}
+
+/*
+ * NULL without -minimizer-placement. The table is dealt like cards
+ * until the master sends the balanced table.
+ */
+MinimizerPlacement*Parameters::getMinimizerPlacement(){
+
+	if(!hasOption("-minimizer-placement"))
+		return NULL;
+
+	if(!m_constructedMinimizerPlacement){
+		int minimizerLength=MINIMIZER_PLACEMENT_DEFAULT_LENGTH;
+
+		if(hasConfigurationOption("-minimizer-length",1))
+			minimizerLength=getConfigurationInteger("-minimizer-length",0);
+
+		m_minimizerPlacement.constructor(m_wordSize,minimizerLength,m_colorSpaceMode,m_size);
+		m_constructedMinimizerPlacement=true;
+	}
+
+	return &m_minimizerPlacement;
+}
+
+/*
+ * This is done on the master before the k-mers are counted,
+ * the table of the checkpoint is used if there is one.
+ */
+bool Parameters::buildMinimizerPlacement(){
+
+	MinimizerPlacement*placement=getMinimizerPlacement();
+
+	if(placement==NULL)
+		return true;
+
+	if(hasCheckpoint("MinimizerPlacement")){
+		cout<<"Rank "<<m_rank<<" is reading checkpoint MinimizerPlacement"<<endl;
+
+		if(!placement->readCheckpoint(getCheckpointFile("MinimizerPlacement").c_str())){
+			cout<<"Error: Rank "<<m_rank<<" can not read checkpoint MinimizerPlacement"<<endl;
+			return false;
+		}
+
+		return true;
+	}
+
+	placement->build(this);
+
+	if(writeCheckpoints()){
+		cout<<"Rank "<<m_rank<<" is writing checkpoint MinimizerPlacement"<<endl;
+
+		if(!placement->writeCheckpoint(getCheckpointFile("MinimizerPlacement").c_str()))
+			cout<<"Error: Rank "<<m_rank<<" can not write checkpoint MinimizerPlacement"<<endl;
+	}
+
+	return true;
+}
+
+/* all the buckets of the table were received */
+void Parameters::enableMinimizerPlacement(){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_constructedMinimizerPlacement);
+	#endif
+
+	m_useMinimizerPlacement=true;
+}
+
+bool Parameters::useMinimizerPlacement(){
+	return m_useMinimizerPlacement;
+}
+
 string Parameters::getScaffoldFile(){
 	ostringstream a;
 	a<<getPrefix()<<"Scaffolds.fasta";
@@ -2176,6 +2448,34 @@ string Parameters::getCheckpointFile(const char*checkpointName){
 	return a.str();
 }
 
+/*
+ * This file is written by the rank that counts the sequences of
+ * the input file and read by all the ranks, so it is in the
+ * output directory.
+ */
+string Parameters::getSequenceOffsetsFile(int file){
+	ostringstream a;
+	a<<getPrefix();
+	a<<"File"<<file<<".SequenceOffsets.txt";
+	return a.str();
+}
+
+/*
+ * The manifest of an input file in a read-only directory goes in the
+ * checkpoint directory. The output directory can not be used because
+ * a run does not start if it exists. Without a checkpoint directory,
+ * there is no such place and the name is empty.
+ */
+string Parameters::getSequenceManifestFile(int file){
+	if(!m_hasCheckpointDirectory)
+		return "";
+
+	ostringstream a;
+	a<<m_checkpointDirectory<<"/";
+	a<<"File"<<file<<SEQUENCE_FILE_MANIFEST_SUFFIX;
+	return a.str();
+}
+
 bool Parameters::hasCheckpoint(const char*checkpointName){
 	//cout<<"hasCheckpoint? "<<checkpointName<<endl;
 
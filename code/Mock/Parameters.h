@@ -25,6 +25,7 @@
 #include "common_functions.h"
 
 #include <code/SequencesLoader/ReadHandle.h>
+#include <code/KmerAcademyBuilder/MinimizerPlacement.h>
 
 #include <map>
 #include <set>
@@ -55,6 +56,12 @@ using namespace std;
  */
 #define __DEFAULT_BUCKETS_PER_GROUP 64
 
+/**
+ * The number of k-mers of a file is not known because its
+ * loader does not record the lengths of the sequences.
+ */
+#define UNKNOWN_NUMBER_OF_KMER_POSITIONS ((LargeCount)-1)
+
 /**
  * This class is the implementation of an interpreter for the RayInputFile.
  * It allows the following commands:
@@ -120,6 +127,20 @@ class Parameters{
 	vector<string> m_singleEndReadsFile;
 	map<int,LargeCount> m_numberOfSequencesInFile;
 	LargeCount m_totalNumberOfSequences;
+
+	/** the number of k-mers in the sequences of each file */
+	map<int,LargeCount> m_numberOfKmerPositionsInFile;
+
+	/**
+	 * the first global sequence identifier of each rank,
+	 * plus the total number of sequences at the end
+	 */
+	vector<LargeIndex> m_sequencePartition;
+
+	/** place the k-mers with their minimizers, see -minimizer-placement */
+	MinimizerPlacement m_minimizerPlacement;
+	bool m_constructedMinimizerPlacement;
+	bool m_useMinimizerPlacement;
 	map<int,int> m_fileLibrary;
 	vector<vector<int> > m_libraryFiles;
 	set<int> m_automaticLibraries;
@@ -192,6 +213,8 @@ public:
 	void computeAverageDistances();
 	LargeCount getNumberOfSequences(int n);
 	void setNumberOfSequences(int file,LargeCount n);
+	LargeCount getNumberOfKmerPositions(int file);
+	void setNumberOfKmerPositions(int file,LargeCount positions);
 	int getNumberOfFiles();
 	bool isAutomatic(int library);
 	int getLibrary(int file);
@@ -210,6 +233,8 @@ public:
 	void showUsage();
 	int getReducerValue();
 
+	void computeSequencePartition();
+	LargeIndex getFirstSequenceOfRank(Rank rank);
 	Rank getRankFromGlobalId(ReadHandle & a);
 	int getIdFromGlobalId(ReadHandle & a);
 	int getMaximumDistance();
@@ -220,6 +245,11 @@ public:
 	Kmer _complementVertex(Kmer*a);
 	bool hasPairedReads();
 	Rank vertexRank(Kmer*a);
+	Rank vertexRankOfLowerKey(Kmer*lowerKey);
+	MinimizerPlacement*getMinimizerPlacement();
+	bool buildMinimizerPlacement();
+	void enableMinimizerPlacement();
+	bool useMinimizerPlacement();
 	string getMemoryPrefix();
 	/**
 	* run the profiler
@@ -254,6 +284,12 @@ public:
 	/** get the checkpoint file */
 	string getCheckpointFile(const char*a);
 
+	/** get the file with the byte offsets of sequences in an input file */
+	string getSequenceOffsetsFile(int file);
+
+	/** where the manifest of an input file goes if it can not be next to the file */
+	string getSequenceManifestFile(int file);
+
 	/** true if file exists */
 	bool hasFile(const char*file);
 	bool writeCheckpoints();
@@ -129,6 +129,23 @@
 	typedef uint64_t CoverageDepth;
 #endif
 
+/*
+ * this is the type of the coverage counter stored in a Vertex
+ *
+ * When CoverageDepth is wider than 16 bits, a Vertex stores only
+ * 16 bits and the coverage values that do not fit are stored in a
+ * CoverageOverflowTable. The counter is then saturated at
+ * VERTEX_COVERAGE_SATURATED.
+ */
+
+#if CONFIG_MAXIMUM_COVERAGE < 65536
+	typedef CoverageDepth VertexCoverage;
+#else
+	typedef uint16_t VertexCoverage;
+#endif
+
+#define VERTEX_COVERAGE_SATURATED ((VertexCoverage)(-1))
+
 /** 32-bit or 64-bit system */
 
 #if defined(__WORDSIZE)
@@ -23,13 +23,18 @@
 
 #include <RayPlatform/core/OperatingSystem.h>
 
+#include <algorithm>
 #include <stdlib.h>
+#include <sys/types.h>
+#include <sys/stat.h>
 
 __CreatePlugin(Partitioner);
 
 __CreateMasterModeAdapter(Partitioner,RAY_MASTER_MODE_COUNT_FILE_ENTRIES);
 __CreateSlaveModeAdapter(Partitioner,RAY_SLAVE_MODE_COUNT_FILE_ENTRIES);
 
+__CreateMessageTagAdapter(Partitioner,RAY_MPI_TAG_SET_FILE_RANKS);
+
 void Partitioner::constructor(RingAllocator*outboxAllocator,StaticVector*inbox,StaticVector*outbox,Parameters*parameters,
 	SwitchMan*switchMan){
 
@@ -50,10 +55,53 @@ void Partitioner::call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES(){
 		m_initiatedMaster=true;
 		m_ranksDoneCounting=0;
 		m_ranksDoneSending=0;
+
+		assignFilesToRanks();
+
+		m_currentFileToAssign=0;
+		m_sentFileRanks=false;
+
+	/** send the rank in charge of each file, the files stay in the same order */
+	}else if(m_currentFileToAssign<m_parameters->getNumberOfFiles()){
+		if(!m_sentFileRanks){
+			MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
+			int maximumUnits=MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit);
+			int bufferSize=0;
+			int file=m_currentFileToAssign;
+
+			while(file<m_parameters->getNumberOfFiles() && bufferSize+2<=maximumUnits){
+				message[bufferSize++]=file;
+				message[bufferSize++]=m_ranksInCharge[file];
+				file++;
+			}
+
+			for(Rank destination=0;destination<m_parameters->getSize();destination++){
+				Message aMessage(message,bufferSize,destination,RAY_MPI_TAG_SET_FILE_RANKS,m_parameters->getRank());
+				m_outbox->push_back(&aMessage);
+			}
+
+			m_nextFileToAssign=file;
+			m_ranksDoneAssigning=0;
+			m_sentFileRanks=true;
+
+		}else if(m_inbox->size()>0 && m_inbox->at(0)->getTag()==RAY_MPI_TAG_SET_FILE_RANKS_REPLY){
+			m_ranksDoneAssigning++;
+
+			if(m_ranksDoneAssigning==m_parameters->getSize()){
+				m_currentFileToAssign=m_nextFileToAssign;
+				m_sentFileRanks=false;
+			}
+		}
+	/** every peer knows its files, tell them to count the entries in parallel */
+	}else if(m_currentFileToAssign==m_parameters->getNumberOfFiles()){
 		for(int destination=0;destination<m_parameters->getSize();destination++){
 			Message aMessage(NULL,0,destination,RAY_MPI_TAG_COUNT_FILE_ENTRIES,m_parameters->getRank());
 			m_outbox->push_back(&aMessage);
 		}
+
+		/* increment it so we don't go here again. */
+		m_currentFileToAssign++;
+
 	/** a peer rank finished counting the entries in its files */
 	}else if(m_inbox->size()>0 && m_inbox->at(0)->getTag()== RAY_MPI_TAG_COUNT_FILE_ENTRIES_REPLY){
 		m_ranksDoneCounting++;
@@ -70,9 +118,10 @@ void Partitioner::call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES(){
 		int file=buffer[0];
 		LargeCount count=buffer[1];
 		m_masterCounts[file]=count;
+		m_masterKmerPositions[file]=buffer[2];
 
 		if(m_parameters->hasOption("-debug-partitioner"))
-			cout<<"Rank "<<m_parameters->getRank()<<" received from "<<m_inbox->at(0)->getSource()<<" File "<<file<<" Entries "<<count<<endl;
+			cout<<"Rank "<<m_parameters->getRank()<<" received from "<<m_inbox->at(0)->getSource()<<" File "<<file<<" Entries "<<count<<" Kmers "<<buffer[2]<<endl;
 		/** reply to the peer */
 		Message aMessage(NULL,0,m_inbox->at(0)->getSource(),RAY_MPI_TAG_FILE_ENTRY_COUNT_REPLY,m_parameters->getRank());
 		m_outbox->push_back(&aMessage);
@@ -87,8 +136,10 @@ void Partitioner::call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES(){
 				if(m_parameters->hasOption("-debug-partitioner"))
 					cout<<"Rank "<<m_parameters->getRank()<< " File "<<i<<" Count "<<m_masterCounts[i]<<endl;
 				m_parameters->setNumberOfSequences(i,m_masterCounts[i]);
+				m_parameters->setNumberOfKmerPositions(i,m_masterKmerPositions[i]);
 			}
 			m_masterCounts.clear();
+			m_masterKmerPositions.clear();
 
 			/* write the number of sequences */
 			ostringstream fileName;
@@ -117,6 +168,9 @@ void Partitioner::call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES(){
 				LargeCount entries=m_parameters->getNumberOfSequences(i);
 				f2<<" 	NumberOfSequences: "<<entries<<endl;
 
+				if(m_parameters->getNumberOfKmerPositions(i)!=UNKNOWN_NUMBER_OF_KMER_POSITIONS)
+					f2<<"	NumberOfKmers: "<<m_parameters->getNumberOfKmerPositions(i)<<endl;
+
 				if(entries>0){
 					f2<<"	FirstSequence: "<<totalSequences<<endl;
 					f2<<"	LastSequence: "<<totalSequences+entries-1<<endl;
@@ -151,17 +205,12 @@ void Partitioner::call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES(){
 			fileName2<<"SequencePartition.txt";
 			ofstream f3(fileName2.str().c_str());
 
-			LargeCount perRank=totalSequences/m_parameters->getSize();
+/* this is the partition used by SequencesLoader */
 			f3<<"#Rank	FirstSequence	LastSequence	NumberOfSequences"<<endl;
 			for(int i=0;i<m_parameters->getSize();i++){
-				LargeIndex first=i*perRank;
-				LargeIndex last=first+perRank-1;
-
-				if(i==m_parameters->getSize()-1){
-					last=totalSequences-1;
-				}
-
-				LargeCount count=last-first+1;
+				LargeIndex first=m_parameters->getFirstSequenceOfRank(i);
+				LargeCount count=m_parameters->getFirstSequenceOfRank(i+1)-first;
+				LargeIndex last=first+count-1;
 
 				f3<<i<<"\t"<<first<<"\t"<<last<<"\t"<<count<<endl;
 			}
@@ -235,6 +284,218 @@ bool Partitioner::checkIfPairedFilesAreValid() {
 	return true;
 }
 
+/*
+ * The largest files first, the order of the files breaks the ties.
+ */
+static bool compareFileSizes(const pair<uint64_t,int>&a,const pair<uint64_t,int>&b){
+	if(a.first!=b.first)
+		return a.first>b.first;
+
+	return a.second<b.second;
+}
+
+/*
+ * A file is counted by one rank. Each file goes to the rank that has the
+ * fewest bytes to count so far, the largest files first, so that the
+ * large files are not counted by the same rank.
+ * With files of the same size, this is file % size.
+ *
+ * Only the master computes the assignment, the file system may not give
+ * the same sizes to every rank. With the checkpoint, the assignment of
+ * the run that wrote it is used, the counts are in the checkpoints
+ * of the ranks in charge.
+ */
+void Partitioner::assignFilesToRanks(){
+
+	int files=m_parameters->getNumberOfFiles();
+
+	if(m_parameters->hasCheckpoint("Partition")){
+		map<int,LargeCount> counts;
+		map<int,LargeCount> kmerPositions;
+
+		if(readCheckpoint(&counts,&kmerPositions,&m_ranksInCharge))
+			return;
+	}
+
+	vector<pair<uint64_t,int> > fileSizes;
+
+	for(int file=0;file<files;file++){
+		struct stat status;
+		uint64_t size=0;
+
+		if(stat(m_parameters->getFile(file).c_str(),&status)==0)
+			size=status.st_size;
+
+		fileSizes.push_back(make_pair(size,file));
+	}
+
+	sort(fileSizes.begin(),fileSizes.end(),compareFileSizes);
+
+	vector<uint64_t> bytes(m_parameters->getSize(),0);
+	vector<int> numberOfFiles(m_parameters->getSize(),0);
+
+	m_ranksInCharge.assign(files,0);
+
+	for(int i=0;i<(int)fileSizes.size();i++){
+		Rank rankInCharge=0;
+
+		for(Rank rank=1;rank<m_parameters->getSize();rank++){
+			if(bytes[rank]<bytes[rankInCharge]
+				|| (bytes[rank]==bytes[rankInCharge] && numberOfFiles[rank]<numberOfFiles[rankInCharge]))
+				rankInCharge=rank;
+		}
+
+		m_ranksInCharge[fileSizes[i].second]=rankInCharge;
+		bytes[rankInCharge]+=fileSizes[i].first;
+		numberOfFiles[rankInCharge]++;
+	}
+}
+
+/*
+ * The checkpoint of a rank has the files it counted and the ranks in
+ * charge of all the files. The checkpoints written before the k-mers were
+ * counted have neither: these runs divided the sequences evenly
+ * (UNKNOWN_NUMBER_OF_KMER_POSITIONS gives the same partition) and the
+ * files with file % size.
+ */
+bool Partitioner::readCheckpoint(map<int,LargeCount>*counts,map<int,LargeCount>*kmerPositions,
+		vector<Rank>*ranksInCharge){
+
+	ifstream f(m_parameters->getCheckpointFile("Partition").c_str());
+
+	int count=0;
+	f.read((char*)&count,sizeof(int));
+
+	bool hasKmerPositions=(count==PARTITIONER_CHECKPOINT_FORMAT);
+
+	if(hasKmerPositions)
+		f.read((char*)&count,sizeof(int));
+
+	for(int i=0;i<count;i++){
+		int file=-1;
+		LargeCount sequences=0;
+		LargeCount positions=UNKNOWN_NUMBER_OF_KMER_POSITIONS;
+		f.read((char*)&file,sizeof(int));
+		f.read((char*)&sequences,sizeof(LargeCount));
+
+		if(hasKmerPositions)
+			f.read((char*)&positions,sizeof(LargeCount));
+
+		#ifdef CONFIG_ASSERT
+		assert(file>=0);
+		assert(counts->count(file)==0);
+		#endif
+
+		(*counts)[file]=sequences;
+		(*kmerPositions)[file]=positions;
+	}
+
+	int files=m_parameters->getNumberOfFiles();
+
+	ranksInCharge->assign(files,0);
+
+	if(!hasKmerPositions){
+		for(int file=0;file<files;file++)
+			(*ranksInCharge)[file]=file%m_parameters->getSize();
+	}else{
+		int checkpointFiles=0;
+		f.read((char*)&checkpointFiles,sizeof(int));
+
+		if(checkpointFiles!=files){
+			cout<<"Rank "<<m_parameters->getRank()<<": Error, the checkpoint Partition has "<<checkpointFiles;
+			cout<<" files, not "<<files<<", it is not used"<<endl;
+			f.close();
+			return false;
+		}
+
+		for(int file=0;file<files;file++){
+			int rank=0;
+			f.read((char*)&rank,sizeof(int));
+			(*ranksInCharge)[file]=rank;
+		}
+	}
+
+	bool good=!f.fail();
+	f.close();
+
+	return good;
+}
+
+void Partitioner::writeCheckpoint(){
+
+	ofstream f(m_parameters->getCheckpointFile("Partition").c_str());
+	ostringstream buffer;
+	cout<<"Rank "<<m_parameters->getRank()<<" is writing checkpoint Partition"<<endl;
+
+	int format=PARTITIONER_CHECKPOINT_FORMAT;
+	buffer.write((char*)&format, sizeof(int));
+
+	int count=m_slaveCounts.size();
+	buffer.write((char*)&count , sizeof(int));
+
+	for(map<int,LargeCount>::iterator i=m_slaveCounts.begin();
+		i!=m_slaveCounts.end();i++){
+		int file=i->first;
+		LargeCount sequences=i->second;
+		LargeCount positions=m_slaveKmerPositions[file];
+		buffer.write((char*)&file, sizeof(int));
+		buffer.write((char*)&sequences, sizeof(LargeCount));
+		buffer.write((char*)&positions, sizeof(LargeCount));
+		flushFileOperationBuffer(false, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
+	}
+
+	int files=m_ranksInCharge.size();
+	buffer.write((char*)&files, sizeof(int));
+
+	for(int file=0;file<files;file++){
+		int rank=m_ranksInCharge[file];
+		buffer.write((char*)&rank, sizeof(int));
+		flushFileOperationBuffer(false, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
+	}
+
+	flushFileOperationBuffer(true, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
+	f.close();
+}
+
+/*
+ * The master sends the rank in charge of each file
+ * before the files are counted.
+ */
+void Partitioner::call_RAY_MPI_TAG_SET_FILE_RANKS(Message*message){
+
+	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
+
+	#ifdef CONFIG_ASSERT
+	assert(message->getCount()%2==0);
+	#endif
+
+	if((int)m_ranksInCharge.size()!=m_parameters->getNumberOfFiles())
+		m_ranksInCharge.assign(m_parameters->getNumberOfFiles(),0);
+
+	for(int i=0;i<message->getCount();i+=2){
+		int file=incoming[i];
+		Rank rank=incoming[i+1];
+
+		#ifdef CONFIG_ASSERT
+		assert(file>=0 && file<(int)m_ranksInCharge.size());
+		assert(rank>=0 && rank<m_parameters->getSize());
+		#endif
+
+		m_ranksInCharge[file]=rank;
+	}
+
+	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_SET_FILE_RANKS_REPLY,m_parameters->getRank());
+	m_outbox->push_back(&aMessage);
+}
+
+LargeCount Partitioner::getNumberOfKmerPositions(SequenceFileManifest*manifest){
+
+	if(!manifest->hasLengths())
+		return UNKNOWN_NUMBER_OF_KMER_POSITIONS;
+
+	return manifest->getNumberOfKmerPositions(m_parameters->getWordSize());
+}
+
 void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 	/** initialize the slave */
 	if(!m_initiatedSlave){
@@ -243,32 +504,26 @@ void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 		m_currentlySendingCounts=false;
 		m_sentCount=false;
 
+		#ifdef CONFIG_ASSERT
+		assert((int)m_ranksInCharge.size()==m_parameters->getNumberOfFiles());
+		#endif
+
 		/* possibly read the checkpoint */
 		if(m_parameters->hasCheckpoint("Partition")){
-			ifstream f(m_parameters->getCheckpointFile("Partition").c_str());
 			cout<<"Rank "<<m_parameters->getRank()<<" is reading checkpoint Partition"<<endl;
-			int count=0;
-			f.read((char*)&count,sizeof(int));
-			for(int i=0;i<count;i++){
-				int file=-1;
-				LargeCount sequences=0;
-				f.read((char*)&file,sizeof(int));
-				f.read((char*)&sequences,sizeof(LargeCount));
-
-				#ifdef CONFIG_ASSERT
-				assert(file>=0);
-				assert(m_slaveCounts.count(file)==0);
-				#endif
-
-				m_slaveCounts[file]=sequences;
-
-				#ifdef CONFIG_ASSERT
-				assert(m_slaveCounts.count(file)>0);
-				#endif
-				cout<<"Rank "<<m_parameters->getRank()<<": from checkpoint Partition, file "<<file<<" has "<<sequences<<" sequences."<<endl;
+
+/* the ranks in charge are those sent by the master */
+			vector<Rank> ranksInCharge;
+
+			if(readCheckpoint(&m_slaveCounts,&m_slaveKmerPositions,&ranksInCharge)){
+				for(map<int,LargeCount>::iterator i=m_slaveCounts.begin();i!=m_slaveCounts.end();i++)
+					cout<<"Rank "<<m_parameters->getRank()<<": from checkpoint Partition, file "<<i->first<<" has "<<i->second<<" sequences."<<endl;
+
+				m_currentFileToCount=m_parameters->getNumberOfFiles();
+			}else{
+				m_slaveCounts.clear();
+				m_slaveKmerPositions.clear();
 			}
-			f.close();
-			m_currentFileToCount=m_parameters->getNumberOfFiles();
 		}
 	/* all files were processed, tell control peer that we are done */
 	}else if(m_currentFileToCount==m_parameters->getNumberOfFiles()){
@@ -278,40 +533,70 @@ void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 		m_currentFileToCount++;
 
 		/* Here we write the checkpoint Partition */
-		if(m_parameters->writeCheckpoints() && !m_parameters->hasCheckpoint("Partition")){
-			ofstream f(m_parameters->getCheckpointFile("Partition").c_str());
-			ostringstream buffer;
-			cout<<"Rank "<<m_parameters->getRank()<<" is writing checkpoint Partition"<<endl;
-			int count=m_slaveCounts.size();
-			buffer.write((char*)&count , sizeof(int));
-
-			for(map<int,LargeCount>::iterator i=m_slaveCounts.begin();
-				i!=m_slaveCounts.end();i++){
-				int file=i->first;
-				LargeCount sequences=i->second;
-				buffer.write((char*)&file, sizeof(int));
-				buffer.write((char*)&sequences, sizeof(LargeCount));
-				flushFileOperationBuffer(false, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
-			}
-			flushFileOperationBuffer(true, &buffer, &f, CONFIG_FILE_IO_BUFFER_SIZE);
-			f.close();
-		}
+		if(m_parameters->writeCheckpoints() && !m_parameters->hasCheckpoint("Partition"))
+			writeCheckpoint();
 	/** count sequences in a file */
 	}else if(m_currentFileToCount<m_parameters->getNumberOfFiles()){
-		int rankInCharge=m_currentFileToCount%m_parameters->getSize();
+		int rankInCharge=m_ranksInCharge[m_currentFileToCount];
 		if(rankInCharge==m_parameters->getRank()){
 			/** count the entries in the file */
 			string file=m_parameters->getFile(m_currentFileToCount);
-			//cout<<"Rank "<<m_parameters->getRank()<<" Reading "<<file<<endl;
-			int res=m_loader.load(file,false);
-			if(res==EXIT_FAILURE){
-				cout<<"Rank "<<m_parameters->getRank()<<" Error: "<<file<<" failed to load properly..."<<endl;
+			string offsetsFile=m_parameters->getSequenceOffsetsFile(m_currentFileToCount);
+			string manifestFile=m_parameters->getSequenceManifestFile(m_currentFileToCount);
+
+			SequenceFileManifest manifest;
+
+/*
+ * The manifest written by a previous run has everything,
+ * the file is not read at all.
+ */
+			if(manifest.load(file.c_str(),manifestFile.c_str())){
+				m_slaveCounts[m_currentFileToCount]=manifest.getNumberOfSequences();
+
+				vector<uint64_t> offsets;
+				manifest.getOffsets(&offsets);
+
+				/* the other ranks will use these to go directly to their sequences */
+				m_loader.writeOffsets(offsetsFile,&offsets);
+
+				cout<<"Rank "<<m_parameters->getRank()<<": read the manifest of "<<file<<endl;
+			}else{
+				//cout<<"Rank "<<m_parameters->getRank()<<" Reading "<<file<<endl;
+				int res=m_loader.load(file,false);
+				if(res==EXIT_FAILURE){
+					cout<<"Rank "<<m_parameters->getRank()<<" Error: "<<file<<" failed to load properly..."<<endl;
+				}
+				m_slaveCounts[m_currentFileToCount]=m_loader.size();
+
+				/* the other ranks will use these to go directly to their sequences */
+				m_loader.writeOffsets(offsetsFile);
+
+				vector<uint64_t> offsets;
+				m_loader.getOffsets(&offsets);
+
+				vector<LargeCount> lengths;
+
+				if(res!=EXIT_FAILURE && manifest.create(file.c_str(),m_loader.size(),&offsets)){
+					if(m_loader.getLengths(&lengths))
+						manifest.setLengths(&lengths);
+
+					manifest.write(file.c_str(),manifestFile.c_str());
+				}
+
+				m_loader.clear();
 			}
-			m_slaveCounts[m_currentFileToCount]=m_loader.size();
 
-			m_loader.clear();
+			m_slaveKmerPositions[m_currentFileToCount]=getNumberOfKmerPositions(&manifest);
 
-			cout<<"Rank "<<m_parameters->getRank()<<": File "<<file<<" (Number "<<m_currentFileToCount<<") has "<<m_slaveCounts[m_currentFileToCount]<<" sequences"<<endl;
+			cout<<"Rank "<<m_parameters->getRank()<<": File "<<file<<" (Number "<<m_currentFileToCount<<") has "<<m_slaveCounts[m_currentFileToCount]<<" sequences";
+
+			if(manifest.hasLengths() && m_slaveCounts[m_currentFileToCount]>0){
+				cout<<", "<<manifest.getNumberOfBases()<<" nucleotides, lengths from ";
+				cout<<manifest.getMinimumLength()<<" to "<<manifest.getMaximumLength();
+				cout<<", "<<m_slaveKmerPositions[m_currentFileToCount]<<" k-mers";
+			}
+
+			cout<<endl;
 		}
 		m_currentFileToCount++;
 
@@ -322,7 +607,7 @@ void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 	/** sending counts */
 	}else if(m_currentlySendingCounts){
 		if(m_currentFileToSend<m_parameters->getNumberOfFiles()){
-			int rankInCharge=m_currentFileToSend%m_parameters->getSize();
+			int rankInCharge=m_ranksInCharge[m_currentFileToSend];
 			/** skip the file, we are not in charge */
 			if(rankInCharge!=m_parameters->getRank()){
 				m_currentFileToSend++;
@@ -331,7 +616,8 @@ void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 				MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
 				message[0]=m_currentFileToSend;
 				message[1]=m_slaveCounts[m_currentFileToSend];
-				Message aMessage(message,2,MASTER_RANK,RAY_MPI_TAG_FILE_ENTRY_COUNT,m_parameters->getRank());
+				message[2]=m_slaveKmerPositions[m_currentFileToSend];
+				Message aMessage(message,3,MASTER_RANK,RAY_MPI_TAG_FILE_ENTRY_COUNT,m_parameters->getRank());
 				m_outbox->push_back(&aMessage);
 				m_sentCount=true;
 			/** we got a reply, let's continue */
@@ -344,6 +630,7 @@ void Partitioner::call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES(){
 			Message aMessage(NULL,0,MASTER_RANK,RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY,m_parameters->getRank());
 			m_outbox->push_back(&aMessage);
 			m_slaveCounts.clear();
+			m_slaveKmerPositions.clear();
 
 			m_switchMan->setSlaveMode(RAY_SLAVE_MODE_DO_NOTHING);
 		}
@@ -386,6 +673,13 @@ void Partitioner::registerPlugin(ComputeCore*core){
 	RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY=core->allocateMessageTagHandle(plugin);
 	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY,"RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY");
 
+	RAY_MPI_TAG_SET_FILE_RANKS=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagObjectHandler(plugin,RAY_MPI_TAG_SET_FILE_RANKS, __GetAdapter(Partitioner,RAY_MPI_TAG_SET_FILE_RANKS));
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SET_FILE_RANKS,"RAY_MPI_TAG_SET_FILE_RANKS");
+
+	RAY_MPI_TAG_SET_FILE_RANKS_REPLY=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SET_FILE_RANKS_REPLY,"RAY_MPI_TAG_SET_FILE_RANKS_REPLY");
+
 }
 
 void Partitioner::resolveSymbols(ComputeCore*core){
@@ -404,6 +698,8 @@ void Partitioner::resolveSymbols(ComputeCore*core){
 	RAY_MPI_TAG_FILE_ENTRY_COUNT_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_FILE_ENTRY_COUNT_REPLY");
 	RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS");
 	RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY");
+	RAY_MPI_TAG_SET_FILE_RANKS=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_FILE_RANKS");
+	RAY_MPI_TAG_SET_FILE_RANKS_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SET_FILE_RANKS_REPLY");
 
 	RAY_MPI_TAG_COUNT_FILE_ENTRIES=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_COUNT_FILE_ENTRIES");
 	RAY_MPI_TAG_COUNT_FILE_ENTRIES_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_COUNT_FILE_ENTRIES_REPLY");
@@ -416,4 +712,5 @@ void Partitioner::resolveSymbols(ComputeCore*core){
 
 	__BindAdapter(Partitioner,RAY_MASTER_MODE_COUNT_FILE_ENTRIES);
 	__BindAdapter(Partitioner,RAY_SLAVE_MODE_COUNT_FILE_ENTRIES);
+	__BindAdapter(Partitioner,RAY_MPI_TAG_SET_FILE_RANKS);
 }
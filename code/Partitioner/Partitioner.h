@@ -24,6 +24,7 @@
 
 #include <code/Mock/Parameters.h>
 #include <code/SequencesLoader/Loader.h>
+#include <code/SequencesLoader/SequenceFileManifest.h>
 
 #include <RayPlatform/structures/StaticVector.h>
 #include <RayPlatform/memory/RingAllocator.h>
@@ -33,21 +34,35 @@
 #include <RayPlatform/core/ComputeCore.h>
 
 #include <map>
+#include <vector>
 using namespace std;
 
+/*
+ * The checkpoint Partition starts with this instead of the number of
+ * files when it has the k-mers of the files and the ranks in charge.
+ * A count is never negative, so the older checkpoints are recognized.
+ */
+#define PARTITIONER_CHECKPOINT_FORMAT (-2)
+
 __DeclarePlugin(Partitioner);
 
 __DeclareMasterModeAdapter(Partitioner,RAY_MASTER_MODE_COUNT_FILE_ENTRIES);
 __DeclareSlaveModeAdapter(Partitioner,RAY_SLAVE_MODE_COUNT_FILE_ENTRIES);
 
+__DeclareMessageTagAdapter(Partitioner,RAY_MPI_TAG_SET_FILE_RANKS);
+
 /**
- * This class counts the number of entries in each input file in parallel 
+ * This class counts the number of entries in each input file in parallel.
+ * The number of k-mers of each file is counted too when the
+ * loader records the lengths, the sequence partition
+ * balances them (see Parameters::computeSequencePartition).
  * \author Sébastien Boisvert
  */
 class Partitioner :  public CorePlugin{
 
 	__AddAdapter(Partitioner,RAY_MASTER_MODE_COUNT_FILE_ENTRIES);
 	__AddAdapter(Partitioner,RAY_SLAVE_MODE_COUNT_FILE_ENTRIES);
+	__AddAdapter(Partitioner,RAY_MPI_TAG_SET_FILE_RANKS);
 
 	MessageTag RAY_MPI_TAG_COUNT_FILE_ENTRIES;
 	MessageTag RAY_MPI_TAG_COUNT_FILE_ENTRIES_REPLY;
@@ -55,6 +70,8 @@ class Partitioner :  public CorePlugin{
 	MessageTag RAY_MPI_TAG_FILE_ENTRY_COUNT_REPLY;
 	MessageTag RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS;
 	MessageTag RAY_MPI_TAG_REQUEST_FILE_ENTRY_COUNTS_REPLY;
+	MessageTag RAY_MPI_TAG_SET_FILE_RANKS;
+	MessageTag RAY_MPI_TAG_SET_FILE_RANKS_REPLY;
 
 	MasterMode RAY_MASTER_MODE_COUNT_FILE_ENTRIES;
 	MasterMode RAY_MASTER_MODE_LOAD_SEQUENCES;
@@ -86,8 +103,22 @@ class Partitioner :  public CorePlugin{
 	bool m_currentlySendingCounts;
 	/** counts for a peer slave */
 	map<int,LargeCount> m_slaveCounts;
+	/** numbers of k-mers for a peer slave */
+	map<int,LargeCount> m_slaveKmerPositions;
 	/** counts for the master node */
 	map<int,LargeCount> m_masterCounts;
+	/** numbers of k-mers for the master node */
+	map<int,LargeCount> m_masterKmerPositions;
+	/** the rank that counts each file, computed by the master */
+	vector<Rank> m_ranksInCharge;
+	/** the first file whose rank in charge is not sent yet */
+	int m_currentFileToAssign;
+	/** the file after the last one of the message sent */
+	int m_nextFileToAssign;
+	/** were the ranks in charge sent ? */
+	bool m_sentFileRanks;
+	/** the number of peers that have the ranks in charge */
+	int m_ranksDoneAssigning;
 
 	/** --- Below are the only elements necessary to bind Partitioner to the Ray software stack */
 	/** allocator for outgoing messages */
@@ -103,12 +134,18 @@ class Partitioner :  public CorePlugin{
 
 
 	bool checkIfPairedFilesAreValid();
+	void assignFilesToRanks();
+	bool readCheckpoint(map<int,LargeCount>*counts,map<int,LargeCount>*kmerPositions,
+		vector<Rank>*ranksInCharge);
+	void writeCheckpoint();
+	LargeCount getNumberOfKmerPositions(SequenceFileManifest*manifest);
 
 public:
 	void constructor(RingAllocator*outboxAllocator,StaticVector*inbox,StaticVector*outbox,Parameters*parameters,
 	SwitchMan*switchMan);
 	void call_RAY_MASTER_MODE_COUNT_FILE_ENTRIES();
 	void call_RAY_SLAVE_MODE_COUNT_FILE_ENTRIES();
+	void call_RAY_MPI_TAG_SET_FILE_RANKS(Message*message);
 
 	void registerPlugin(ComputeCore*core);
 	void resolveSymbols(ComputeCore*core);
@@ -43,14 +43,17 @@ using namespace std;
 #include <math.h> /* for sqrt */
 #include <assert.h>
 #include <stdio.h> 
+#include <string.h> /* for strlen */
 
 __CreatePlugin(Scaffolder);
 
 __CreateMasterModeAdapter(Scaffolder,RAY_MASTER_MODE_WRITE_SCAFFOLDS);
 __CreateSlaveModeAdapter(Scaffolder,RAY_SLAVE_MODE_SCAFFOLDER);
+__CreateSlaveModeAdapter(Scaffolder,RAY_SLAVE_MODE_WRITE_SCAFFOLDS);
 
 __CreateMessageTagAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_CHUNK);
 __CreateMessageTagAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK);
+__CreateMessageTagAdapter(Scaffolder,RAY_MPI_TAG_SCAFFOLD_ENTRIES);
 
 // #define DEBUG_SCAFFOLDER_MESSAGES
 
@@ -383,6 +386,8 @@ void Scaffolder::constructor(StaticVector*outbox,StaticVector*inbox,RingAllocato
 	m_parameters=parameters;
 	m_initialised=false;
 	m_workerId=0;
+	m_writerInitialised=false;
+	m_localScaffoldOffset=0;
 
 	#ifdef CONFIG_ASSERT
 	assert(m_parameters!=NULL);
@@ -1446,7 +1451,7 @@ Case 16. (allowed)
 	}
 }
 
-void Scaffolder::getContigSequence(PathHandle id){
+void Scaffolder::getContigSequence(PathHandle id,int length){
 	int mode=0;
 	int CODE_PATH_VANILLA_KMERS=mode++;
 	int CODE_PATH_PACKED_REGION=mode++;
@@ -1455,18 +1460,18 @@ void Scaffolder::getContigSequence(PathHandle id){
 	int configuredCodePath=CODE_PATH_PACKED_REGION;
 
 	if(configuredCodePath==CODE_PATH_VANILLA_KMERS)
-		getContigSequenceFromKmers(id);
+		getContigSequenceFromKmers(id,length);
 	else if(configuredCodePath==CODE_PATH_PACKED_REGION){
-		getContigSequenceFromPackedObjects(id);
+		getContigSequenceFromPackedObjects(id,length);
 	}
 }
 
-void Scaffolder::getContigSequenceFromPackedObjects(PathHandle id){
+void Scaffolder::getContigSequenceFromPackedObjects(PathHandle id,int length){
 
 	if(!m_hasContigSequence_Initialised){
 		m_hasContigSequence_Initialised=true;
 		m_rankIdForContig=getRankFromPathUniqueId(id);
-		m_theLengthInNucleotides=getNumberOfNucleotides(m_contigLengths[id],m_parameters->getWordSize());
+		m_theLengthInNucleotides=getNumberOfNucleotides(length,m_parameters->getWordSize());
 		m_position=0;
 		m_requestedContigChunk=false;
 		m_contigPathBuffer.str("");
@@ -1544,12 +1549,12 @@ void Scaffolder::getContigSequenceFromPackedObjects(PathHandle id){
 	}
 }
 
-void Scaffolder::getContigSequenceFromKmers(PathHandle id){
+void Scaffolder::getContigSequenceFromKmers(PathHandle id,int length){
 
 	if(!m_hasContigSequence_Initialised){
 		m_hasContigSequence_Initialised=true;
 		m_rankIdForContig=getRankFromPathUniqueId(id);
-		m_theLength=m_contigLengths[id];
+		m_theLength=length;
 		m_position=0;
 		m_contigPath.clear();
 		m_contigPath.setKmerLength(m_parameters->getWordSize());
@@ -1594,41 +1599,274 @@ void Scaffolder::getContigSequenceFromKmers(PathHandle id){
 	}
 }
 
+/*
+ * Compute the position of each scaffold in Scaffolds.fasta.
+ *
+ * A scaffold is written as
+ *
+ * >scaffold-<name>
+ * <sequence with a new line every <columns> nucleotides>
+ *
+ * so its size in bytes is known from the lengths of its contigs and gaps.
+ * The scaffolds are then split in contiguous ranges with about the same
+ * number of bytes, one range per rank.
+ */
+void Scaffolder::computeScaffoldOffsets(){
+
+	int columns=m_parameters->getColumns();
+	int kmerLength=m_parameters->getWordSize();
+	int ranks=m_parameters->getSize();
+
+	m_scaffoldOffsets.clear();
+	m_scaffoldRanks.clear();
+
+	LargeCount offset=0;
+
+	for(int i=0;i<(int)m_scaffoldContigs.size();i++){
+
+		m_scaffoldOffsets.push_back(offset);
+
+		LargeCount length=0;
+
+		for(int j=0;j<(int)m_scaffoldContigs[i].size();j++){
+			length+=m_contigLengths[m_scaffoldContigs[i][j]]+kmerLength-1;
+
+			if(j!=(int)m_scaffoldContigs[i].size()-1 && m_scaffoldGaps[i][j]>0)
+				length+=m_scaffoldGaps[i][j];
+		}
+
+/* the header */
+		int digits=1;
+		for(int name=i;name>=10;name/=10)
+			digits++;
+
+		offset+=strlen(">scaffold-")+digits+1;
+
+/* the sequence, its new lines and the final new line */
+		if(length>0)
+			offset+=length+(length-1)/columns;
+
+		offset++;
+	}
+
+	LargeCount total=offset;
+
+	for(int i=0;i<(int)m_scaffoldOffsets.size();i++){
+		Rank rank=(m_scaffoldOffsets[i]*ranks)/total;
+
+		if(rank>=ranks)
+			rank=ranks-1;
+
+		m_scaffoldRanks.push_back(rank);
+	}
+}
+
+/*
+ * Send the next scaffolds of a rank.
+ *
+ * The first element is the offset of the first scaffold of the message,
+ * then each contig is
+ * <scaffold> <contig> <strand> <gap after the contig> <length in k-mers>
+ */
+void Scaffolder::sendScaffoldEntries(){
+
+	Rank destination=m_scaffoldRanks[m_entryScaffold];
+
+	MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
+	int maximumElements=MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit);
+	int elementsPerEntry=5;
+
+	int bufferPosition=0;
+	message[bufferPosition++]=m_scaffoldOffsets[m_entryScaffold];
+
+	while(m_entryScaffold<(int)m_scaffoldContigs.size()
+		&& m_scaffoldRanks[m_entryScaffold]==destination
+		&& bufferPosition+elementsPerEntry<=maximumElements){
+
+		PathHandle contig=m_scaffoldContigs[m_entryScaffold][m_entryContig];
+		bool isNotLastContig=m_entryContig<(int)m_scaffoldContigs[m_entryScaffold].size()-1;
+		int gap=0;
+
+		if(isNotLastContig)
+			gap=m_scaffoldGaps[m_entryScaffold][m_entryContig];
+
+		message[bufferPosition++]=m_entryScaffold;
+		message[bufferPosition++]=contig.getValue();
+		message[bufferPosition++]=m_scaffoldStrands[m_entryScaffold][m_entryContig];
+		message[bufferPosition++]=gap;
+		message[bufferPosition++]=m_contigLengths[contig];
+
+		m_entryContig++;
+
+		if(!isNotLastContig){
+			m_entryScaffold++;
+			m_entryContig=0;
+		}
+	}
+
+	Message aMessage(message,bufferPosition,destination,RAY_MPI_TAG_SCAFFOLD_ENTRIES,m_parameters->getRank());
+	m_outbox->push_back(&aMessage);
+}
+
+void Scaffolder::call_RAY_MPI_TAG_SCAFFOLD_ENTRIES(Message*message){
+
+	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
+	int count=message->getCount();
+	int position=0;
+
+	LargeCount offset=incoming[position++];
+
+	if(m_localScaffoldNames.size()==0)
+		m_localScaffoldOffset=offset;
+
+	while(position<count){
+		int scaffold=incoming[position++];
+		PathHandle contig=incoming[position++];
+		char strand=incoming[position++];
+		int gap=incoming[position++];
+		int length=incoming[position++];
+
+		if(m_localScaffoldNames.size()==0 || m_localScaffoldNames.back()!=scaffold){
+			m_localScaffoldNames.push_back(scaffold);
+			m_localScaffoldContigs.push_back(vector<PathHandle>());
+			m_localScaffoldStrands.push_back(vector<char>());
+			m_localScaffoldGaps.push_back(vector<int>());
+			m_localScaffoldLengths.push_back(vector<int>());
+		}
+
+		m_localScaffoldContigs.back().push_back(contig);
+		m_localScaffoldStrands.back().push_back(strand);
+		m_localScaffoldGaps.back().push_back(gap);
+		m_localScaffoldLengths.back().push_back(length);
+	}
+
+	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY,m_parameters->getRank());
+	m_outbox->push_back(&aMessage);
+}
+
+/*
+ * The master gives the scaffolds to the ranks and then
+ * every rank writes its scaffolds at their place in the file.
+ */
 void Scaffolder::call_RAY_MASTER_MODE_WRITE_SCAFFOLDS(){
 	if(!m_initialised){
 		m_initialised=true;
+
+		computeScaffoldOffsets();
+
+		m_entryScaffold=0;
+		m_entryContig=0;
+		m_entriesRequested=false;
+		m_startedWriters=false;
+
+/*
+ * Create the file before the ranks write in it.
+ */
+		string file=m_parameters->getScaffoldFile();
+		ofstream emptyFile(file.c_str());
+		emptyFile.close();
+
+	}else if(m_entriesRequested){
+		if(m_inbox->hasMessage(RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY))
+			m_entriesRequested=false;
+
+	}else if(m_entryScaffold<(int)m_scaffoldContigs.size()){
+		sendScaffoldEntries();
+		m_entriesRequested=true;
+
+	}else if(!m_startedWriters){
+		m_startedWriters=true;
+
+		m_switchMan->openMasterMode(m_outbox,m_parameters->getRank());
+
+	}else if(m_switchMan->allRanksAreReady()){
+
+		m_switchMan->closeMasterMode();
+
+		m_timePrinter->printElapsedTime("Scaffolding of contigs");
+	}
+}
+
+/*
+ * Append nucleotides to the current scaffold with a new line
+ * every <columns> nucleotides. There is no new line at the end
+ * unless more nucleotides follow.
+ */
+void Scaffolder::appendWithLineBreaks(const char*sequence,int length,bool moreAfter){
+
+	int columns=m_parameters->getColumns();
+	int position=0;
+
+	while(position<length){
+		int available=columns-m_positionOnScaffold%columns;
+		int count=length-position;
+
+		if(count>available)
+			count=available;
+
+		m_operationBuffer.write(sequence+position,count);
+		position+=count;
+		m_positionOnScaffold+=count;
+
+		if(m_positionOnScaffold%columns==0 && (position<length || moreAfter))
+			m_operationBuffer<<"\n";
+	}
+}
+
+void Scaffolder::call_RAY_SLAVE_MODE_WRITE_SCAFFOLDS(){
+	if(!m_writerInitialised){
+		m_writerInitialised=true;
 		m_scaffoldId=0;
 		m_contigId=0;
 		/* actually it is a position on the scaffold */
 		m_positionOnScaffold=0;
 		m_hasContigSequence=false;
 		m_hasContigSequence_Initialised=false;
-		string file=m_parameters->getScaffoldFile();
 
-		m_fp.open(file.c_str(),ios_base::out|ios_base::app);
+		if(m_localScaffoldNames.size()>0){
+			string file=m_parameters->getScaffoldFile();
+
+#ifdef CONFIG_MPI_IO
+			char*fileName=const_cast<char*> ( file.c_str() );
+			MPI_File_open(MPI_COMM_SELF,fileName,MPI_MODE_WRONLY,MPI_INFO_NULL,&m_mpiFile);
+
+			char representation[]="native";
+			MPI_Offset displacement=m_localScaffoldOffset;
+
+			int returnValue=MPI_File_set_view(m_mpiFile,displacement,MPI_BYTE,MPI_BYTE,representation,MPI_INFO_NULL);
+
+			if(returnValue!=MPI_SUCCESS){
+				cout<<"Error: can not create view."<<endl;
+			}
+#else
+			m_fp.open(file.c_str(),ios_base::in|ios_base::out|ios_base::binary);
+			m_fp.seekp(m_localScaffoldOffset);
+#endif
+		}
 	}
 
 	m_virtualCommunicator->forceFlush();
 	m_virtualCommunicator->processInbox(&m_activeWorkers);
 	m_activeWorkers.clear();
 
-	if(m_scaffoldId<(int)m_scaffoldContigs.size()){
-		if(m_contigId<(int)m_scaffoldContigs[m_scaffoldId].size()){
-			PathHandle contigNumber=m_scaffoldContigs[m_scaffoldId][m_contigId];
+	if(m_scaffoldId<(int)m_localScaffoldNames.size()){
+		if(m_contigId<(int)m_localScaffoldContigs[m_scaffoldId].size()){
+			PathHandle contigNumber=m_localScaffoldContigs[m_scaffoldId][m_contigId];
+			int contigLength=m_localScaffoldLengths[m_scaffoldId][m_contigId];
+
 			if(!m_hasContigSequence){
-		
+
 				// This sends messages
-				getContigSequence(contigNumber);
+				getContigSequence(contigNumber,contigLength);
 
 			}else{ /* at this point, m_contigSequence is filled. */
 				if(m_contigId==0){
 
-					m_operationBuffer<<">scaffold-"<<m_scaffoldId<<endl;
+					m_operationBuffer<<">scaffold-"<<m_localScaffoldNames[m_scaffoldId]<<"\n";
 					m_positionOnScaffold=0;
 				}
 
-				int contigPosition=0;
-				char strand=m_scaffoldStrands[m_scaffoldId][m_contigId];
+				char strand=m_localScaffoldStrands[m_scaffoldId][m_contigId];
 				if(strand=='R'){
 					m_contigSequence=reverseComplement(&m_contigSequence);
 				}
@@ -1636,62 +1874,32 @@ void Scaffolder::call_RAY_MASTER_MODE_WRITE_SCAFFOLDS(){
 				int length=m_contigSequence.length();
 
 				#ifdef CONFIG_ASSERT
-				int theLength=m_contigLengths[contigNumber]+m_parameters->getWordSize()-1;
+				int theLength=contigLength+m_parameters->getWordSize()-1;
 				assert(length==theLength);
 				#endif
 
-				int columns=m_parameters->getColumns();
-				ostringstream outputBuffer;
+				bool isNotLastContig = m_contigId<(int)m_localScaffoldContigs[m_scaffoldId].size()-1;
 
-				bool isNotLastContig = m_contigId<(int)m_scaffoldContigs[m_scaffoldId].size()-1;
-
-				while(contigPosition<length){
-					char nucleotide=m_contigSequence[contigPosition];
-					outputBuffer<<nucleotide;
-					contigPosition++;
-					m_positionOnScaffold++;
+				appendWithLineBreaks(m_contigSequence.c_str(),length,isNotLastContig);
 
 /*
- * Only add a new line if there is something more to add.
- */
-					if(m_positionOnScaffold%columns==0
-					&& ( contigPosition < length || isNotLastContig)){
-						outputBuffer<<"\n";
-					}
-				}
-				
-				m_operationBuffer<<outputBuffer.str().c_str();
-
-/*
- * Add the gap.
+ * Add the gap, it is always followed by a sequence.
  */
 				if(isNotLastContig){
-					int gapSize=m_scaffoldGaps[m_scaffoldId][m_contigId];
-					int i=0;
-					int columns=m_parameters->getColumns();
-					ostringstream outputBuffer2;
-					while(i<gapSize){
-						outputBuffer2<<"N";
-						i++;
-						m_positionOnScaffold++;
+					int gapSize=m_localScaffoldGaps[m_scaffoldId][m_contigId];
 
-/*
- * We always add the new line because a gap is always followed by 
- * a sequence.
- */
-						if(m_positionOnScaffold%columns==0){
-							outputBuffer2<<"\n";
-						}
+					if(gapSize>0){
+						string gap(gapSize,'N');
+						appendWithLineBreaks(gap.c_str(),gapSize,true);
 					}
-
-					m_operationBuffer<<outputBuffer2.str().c_str();
 				}
+
 				m_contigId++;
 				m_hasContigSequence=false;
 				m_hasContigSequence_Initialised=false;
 			}
 		}else{
-			m_operationBuffer<<endl;
+			m_operationBuffer<<"\n";
 
 			m_scaffoldId++;
 			m_contigId=0;
@@ -1700,17 +1908,32 @@ void Scaffolder::call_RAY_MASTER_MODE_WRITE_SCAFFOLDS(){
 			m_hasContigSequence_Initialised=false;
 		}
 
-
+#ifdef CONFIG_MPI_IO
+		flushFileOperationBuffer_MPI_IO(false,&m_operationBuffer,m_mpiFile,CONFIG_FILE_IO_BUFFER_SIZE);
+#else
 		flushFileOperationBuffer(false,&m_operationBuffer,&m_fp,CONFIG_FILE_IO_BUFFER_SIZE);
+#endif
 	}else{
 
-		flushFileOperationBuffer(true,&m_operationBuffer,&m_fp,CONFIG_FILE_IO_BUFFER_SIZE);
-	
-		m_fp.close();
+		if(m_localScaffoldNames.size()>0){
+#ifdef CONFIG_MPI_IO
+			flushFileOperationBuffer_MPI_IO(true,&m_operationBuffer,m_mpiFile,CONFIG_FILE_IO_BUFFER_SIZE);
+			MPI_File_close(&m_mpiFile);
+#else
+			flushFileOperationBuffer(true,&m_operationBuffer,&m_fp,CONFIG_FILE_IO_BUFFER_SIZE);
+			m_fp.close();
+#endif
+		}
 
-		m_switchMan->closeMasterMode();
+		cout<<"Rank "<<m_parameters->getRank()<<" wrote "<<m_localScaffoldNames.size()<<" scaffolds"<<endl;
 
-		m_timePrinter->printElapsedTime("Scaffolding of contigs");
+		m_localScaffoldNames.clear();
+		m_localScaffoldContigs.clear();
+		m_localScaffoldStrands.clear();
+		m_localScaffoldGaps.clear();
+		m_localScaffoldLengths.clear();
+
+		m_switchMan->closeSlaveModeLocally(m_outbox,m_parameters->getRank());
 	}
 }
 
@@ -1878,6 +2101,10 @@ void Scaffolder::registerPlugin(ComputeCore*core){
 	core->setSlaveModeObjectHandler(plugin,RAY_SLAVE_MODE_SCAFFOLDER, __GetAdapter(Scaffolder,RAY_SLAVE_MODE_SCAFFOLDER));
 	core->setSlaveModeSymbol(plugin,RAY_SLAVE_MODE_SCAFFOLDER,"RAY_SLAVE_MODE_SCAFFOLDER");
 
+	RAY_SLAVE_MODE_WRITE_SCAFFOLDS=core->allocateSlaveModeHandle(plugin);
+	core->setSlaveModeObjectHandler(plugin,RAY_SLAVE_MODE_WRITE_SCAFFOLDS, __GetAdapter(Scaffolder,RAY_SLAVE_MODE_WRITE_SCAFFOLDS));
+	core->setSlaveModeSymbol(plugin,RAY_SLAVE_MODE_WRITE_SCAFFOLDS,"RAY_SLAVE_MODE_WRITE_SCAFFOLDS");
+
 	RAY_MASTER_MODE_WRITE_SCAFFOLDS=core->allocateMasterModeHandle(plugin);
 	core->setMasterModeObjectHandler(plugin,RAY_MASTER_MODE_WRITE_SCAFFOLDS, __GetAdapter(Scaffolder,RAY_MASTER_MODE_WRITE_SCAFFOLDS));
 	core->setMasterModeSymbol(plugin,RAY_MASTER_MODE_WRITE_SCAFFOLDS,"RAY_MASTER_MODE_WRITE_SCAFFOLDS");
@@ -1900,11 +2127,22 @@ void Scaffolder::registerPlugin(ComputeCore*core){
 	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_GET_CONTIG_CHUNK_REPLY,"RAY_MPI_TAG_GET_CONTIG_CHUNK_REPLY");
 	RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK_REPLY=core->allocateMessageTagHandle(plugin);
 	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK_REPLY,"RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK_REPLY");
+
+	RAY_MPI_TAG_SCAFFOLD_ENTRIES=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagObjectHandler(plugin,RAY_MPI_TAG_SCAFFOLD_ENTRIES, __GetAdapter(Scaffolder,RAY_MPI_TAG_SCAFFOLD_ENTRIES));
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SCAFFOLD_ENTRIES,"RAY_MPI_TAG_SCAFFOLD_ENTRIES");
+
+	RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY,"RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY");
+
+	RAY_MPI_TAG_WRITE_SCAFFOLDS=core->allocateMessageTagHandle(plugin);
+	core->setMessageTagSymbol(plugin,RAY_MPI_TAG_WRITE_SCAFFOLDS,"RAY_MPI_TAG_WRITE_SCAFFOLDS");
 }
 
 void Scaffolder::resolveSymbols(ComputeCore*core){
 	RAY_SLAVE_MODE_SCAFFOLDER=core->getSlaveModeFromSymbol(m_plugin,"RAY_SLAVE_MODE_SCAFFOLDER");
 	RAY_SLAVE_MODE_DO_NOTHING=core->getSlaveModeFromSymbol(m_plugin,"RAY_SLAVE_MODE_DO_NOTHING");
+	RAY_SLAVE_MODE_WRITE_SCAFFOLDS=core->getSlaveModeFromSymbol(m_plugin,"RAY_SLAVE_MODE_WRITE_SCAFFOLDS");
 
 	RAY_MASTER_MODE_WRITE_SCAFFOLDS=core->getMasterModeFromSymbol(m_plugin,"RAY_MASTER_MODE_WRITE_SCAFFOLDS");
 	RAY_MASTER_MODE_CONTIG_BIOLOGICAL_ABUNDANCES=core->getMasterModeFromSymbol(m_plugin,"RAY_MASTER_MODE_CONTIG_BIOLOGICAL_ABUNDANCES");
@@ -1932,7 +2170,13 @@ void Scaffolder::resolveSymbols(ComputeCore*core){
 	RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK");
 	RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK_REPLY");
 
+	RAY_MPI_TAG_SCAFFOLD_ENTRIES=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SCAFFOLD_ENTRIES");
+	RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY");
+	RAY_MPI_TAG_WRITE_SCAFFOLDS=core->getMessageTagFromSymbol(m_plugin,"RAY_MPI_TAG_WRITE_SCAFFOLDS");
+
 	core->setMessageTagToSlaveModeSwitch(m_plugin, RAY_MPI_TAG_START_SCAFFOLDER,             RAY_SLAVE_MODE_SCAFFOLDER );
+	core->setMessageTagToSlaveModeSwitch(m_plugin, RAY_MPI_TAG_WRITE_SCAFFOLDS,             RAY_SLAVE_MODE_WRITE_SCAFFOLDS );
+	core->setMasterModeToMessageTagSwitch(m_plugin, RAY_MASTER_MODE_WRITE_SCAFFOLDS, RAY_MPI_TAG_WRITE_SCAFFOLDS);
 
 	core->setMasterModeNextMasterMode(m_plugin,RAY_MASTER_MODE_WRITE_SCAFFOLDS, RAY_MASTER_MODE_COUNT_SEARCH_ELEMENTS);
 
@@ -1948,6 +2192,8 @@ void Scaffolder::resolveSymbols(ComputeCore*core){
 
 	__BindAdapter(Scaffolder,RAY_MASTER_MODE_WRITE_SCAFFOLDS);
 	__BindAdapter(Scaffolder,RAY_SLAVE_MODE_SCAFFOLDER);
+	__BindAdapter(Scaffolder,RAY_SLAVE_MODE_WRITE_SCAFFOLDS);
+	__BindAdapter(Scaffolder,RAY_MPI_TAG_SCAFFOLD_ENTRIES);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_GET_CONTIG_CHUNK);
 	__BindAdapter(MessageProcessor,RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK);
 
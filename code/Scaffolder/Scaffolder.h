@@ -47,8 +47,10 @@ __DeclarePlugin(Scaffolder);
 
 __DeclareMasterModeAdapter(Scaffolder,RAY_MASTER_MODE_WRITE_SCAFFOLDS);
 __DeclareSlaveModeAdapter(Scaffolder,RAY_SLAVE_MODE_SCAFFOLDER);
+__DeclareSlaveModeAdapter(Scaffolder,RAY_SLAVE_MODE_WRITE_SCAFFOLDS);
 __DeclareMessageTagAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_CHUNK);
 __DeclareMessageTagAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK);
+__DeclareMessageTagAdapter(Scaffolder,RAY_MPI_TAG_SCAFFOLD_ENTRIES);
 
 /**
  * Scaffolder class, it uses MPI through the virtual communicator.
@@ -59,8 +61,10 @@ class Scaffolder :  public CorePlugin{
 
 	__AddAdapter(Scaffolder,RAY_MASTER_MODE_WRITE_SCAFFOLDS);
 	__AddAdapter(Scaffolder,RAY_SLAVE_MODE_SCAFFOLDER);
+	__AddAdapter(Scaffolder,RAY_SLAVE_MODE_WRITE_SCAFFOLDS);
 	__AddAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_CHUNK);
 	__AddAdapter(Scaffolder,RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK);
+	__AddAdapter(Scaffolder,RAY_MPI_TAG_SCAFFOLD_ENTRIES);
 
 	ostringstream m_operationBuffer;
 
@@ -81,6 +85,9 @@ class Scaffolder :  public CorePlugin{
 	MessageTag RAY_MPI_TAG_HAS_PAIRED_READ;
 	MessageTag RAY_MPI_TAG_I_FINISHED_SCAFFOLDING;
 	MessageTag RAY_MPI_TAG_SCAFFOLDING_LINKS;
+	MessageTag RAY_MPI_TAG_SCAFFOLD_ENTRIES;
+	MessageTag RAY_MPI_TAG_SCAFFOLD_ENTRIES_REPLY;
+	MessageTag RAY_MPI_TAG_WRITE_SCAFFOLDS;
 
 	MasterMode RAY_MASTER_MODE_WRITE_SCAFFOLDS;
 	MasterMode RAY_MASTER_MODE_CONTIG_BIOLOGICAL_ABUNDANCES;
@@ -88,6 +95,7 @@ class Scaffolder :  public CorePlugin{
 
 	SlaveMode RAY_SLAVE_MODE_DO_NOTHING;
 	SlaveMode RAY_SLAVE_MODE_SCAFFOLDER;
+	SlaveMode RAY_SLAVE_MODE_WRITE_SCAFFOLDS;
 
 	bool m_coverageWasComputedWithJustice;
 	int m_skippedRepeatedObjects;
@@ -103,7 +111,11 @@ class Scaffolder :  public CorePlugin{
 
 	int m_rankIdForContig;
 	bool m_hasContigSequence_Initialised;
-	ofstream m_fp;
+#ifdef CONFIG_MPI_IO
+	MPI_File m_mpiFile;
+#else
+	fstream m_fp;
+#endif
 	bool m_hasContigSequence;
 	string m_contigSequence;
 	map<PathHandle,int> m_contigLengths;
@@ -126,6 +138,30 @@ class Scaffolder :  public CorePlugin{
 	vector<vector<char> >m_scaffoldStrands;
 	vector<vector<int> >m_scaffoldGaps;
 
+/*
+ * Scaffolds.fasta is written by all the ranks.
+ * The master computes the size in bytes of each scaffold and gives
+ * a contiguous range of scaffolds to each rank.
+ */
+	vector<LargeCount> m_scaffoldOffsets;
+	vector<Rank> m_scaffoldRanks;
+
+	int m_entryScaffold;
+	int m_entryContig;
+	bool m_entriesRequested;
+	bool m_startedWriters;
+
+/*
+ * The scaffolds given to this rank.
+ */
+	vector<int> m_localScaffoldNames;
+	vector<vector<PathHandle> > m_localScaffoldContigs;
+	vector<vector<char> > m_localScaffoldStrands;
+	vector<vector<int> > m_localScaffoldGaps;
+	vector<vector<int> > m_localScaffoldLengths;
+	LargeCount m_localScaffoldOffset;
+	bool m_writerInitialised;
+
 	bool m_sentContigInfo;
 	bool m_sentContigMeta;
 	vector<PathHandle> m_masterContigs;
@@ -201,9 +237,12 @@ class Scaffolder :  public CorePlugin{
 
 	map<PathHandle,int>*m_contigNameIndex;
 
-	void getContigSequence(PathHandle id);
-	void getContigSequenceFromKmers(PathHandle id);
-	void getContigSequenceFromPackedObjects(PathHandle id);
+	void getContigSequence(PathHandle id,int length);
+	void getContigSequenceFromKmers(PathHandle id,int length);
+	void getContigSequenceFromPackedObjects(PathHandle id,int length);
+	void computeScaffoldOffsets();
+	void sendScaffoldEntries();
+	void appendWithLineBreaks(const char*sequence,int length,bool moreAfter);
 	void processContig();
 	void processContigPosition();
 	void processVertex(Kmer*vertex);
@@ -251,9 +290,11 @@ public:
 	void call_RAY_MASTER_MODE_WRITE_SCAFFOLDS();
 
 	void call_RAY_SLAVE_MODE_SCAFFOLDER();
+	void call_RAY_SLAVE_MODE_WRITE_SCAFFOLDS();
 
 	void call_RAY_MPI_TAG_GET_CONTIG_CHUNK(Message*message);
 	void call_RAY_MPI_TAG_GET_CONTIG_PACKED_CHUNK(Message*message);
+	void call_RAY_MPI_TAG_SCAFFOLD_ENTRIES(Message*message);
 
 	void printFinalMessage();
 
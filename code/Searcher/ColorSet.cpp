@@ -27,6 +27,7 @@
 #include <RayPlatform/cryptography/crypto.h>
 
 #include <stdint.h>
+#include <algorithm>
 #include <iostream>
 using namespace std;
 
@@ -70,6 +71,10 @@ ColorSet::ColorSet(){
 	}
 
 	m_collisions=0;
+
+	m_indexEntries=0;
+	m_indexDeletedSlots=0;
+	m_indexSlots.resize(COLOR_INDEX_INITIAL_SLOTS,NULL_VIRTUAL_COLOR);
 }
 
 /** O(1) **/
@@ -85,16 +90,12 @@ void ColorSet::incrementReferences(VirtualKmerColorHandle handle){
 
 	VirtualKmerColor*virtualColor=getVirtualColor(handle);
 
-	// it is no longer available...
-	// because we will increment the references
-	if(virtualColor->getNumberOfReferences()==0){
-		m_availableHandles.erase(handle);
-	}
+	// the handle is no longer available since it
+	// was allocated
 
 	virtualColor->incrementReferences();
 
 	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.count(handle)==0);
 	assert(getVirtualColor(handle)->getNumberOfReferences()>=1);
 	#endif
 
@@ -113,7 +114,6 @@ void ColorSet::decrementReferences(VirtualKmerColorHandle handle){
 		return;
 
 	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.count(handle)==0);
 	assert(virtualColor->getNumberOfReferences()>0);
 	#endif
 
@@ -146,18 +146,13 @@ void ColorSet::purgeVirtualColor(VirtualKmerColorHandle handle){
 	// actually, they are simply not removed.
 	// instead, they are re-used.
 
-	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.count(handle)==0);
-	#endif
-
-	m_availableHandles.insert(handle);
+	m_availableHandles.push_back(handle);
 
 	// but we don't remove it from the hash table
 	// because it may be useful sometime
 	// correction: we do remove it right now.
 
 	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.count(handle)>0);
 	assert(virtualColorToPurge->getNumberOfPhysicalColors()==0);
 	assert(virtualColorToPurge->getNumberOfReferences()==0);
 	#endif
@@ -193,7 +188,7 @@ void ColorSet::printSummary(ostream*out,bool xml){
 	(*out)<<"  Number of virtual colors: "<<getTotalNumberOfVirtualColors()<<endl;
 	(*out)<<"  Number of real colors: "<<getTotalNumberOfPhysicalColors()<<endl;
 	(*out)<<endl;
-	(*out)<<"Keys in index: "<<m_index.size()<<endl;
+	(*out)<<"Keys in index: "<<m_indexEntries<<" (slots: "<<m_indexSlots.size()<<")"<<endl;
 	(*out)<<"Observed collisions when populating the index: "<<m_collisions<<endl;
 	(*out)<<"COLOR_NAMESPACE_MULTIPLIER= "<<COLOR_NAMESPACE_MULTIPLIER<<endl;
 	(*out)<<endl;
@@ -239,7 +234,7 @@ void ColorSet::printSummary(ostream*out,bool xml){
 
 		referenceFrequencies[references]++;
 
-		set<PhysicalKmerColor>*colors=getVirtualColor(i)->getPhysicalColors();
+		vector<PhysicalKmerColor>*colors=getVirtualColor(i)->getPhysicalColors();
 
 		colorFrequencies[colors->size()]++;
 	}
@@ -277,12 +272,12 @@ void ColorSet::printColors(ostream*out){
 		LargeCount references=getVirtualColor(i)->getNumberOfReferences();
 		(*out)<<" References: "<<references<<endl;
 
-		set<PhysicalKmerColor>*colors=getVirtualColor(i)->getPhysicalColors();
+		vector<PhysicalKmerColor>*colors=getVirtualColor(i)->getPhysicalColors();
 		(*out)<<" Number of physical colors: "<<colors->size()<<endl;
 		(*out)<<" Physical colors: "<<endl;
 		(*out)<<"  ";
 		
-		for(set<PhysicalKmerColor>::iterator j=colors->begin();j!=colors->end();j++){
+		for(vector<PhysicalKmerColor>::iterator j=colors->begin();j!=colors->end();j++){
 			(*out)<<" "<<*j;
 		}
 		(*out)<<endl;
@@ -302,11 +297,10 @@ VirtualKmerColorHandle ColorSet::allocateVirtualColorHandle(){
 
 	if(m_availableHandles.size()>0){
 
-		VirtualKmerColorHandle handle= *(m_availableHandles.begin());
+		VirtualKmerColorHandle handle=m_availableHandles.back();
 
-		// we don't remove it here from the available list.
-		// instead, it will be removed from the avaialble list
-		// when its references are > 0
+		// the handle is consumed right away
+		m_availableHandles.pop_back();
 	
 		#ifdef CONFIG_ASSERT
 		assert(getVirtualColor(handle)->getNumberOfReferences()==0);
@@ -320,23 +314,12 @@ VirtualKmerColorHandle ColorSet::allocateVirtualColorHandle(){
 		return handle;
 	}
 
-	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.size()==0);
-	#endif
-
 	// otherwise, create a new one
 	
 	VirtualKmerColorHandle handle=createVirtualColorHandleFromScratch();
 
-	// add it in the available list since it has 0 references
-	m_availableHandles.insert(handle);
-
 	m_operations[OPERATION_NEW_FROM_SCRATCH]++;
 
-	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.size()==1);
-	#endif
-
 	return handle;
 }
 
@@ -401,7 +384,7 @@ VirtualKmerColorHandle ColorSet::getVirtualColorFrom(VirtualKmerColorHandle hand
 	// on second thought, it is better to decrement after
 	// because all this code is designed like this
 	//
-	assert(m_availableHandles.count(handle)==0);
+	assert(handle==NULL_VIRTUAL_COLOR || getVirtualColor(handle)->getNumberOfReferences()>0);
 
 	#endif
 
@@ -422,8 +405,48 @@ VirtualKmerColorHandle ColorSet::getVirtualColorFrom(VirtualKmerColorHandle hand
 	
 	uint64_t expectedHash=applyHashOperation(oldHash,color);
 
+	// for each of the hits
+	// check if they have all the required colors
+	// if so, return it
+	
+	bool hasExpectedHash=false;
+
+	uint64_t mask=m_indexSlots.size()-1;
+
+	// case 4. a virtual color has:
+	// (1) the color, 
+	// (2) the correct number of physical colors,
+	// (3) the expected hash value
+	//
+	// check it out
+	for(uint64_t slot=getIndexSlot(expectedHash);m_indexSlots[slot]!=NULL_VIRTUAL_COLOR;
+		slot=(slot+1)&mask){
+
+		VirtualKmerColorHandle virtualColorToInvestigate=m_indexSlots[slot];
+
+		if(virtualColorToInvestigate==COLOR_INDEX_DELETED_SLOT)
+			continue;
+		
+		VirtualKmerColor*toCheck=getVirtualColor(virtualColorToInvestigate);
+
+		if(toCheck->getCachedHashValue()!=expectedHash)
+			continue;
+
+		hasExpectedHash=true;
+
+		if(toCheck->virtualColorHasAllPhysicalColorsOf(oldVirtualColor,color)){
+
+			#ifdef CONFIG_ASSERT
+			assert(virtualColorHasPhysicalColor(virtualColorToInvestigate,color));
+			#endif /* ASSERT */
+	
+			m_operations[OPERATION_VIRTUAL_COLOR_HAS_COLORS_FETCH]++;
+			return virtualColorToInvestigate;
+		}
+	}
+
 	// case 3. no virtual color has the expected hash value
-	if(m_index.count(expectedHash) == 0){
+	if(!hasExpectedHash){
 
 		// case X.: the virtual color has only one reference
 		// this reference is the one provided in input
@@ -452,14 +475,11 @@ VirtualKmerColorHandle ColorSet::getVirtualColorFrom(VirtualKmerColorHandle hand
 			return handle;
 		}
 
-
 		// at this point
 		// at least one virtual color has the color and the correct number
 		// of colors
 		// however, none of them have a matching hash
 	
-		//cout<<" No one has has value= "<<expectedHash<<endl;
-
 		m_operations[OPERATION_NO_VIRTUAL_COLOR_HAS_HASH_CREATION]++;
 
 		#ifdef CONFIG_ASSERT_LOW_LEVEL
@@ -469,43 +489,6 @@ VirtualKmerColorHandle ColorSet::getVirtualColorFrom(VirtualKmerColorHandle hand
 		return createVirtualColorFrom(handle,color);
 	}
 
-	#ifdef CONFIG_ASSERT
-	assert(m_index.count(expectedHash)>0);
-	assert(m_index[expectedHash].size()>=1);
-	#endif /* ASSERT */
-
-	// for each of the hits
-	// check if they have all the required colors
-	// if so, return it
-	
-	set<VirtualKmerColorHandle>*hits=&(m_index[expectedHash]);
-
-	//cout<<"hits "<<hits->size()<<endl;
-
-	// case 4. a virtual color has:
-	// (1) the color, 
-	// (2) the correct number of physical colors,
-	// (3) the expected hash value
-	//
-	// check it out
-	for(set<VirtualKmerColorHandle>::iterator i=hits->begin();i!=hits->end();i++){
-		VirtualKmerColorHandle virtualColorToInvestigate=*i;
-		
-		VirtualKmerColor*toCheck=getVirtualColor(virtualColorToInvestigate);
-
-		//cout<<"Checking virtual color "<<virtualColorToInvestigate<<endl;
-
-		if(toCheck->virtualColorHasAllPhysicalColorsOf(oldVirtualColor,color)){
-
-			#ifdef CONFIG_ASSERT
-			assert(virtualColorHasPhysicalColor(virtualColorToInvestigate,color));
-			#endif /* ASSERT */
-	
-			m_operations[OPERATION_VIRTUAL_COLOR_HAS_COLORS_FETCH]++;
-			return virtualColorToInvestigate;
-		}
-	}
-
 	// at this point, we know for sure that no virtual color matches
 	
 	// case 5. no virtual color has all the required colors
@@ -523,12 +506,8 @@ VirtualKmerColorHandle ColorSet::createVirtualColorFrom(VirtualKmerColorHandle h
 
 	VirtualKmerColorHandle newHandle=allocateVirtualColorHandle();
 
-	// consume the handle
-	m_availableHandles.erase(newHandle);
-
 	#ifdef CONFIG_ASSERT
 	assert(!getVirtualColor(handle)->hasPhysicalColor(color));
-	assert(m_availableHandles.count(newHandle)==0);
 	assert(getNumberOfReferences(newHandle)==0);
 	assert(getNumberOfPhysicalColors(newHandle)==0);
 	#endif /* ASSERT */
@@ -559,7 +538,7 @@ VirtualKmerColorHandle ColorSet::createVirtualColorFrom(VirtualKmerColorHandle h
 	return newHandle;
 }
 
-set<PhysicalKmerColor>*ColorSet::getPhysicalColors(VirtualKmerColorHandle handle){
+vector<PhysicalKmerColor>*ColorSet::getPhysicalColors(VirtualKmerColorHandle handle){
 	return getVirtualColor(handle)->getPhysicalColors();
 }
 
@@ -567,25 +546,99 @@ bool ColorSet::virtualColorHasPhysicalColor(VirtualKmerColorHandle handle,Physic
 	return getVirtualColor(handle)->hasPhysicalColor(color);
 }
 
+uint64_t ColorSet::getIndexSlot(uint64_t hashValue){
+
+	// the hash values are sums of powers, so they are mixed
+	// before taking the low bits
+	return uniform_hashing_function_1_64_64(hashValue)&(m_indexSlots.size()-1);
+}
+
 void ColorSet::removeVirtualColorFromIndex(VirtualKmerColorHandle handle){
 
 	VirtualKmerColor*virtualColor=getVirtualColor(handle);
 
 	uint64_t hashValue=virtualColor->getCachedHashValue();
 
-	m_index[hashValue].erase(handle);
+	uint64_t mask=m_indexSlots.size()-1;
+
+	for(uint64_t slot=getIndexSlot(hashValue);m_indexSlots[slot]!=NULL_VIRTUAL_COLOR;
+		slot=(slot+1)&mask){
+
+		if(m_indexSlots[slot]==handle){
+			m_indexSlots[slot]=COLOR_INDEX_DELETED_SLOT;
+			m_indexEntries--;
+			m_indexDeletedSlots++;
+			return;
+		}
+	}
 
-	if(m_index[hashValue].size()==0)
-		m_index.erase(hashValue);
+	#ifdef CONFIG_ASSERT
+	assert(false);
+	#endif
 }
 
 void ColorSet::addVirtualColorToIndex(VirtualKmerColorHandle handle){
 
+	#ifdef CONFIG_ASSERT
+	assert(handle!=NULL_VIRTUAL_COLOR);
+	#endif
+
+	// keep at least 1/4 of the slots empty
+	if((m_indexEntries+m_indexDeletedSlots+1)*4>m_indexSlots.size()*3){
+
+		LargeCount slots=m_indexSlots.size();
+
+		// if there are mostly deleted slots, the size stays the same
+		if((m_indexEntries+1)*2>slots)
+			slots*=2;
+
+		resizeIndex(slots);
+	}
+
 	VirtualKmerColor*virtualColor=getVirtualColor(handle);
 
 	uint64_t hashValue=virtualColor->getCachedHashValue();
 
-	m_index[hashValue].insert(handle);
+	uint64_t mask=m_indexSlots.size()-1;
+	uint64_t slot=getIndexSlot(hashValue);
+
+	while(m_indexSlots[slot]!=NULL_VIRTUAL_COLOR && m_indexSlots[slot]!=COLOR_INDEX_DELETED_SLOT){
+		slot=(slot+1)&mask;
+		m_collisions++;
+	}
+
+	if(m_indexSlots[slot]==COLOR_INDEX_DELETED_SLOT)
+		m_indexDeletedSlots--;
+
+	m_indexSlots[slot]=handle;
+	m_indexEntries++;
+}
+
+void ColorSet::resizeIndex(LargeCount slots){
+
+	vector<VirtualKmerColorHandle> oldSlots;
+	oldSlots.swap(m_indexSlots);
+
+	m_indexSlots.resize(slots,NULL_VIRTUAL_COLOR);
+	m_indexEntries=0;
+	m_indexDeletedSlots=0;
+
+	uint64_t mask=m_indexSlots.size()-1;
+
+	for(int i=0;i<(int)oldSlots.size();i++){
+		VirtualKmerColorHandle handle=oldSlots[i];
+
+		if(handle==NULL_VIRTUAL_COLOR || handle==COLOR_INDEX_DELETED_SLOT)
+			continue;
+
+		uint64_t slot=getIndexSlot(getVirtualColor(handle)->getCachedHashValue());
+
+		while(m_indexSlots[slot]!=NULL_VIRTUAL_COLOR)
+			slot=(slot+1)&mask;
+
+		m_indexSlots[slot]=handle;
+		m_indexEntries++;
+	}
 }
 
 VirtualKmerColorHandle ColorSet::createVirtualColorHandleFromScratch(){
@@ -599,12 +652,8 @@ VirtualKmerColorHandle ColorSet::createVirtualColorHandleFromScratch(){
 }
 
 void ColorSet::assertNoVirtualColorDuplicates(VirtualKmerColorHandle handle,PhysicalKmerColor color,int caseX){
-	set<PhysicalKmerColor> desiredColors;
-	set<PhysicalKmerColor>*colors3=getVirtualColor(handle)->getPhysicalColors();
-	for(set<PhysicalKmerColor>::iterator i=colors3->begin();i!=colors3->end();i++){
-		desiredColors.insert(*i);
-	}
-	desiredColors.insert(color);
+	vector<PhysicalKmerColor> desiredColors=*(getVirtualColor(handle)->getPhysicalColors());
+	desiredColors.insert(lower_bound(desiredColors.begin(),desiredColors.end(),color),color);
 
 	for(int i=0;i<(int)getTotalNumberOfVirtualColors();i++){
 		if(getVirtualColor(i)->getNumberOfPhysicalColors()==(int)desiredColors.size()){
@@ -629,9 +678,9 @@ void ColorSet::assertNoVirtualColorDuplicates(VirtualKmerColorHandle handle,Phys
 		
 }
 
-void ColorSet::printPhysicalColors(set<PhysicalKmerColor>*colors3){
+void ColorSet::printPhysicalColors(vector<PhysicalKmerColor>*colors3){
 
-	for(set<PhysicalKmerColor>::iterator i=colors3->begin();i!=colors3->end();i++){
+	for(vector<PhysicalKmerColor>::iterator i=colors3->begin();i!=colors3->end();i++){
 		cout<<" "<<*i;
 	}
 	cout<<endl;
@@ -667,12 +716,6 @@ VirtualKmerColorHandle ColorSet::createVirtualColorFromPhysicalColors(set<Physic
 
 	VirtualKmerColorHandle newHandle=allocateVirtualColorHandle();
 
-	#ifdef CONFIG_ASSERT
-	assert(m_availableHandles.count(newHandle)>0);
-	#endif /* ASSERT */
-
-	m_availableHandles.erase(newHandle);
-
 	VirtualKmerColor*newVirtualColor=getVirtualColor(newHandle);
 
 	newVirtualColor->addPhysicalColors(colors);
@@ -691,32 +734,37 @@ VirtualKmerColorHandle ColorSet::createVirtualColorFromPhysicalColors(set<Physic
 VirtualKmerColorHandle ColorSet::lookupVirtualColor(set<PhysicalKmerColor>*colors){
 	uint64_t expectedHash=getHash(colors);
 
-	if(m_index.count(expectedHash)>0){
-		set<VirtualKmerColorHandle>*hits=&(m_index[expectedHash]);
+	uint64_t mask=m_indexSlots.size()-1;
 
-		for(set<VirtualKmerColorHandle>::iterator i=hits->begin();i!=hits->end();i++){
+	for(uint64_t slot=getIndexSlot(expectedHash);m_indexSlots[slot]!=NULL_VIRTUAL_COLOR;
+		slot=(slot+1)&mask){
 
-			VirtualKmerColorHandle virtualColorToInvestigate=*i;
+		VirtualKmerColorHandle virtualColorToInvestigate=m_indexSlots[slot];
+
+		if(virtualColorToInvestigate==COLOR_INDEX_DELETED_SLOT)
+			continue;
 		
-			VirtualKmerColor*toCheck=getVirtualColor(virtualColorToInvestigate);
+		VirtualKmerColor*toCheck=getVirtualColor(virtualColorToInvestigate);
+
+		if(toCheck->getCachedHashValue()!=expectedHash)
+			continue;
 
 /*
  * We need the same number of physical colors.
  */
-			if((int)colors->size()!=toCheck->getNumberOfPhysicalColors())
-				continue;
+		if((int)colors->size()!=toCheck->getNumberOfPhysicalColors())
+			continue;
 
 /*
  * Each physical color must match 
  */
-			if(!toCheck->hasPhysicalColors(colors))
-				continue;
+		if(!toCheck->hasPhysicalColors(colors))
+			continue;
 
 /*
  * The matching virtual color was found.
  */
-			return virtualColorToInvestigate;
-		}
+		return virtualColorToInvestigate;
 	}
 
 	return NULL_VIRTUAL_COLOR;
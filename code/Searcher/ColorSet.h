@@ -47,11 +47,21 @@ using namespace std;
 
 typedef uint32_t VirtualKmerColorHandle;
 
+/** a slot of the index that had a virtual color **/
+#define COLOR_INDEX_DELETED_SLOT ((VirtualKmerColorHandle)-1)
+
+/** initial number of slots in the index, a power of 2 **/
+#define COLOR_INDEX_INITIAL_SLOTS 1024
+
 /** This class is a translation table for
  * allocated virtual colors. 
  *
  * This is the Flyweight design pattern.
  *
+ * Virtual colors are found by the hash of their physical colors with
+ * an open-addressing table (linear probing) of handles. The handle 0
+ * (NULL_VIRTUAL_COLOR) is never in the table, so it marks empty slots.
+ *
  * \author: Sébastien Boisvert
  *
  * Frédéric Raymond proposed the idea of using color namespaces.
@@ -78,8 +88,8 @@ class ColorSet{
 
 	LargeCount m_operations[32];
 
-/** a list of available handles **/
-	set<VirtualKmerColorHandle> m_availableHandles;
+/** a stack of available handles **/
+	vector<VirtualKmerColorHandle> m_availableHandles;
 
 /** the table of virtual colors **/
 	vector<VirtualKmerColor> m_virtualColors;
@@ -87,10 +97,16 @@ class ColorSet{
 /** a list of physical colors **/
 	set<PhysicalKmerColor> m_physicalColors;
 
-	map<LargeIndex,set<VirtualKmerColorHandle> > m_index;
+/** the index: hash value -> handles **/
+	vector<VirtualKmerColorHandle> m_indexSlots;
+	LargeCount m_indexEntries;
+	LargeCount m_indexDeletedSlots;
 
 	LargeCount m_collisions;
 
+	uint64_t getIndexSlot(uint64_t hashValue);
+	void resizeIndex(LargeCount slots);
+
 
 
 /** get the hash value for a set of colors **/
@@ -117,7 +133,7 @@ class ColorSet{
 
 	void assertNoVirtualColorDuplicates(VirtualKmerColorHandle handle,PhysicalKmerColor color,int id);
 
-	void printPhysicalColors(set<PhysicalKmerColor>*colors);
+	void printPhysicalColors(vector<PhysicalKmerColor>*colors);
 	VirtualKmerColorHandle lookupVirtualColor(set<PhysicalKmerColor>*colors);
 	VirtualKmerColorHandle createVirtualColorFromPhysicalColors(set<PhysicalKmerColor>*colors);
 public:
@@ -142,7 +158,7 @@ public:
 	void printSummary(ostream*out,bool xml);
 	void printColors(ostream*out);
 
-	set<PhysicalKmerColor>*getPhysicalColors(VirtualKmerColorHandle handle);
+	vector<PhysicalKmerColor>*getPhysicalColors(VirtualKmerColorHandle handle);
 
 	bool virtualColorHasPhysicalColor(VirtualKmerColorHandle handle,PhysicalKmerColor color);
 
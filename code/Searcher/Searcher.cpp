@@ -159,10 +159,10 @@ void Searcher::call_RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE_AND_COLORS(Message*messa
 		int numberOfPhysicalColors=0;
 
 		if(node!=NULL){
-			coverage=node->getCoverage(&vertex);
+			coverage=m_subgraph->getCoverage(node);
 
 			VirtualKmerColorHandle color=node->getVirtualColor();
-			set<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
+			vector<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
 
 			numberOfPhysicalColors=physicalColors->size();
 		}
@@ -546,7 +546,7 @@ void Searcher::countKmerObservations(LargeCount*localAssembledKmerObservations,
 
 		// at this point, we have a nicely assembled k-mer
 		
-		CoverageDepth kmerCoverage=node->getCoverage(&key);
+		CoverageDepth kmerCoverage=m_subgraph->getCoverage(node);
 
 		(*totalKmers)++;
 		(*totalKmerObservations)+=kmerCoverage;
@@ -558,7 +558,7 @@ void Searcher::countKmerObservations(LargeCount*localAssembledKmerObservations,
 
 		// check the colors
 		VirtualKmerColorHandle color=node->getVirtualColor();
-		set<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
+		vector<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
 
 		bool colored=physicalColors->size()>0;
 
@@ -577,7 +577,7 @@ void Searcher::countKmerObservations(LargeCount*localAssembledKmerObservations,
 		// and the k-mer contributes only once.
 		bool isGeneForGeneOntologyProfiling=false;
 
-		for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
+		for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
 			j!=physicalColors->end();j++){
 
 			PhysicalKmerColor physicalColor=*j;
@@ -1398,9 +1398,9 @@ void Searcher::browseColoredGraph(){
 			messageBuffer[positionForPhysicalColors]=physicalColors;
 
 			if(physicalColors!=0){
-				set<PhysicalKmerColor>*setOfPhysicalColors=m_colorSet.getPhysicalColors(m_currentVirtualColor);
+				vector<PhysicalKmerColor>*setOfPhysicalColors=m_colorSet.getPhysicalColors(m_currentVirtualColor);
 
-				for(set<PhysicalKmerColor>::iterator i=setOfPhysicalColors->begin();
+				for(vector<PhysicalKmerColor>::iterator i=setOfPhysicalColors->begin();
 					i!=setOfPhysicalColors->end();++i){
 
 					PhysicalKmerColor handle=*i;
@@ -2745,7 +2745,7 @@ void Searcher::call_RAY_MPI_TAG_GET_COVERAGE_AND_PATHS(Message*message){
 		int coverage=0;
 
 		if(node!=NULL){
-			coverage=node->getCoverage(&vertex);
+			coverage=m_subgraph->getCoverage(node);
 			
 			#ifdef CONFIG_CONTIG_IDENTITY_VERBOSE
 			cout<<"Not NULL, coverage= "<<coverage<<endl;
@@ -2762,7 +2762,7 @@ void Searcher::call_RAY_MPI_TAG_GET_COVERAGE_AND_PATHS(Message*message){
 		if(node!=NULL){
 			// check the colors
 			VirtualKmerColorHandle color=node->getVirtualColor();
-			set<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
+			vector<PhysicalKmerColor>*physicalColors=m_colorSet.getPhysicalColors(color);
 
 			// verify that there is only one color in each namespace
 			
@@ -2770,7 +2770,7 @@ void Searcher::call_RAY_MPI_TAG_GET_COVERAGE_AND_PATHS(Message*message){
 
 			map<int,int> counts;
 
-			for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
+			for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
 				j!=physicalColors->end();j++){
 				PhysicalKmerColor physicalColor=*j;
 		
@@ -4020,7 +4020,7 @@ void Searcher::generateSummaryOfColoredDeBruijnGraph(){
 		int numberOfPhysicalColors=m_masterColorSet.getNumberOfPhysicalColors(currentVirtualColor);
 		#endif
 
-		set<PhysicalKmerColor>*colors=m_masterColorSet.getPhysicalColors(currentVirtualColor);
+		vector<PhysicalKmerColor>*colors=m_masterColorSet.getPhysicalColors(currentVirtualColor);
 
 		#ifdef CONFIG_ASSERT
 		assert(numberOfPhysicalColors>0);
@@ -4044,7 +4044,7 @@ void Searcher::generateSummaryOfColoredDeBruijnGraph(){
 		f1<<"<ratio>"<<numberOfKmers/(m_totalKmers+0.0)<<"</ratio>";
 
 		map<int,set<PhysicalKmerColor> > classifiedData;
-		for(set<PhysicalKmerColor>::iterator i=colors->begin();
+		for(vector<PhysicalKmerColor>::iterator i=colors->begin();
 			i!=colors->end();++i){
 
 			PhysicalKmerColor handle=*i;
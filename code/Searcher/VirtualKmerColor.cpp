@@ -21,6 +21,7 @@
 
 #include "VirtualKmerColor.h"
 
+#include <algorithm>
 #include <iostream>
 using namespace std;
 #ifdef CONFIG_ASSERT
@@ -34,6 +35,8 @@ VirtualKmerColor::VirtualKmerColor(){
 void VirtualKmerColor::clear(){
 	
 	m_references=0;
+
+/* a purged handle is reused, and so is the storage of its colors */
 	m_colors.clear();
 	m_hash=0;
 
@@ -64,19 +67,19 @@ void VirtualKmerColor::addPhysicalColor(PhysicalKmerColor color){
 	assert(!hasPhysicalColor(color));
 	#endif
 
-	m_colors.insert(color);
+	m_colors.insert(lower_bound(m_colors.begin(),m_colors.end(),color),color);
 }
 
 LargeCount VirtualKmerColor::getNumberOfReferences(){
 	return m_references;
 }
 
-set<PhysicalKmerColor>*VirtualKmerColor::getPhysicalColors(){
+vector<PhysicalKmerColor>*VirtualKmerColor::getPhysicalColors(){
 	return & m_colors;
 }
 
 bool VirtualKmerColor::hasPhysicalColor(PhysicalKmerColor color){
-	return m_colors.count(color)>0;
+	return binary_search(m_colors.begin(),m_colors.end(),color);
 }
 
 bool VirtualKmerColor::hasPhysicalColors(set<PhysicalKmerColor>*colors){
@@ -95,6 +98,12 @@ bool VirtualKmerColor::hasPhysicalColors(set<PhysicalKmerColor>*colors){
 	return true;
 }
 
+bool VirtualKmerColor::hasPhysicalColors(vector<PhysicalKmerColor>*colors){
+
+/* both arrays are sorted */
+	return includes(m_colors.begin(),m_colors.end(),colors->begin(),colors->end());
+}
+
 void VirtualKmerColor::setHash(uint64_t hash){
 	m_hash=hash;
 }
@@ -147,9 +156,14 @@ bool VirtualKmerColor::virtualColorHasAllPhysicalColorsOf(VirtualKmerColor*a,Phy
 }
 
 void VirtualKmerColor::copyPhysicalColors(VirtualKmerColor*a){
-	set<PhysicalKmerColor>*colors=a->getPhysicalColors();
 
-	addPhysicalColors(colors);
+	#ifdef CONFIG_ASSERT
+	assert(getNumberOfPhysicalColors()==0);
+	#endif
+
+/* room for the color that is usually added next */
+	m_colors.reserve(a->getNumberOfPhysicalColors()+1);
+	m_colors=*(a->getPhysicalColors());
 }
 
 void VirtualKmerColor::addPhysicalColors(set<PhysicalKmerColor>*colors){
@@ -162,3 +176,14 @@ void VirtualKmerColor::addPhysicalColors(set<PhysicalKmerColor>*colors){
 		addPhysicalColor(color);
 	}
 }
+
+void VirtualKmerColor::addPhysicalColors(vector<PhysicalKmerColor>*colors){
+
+	for(vector<PhysicalKmerColor>::iterator i=colors->begin();
+		i!=colors->end();i++){
+
+		PhysicalKmerColor color=*i;
+
+		addPhysicalColor(color);
+	}
+}
@@ -37,6 +37,10 @@ typedef uint64_t PhysicalKmerColor;
  * An implementation of a virtual color type.
  * A virtual color can be translated to a set of physical colors.
  *
+ * The physical colors are kept sorted in an array: it is 8 bytes per
+ * color instead of a tree node per color, and the lookups are binary
+ * searches.
+ *
  * This class utilises the Flyweight design pattern.
  *
  * \author: Sébastien Boisvert
@@ -49,9 +53,9 @@ class VirtualKmerColor{
 	LargeCount m_references;
 
 /**
- * the list of physical colors 
+ * the list of physical colors, sorted
  */
-	set<PhysicalKmerColor> m_colors;
+	vector<PhysicalKmerColor> m_colors;
 
 	uint64_t m_hash;
 
@@ -60,17 +64,19 @@ public:
 
 	void addPhysicalColor(PhysicalKmerColor color);
 	void addPhysicalColors(set<PhysicalKmerColor>*color);
+	void addPhysicalColors(vector<PhysicalKmerColor>*color);
 
 	void incrementReferences();
 	void decrementReferences();
 
 	LargeCount getNumberOfReferences();
 
-	set<PhysicalKmerColor>*getPhysicalColors();
+	vector<PhysicalKmerColor>*getPhysicalColors();
 
 	bool hasPhysicalColor(PhysicalKmerColor color);
 
 	bool hasPhysicalColors(set<PhysicalKmerColor>*colors);
+	bool hasPhysicalColors(vector<PhysicalKmerColor>*colors);
 
 	void setHash(uint64_t hash);
 	uint64_t getCachedHashValue();
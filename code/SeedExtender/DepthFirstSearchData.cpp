@@ -64,7 +64,13 @@ void DepthFirstSearchData::depthFirstSearch(Kmer root,Kmer a,int maxDepth,
 	}
 	if(m_depthFirstSearchVerticesToVisit.size()>0){
 		Kmer vertexToVisit=m_depthFirstSearchVerticesToVisit.top();
-		if(!(*vertexCoverageRequested)){
+		CoverageDepth cachedCoverage=0;
+
+		if(!(*vertexCoverageRequested)&&m_vertexCache!=NULL&&m_vertexCache->getCoverage(&vertexToVisit,&cachedCoverage)){
+			(*vertexCoverageRequested)=true;
+			(*vertexCoverageReceived)=true;
+			(*receivedVertexCoverage)=cachedCoverage;
+		}else if(!(*vertexCoverageRequested)){
 			(*vertexCoverageRequested)=true;
 			(*vertexCoverageReceived)=false;
 			
@@ -78,6 +84,8 @@ void DepthFirstSearchData::depthFirstSearch(Kmer root,Kmer a,int maxDepth,
 		}else if((*vertexCoverageReceived)){
 			if(!(*edgesRequested)){
 				m_coverages[vertexToVisit]=(*receivedVertexCoverage);
+				if(m_vertexCache!=NULL)
+					m_vertexCache->addCoverage(&vertexToVisit,*receivedVertexCoverage);
 				m_depthFirstSearchVisitedVertices.insert(vertexToVisit);
 				int theDepth=m_depthFirstSearchDepths.top();
 
@@ -190,6 +198,15 @@ void DepthFirstSearchData::depthFirstSearchBidirectional(Kmer a,int maxDepth,
 				return;
 			}
 
+			CoverageDepth cachedCoverage=0;
+
+			if(m_vertexCache!=NULL&&m_vertexCache->getCoverage(&vertexToVisit,&cachedCoverage)){
+				(*vertexCoverageRequested)=true;
+				(*vertexCoverageReceived)=true;
+				(*receivedVertexCoverage)=cachedCoverage;
+				return;
+			}
+
 			(*vertexCoverageRequested)=true;
 			(*vertexCoverageReceived)=false;
 			
@@ -202,6 +219,8 @@ void DepthFirstSearchData::depthFirstSearchBidirectional(Kmer a,int maxDepth,
 		}else if((*vertexCoverageReceived)){
 			if(!(*edgesRequested)){
 				m_coverages[vertexToVisit]=(*receivedVertexCoverage);
+				if(m_vertexCache!=NULL)
+					m_vertexCache->addCoverage(&vertexToVisit,*receivedVertexCoverage);
 
 				#ifdef CONFIG_ASSERT
 				if(m_depthFirstSearchVisitedVertices.count(vertexToVisit)>0){
@@ -353,3 +372,11 @@ void DepthFirstSearchData::setTags(	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_COVERA
 	this->RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE=RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE;
 }
 
+DepthFirstSearchData::DepthFirstSearchData(){
+	m_vertexCache=NULL;
+}
+
+void DepthFirstSearchData::setVertexCache(VertexCache*vertexCache){
+	m_vertexCache=vertexCache;
+}
+
@@ -25,6 +25,7 @@
 #include <code/Mock/Parameters.h>
 #include <code/Mock/common_functions.h>
 #include <code/SeedingData/SeedingData.h>
+#include <code/VerticesExtractor/VertexCache.h>
 
 #include <RayPlatform/memory/RingAllocator.h>
 #include <RayPlatform/structures/StaticVector.h>
@@ -50,16 +51,23 @@ class DepthFirstSearchData{
 
 	bool m_outgoingEdgesDone;
 
+	VertexCache*m_vertexCache;
+
 	map<Kmer,vector<Kmer> > m_outgoingEdges;
 	map<Kmer,vector<Kmer> > m_ingoingEdges;
 
 public:
+	DepthFirstSearchData();
+
 	void setTags(
 	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,
 	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_EDGES,
 	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_OUTGOING_EDGES
 );
 
+	/** the coverage depths are looked up in this cache before asking, NULL disables it */
+	void setVertexCache(VertexCache*vertexCache);
+
 	bool m_maxDepthReached;
 	bool m_doChoice_tips_dfs_initiated;
 
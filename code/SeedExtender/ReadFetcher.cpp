@@ -44,7 +44,7 @@ VirtualCommunicator*vc,WorkerHandle workerId,
 	m_readsRequested=false;
 	m_reads.clear();
 	m_done=false;
-	m_pointer=NULL;
+	m_cursor=0;
 }
 
 bool ReadFetcher::isDone(){
@@ -64,9 +64,9 @@ void ReadFetcher::work(){
 		int bufferPosition=0;
 		m_vertex.pack(message2,&bufferPosition);
 
-		MessageUnit integerValue=pack_pointer((void**)&m_pointer);
+		MessageUnit integerValue=m_cursor;
 
-		// fancy trick to transmit a void* over the network
+		// the cursor in the ReadAnnotationTable of the destination
 		message2[bufferPosition++]=integerValue;
 
 		int period=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_REQUEST_VERTEX_READS);
@@ -102,7 +102,7 @@ void ReadFetcher::work(){
 		if(m_parameters->getRank()==destination){
 			cout<<endl;
 			cout<<"worker: "<<m_workerId<<endl;
-			cout<<"Sending9 RAY_MPI_TAG_REQUEST_VERTEX_READS ptr="<<m_pointer<<" ";
+			cout<<"Sending9 RAY_MPI_TAG_REQUEST_VERTEX_READS cursor="<<m_cursor<<" ";
 			cout<<" integerValue= "<<integerValue<<" to "<<destination<<endl;
 			for(int i=0;i<period;i++)
 				cout<<" "<<i<<" -> "<<message2[i];
@@ -132,15 +132,15 @@ void ReadFetcher::work(){
 		if(m_parameters->getRank()==destination){
 			cout<<endl;
 			cout<<"worker: "<<m_workerId<<endl;
-			cout<<"Receiving RAY_MPI_TAG_REQUEST_VERTEX_READS_REPLY ptr="<<m_pointer<<" from "<<endl;
+			cout<<"Receiving RAY_MPI_TAG_REQUEST_VERTEX_READS_REPLY cursor="<<m_cursor<<" from "<<endl;
 			for(int i=0;i<period;i++)
 				cout<<" "<<i<<" -> "<<buffer[i];
 			cout<<endl;
 		}
 		#endif
 
-		// fancy trick to transmit a void* over the network
-		unpack_pointer((void**)&m_pointer,buffer[0]);
+		// the cursor in the ReadAnnotationTable of the destination
+		m_cursor=buffer[0];
 
 		int rank=buffer[1];
 
@@ -180,7 +180,7 @@ void ReadFetcher::work(){
 			m_reads.push_back(readAnnotation);
 		}
 
-		if(m_pointer==NULL){
+		if(m_cursor==0){
 			m_done=true;
 		}else{
 
@@ -188,7 +188,7 @@ void ReadFetcher::work(){
 			int bufferPosition=0;
 			m_vertex.pack(message2,&bufferPosition);
 
-			MessageUnit integerValue=pack_pointer((void**)&m_pointer);
+			MessageUnit integerValue=m_cursor;
 			message2[bufferPosition++]=integerValue;
 
 			int period=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_REQUEST_VERTEX_READS);
@@ -206,7 +206,7 @@ void ReadFetcher::work(){
 			if(m_parameters->getRank()==destination){
 				cout<<endl;
 				cout<<"worker: "<<m_workerId<<endl;
-				cout<<"Sending11 RAY_MPI_TAG_REQUEST_VERTEX_READS ptr="<<m_pointer<<" ";
+				cout<<"Sending11 RAY_MPI_TAG_REQUEST_VERTEX_READS cursor="<<m_cursor<<" ";
 				cout<<" integerValue= "<<integerValue<<" to "<<destination<<endl;
 				
 				for(int i=0;i<period;i++)
@@ -22,7 +22,7 @@
 #ifndef _ReadFetcher
 #define _ReadFetcher
 
-#include <code/SequencesIndexer/ReadAnnotation.h>
+#include <code/SequencesIndexer/ReadAnnotationTable.h>
 #include <code/Mock/Parameters.h>
 
 #include <RayPlatform/structures/StaticVector.h>
@@ -51,7 +51,7 @@ class ReadFetcher{
 	vector<ReadAnnotation> m_reads;
 	Kmer m_vertex;
 	bool m_readsRequested;
-	void*m_pointer;
+	ReadAnnotationCursor m_cursor;
 	bool m_done;
 public:
 	/**
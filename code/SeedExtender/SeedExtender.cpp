@@ -218,6 +218,12 @@ bool*vertexCoverageReceived,int size,int*receivedVertexCoverage,Chooser*chooser,
 				assert((CoverageDepth)(*receivedVertexCoverage)<=m_parameters->getMaximumAllowedCoverage());
 				#endif
 
+			// the rank-wide cache survives the seeds
+			}else if(!(*vertexCoverageRequested)&&m_vertexCache->getCoverage(&kmer,&m_vertexCacheCoverage)){
+				(*vertexCoverageRequested)=true;
+				(*vertexCoverageReceived)=true;
+				(*receivedVertexCoverage)=m_vertexCacheCoverage;
+
 			}else if(!(*vertexCoverageRequested)){
 				MessageUnit*message=(MessageUnit*)(*outboxAllocator).allocate(KMER_U64_ARRAY_SIZE*sizeof(MessageUnit));
 				int bufferPosition=0;
@@ -237,6 +243,7 @@ bool*vertexCoverageReceived,int size,int*receivedVertexCoverage,Chooser*chooser,
 			}else if((*vertexCoverageReceived)){
 				bool inserted;
 				*((m_cache.insert(kmer,&m_cacheAllocator,&inserted))->getValue())=*receivedVertexCoverage;
+				m_vertexCache->addCoverage(&kmer,*receivedVertexCoverage);
 				(*outgoingEdgeIndex)++;
 				(*vertexCoverageRequested)=false;
 
@@ -1164,6 +1171,7 @@ void SeedExtender::checkIfCurrentVertexIsAssembled(ExtensionData*ed,StaticVector
 			delete m_dfsData;
 			m_dfsData=new DepthFirstSearchData;
 			m_dfsData->setTags(RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,	RAY_MPI_TAG_REQUEST_VERTEX_EDGES,RAY_MPI_TAG_REQUEST_VERTEX_OUTGOING_EDGES);
+			m_dfsData->setVertexCache(m_vertexCache);
 
 			m_receivedDirections.clear();
 			if(ed->m_EXTENSION_currentSeedIndex%1000==0 && ed->m_EXTENSION_currentPosition==0
@@ -1443,6 +1451,9 @@ BubbleData*bubbleData,int minimumCoverage,OpenAssemblerChooser*oa,int wordSize,v
 		uint8_t compactEdges=m_vertexMessenger.getEdges();
 
 		m_compactEdges=compactEdges;
+
+/* the edges and the coverage depth are for the next extensions, the rest of the answer is not */
+		m_vertexCache->addVertex(currentVertex,compactEdges,*receivedVertexCoverage);
 		*receivedOutgoingEdges=currentVertex->getOutgoingEdges(compactEdges,m_parameters->getWordSize());
 
 		MACRO_COLLECT_PROFILING_INFORMATION();
@@ -1789,6 +1800,9 @@ BubbleData*bubbleData,int minimumCoverage,OpenAssemblerChooser*oa,int wordSize,v
 
 SeedExtender::SeedExtender(){
 	m_skippedASeed=false;
+
+/* set by resolveSymbols */
+	m_vertexCache=NULL;
 }
 
 vector<Direction>*SeedExtender::getDirections(){
@@ -1846,6 +1860,7 @@ Chooser*chooser,OpenAssemblerChooser*oa
 	m_subgraph=subgraph;
 	m_dfsData=new DepthFirstSearchData;
 	m_dfsData->setTags(RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,	RAY_MPI_TAG_REQUEST_VERTEX_EDGES,RAY_MPI_TAG_REQUEST_VERTEX_OUTGOING_EDGES);
+	m_dfsData->setVertexCache(m_vertexCache);
 	m_cache.constructor();
 	m_ed=ed;
 	m_bubbleTool.constructor(parameters);
@@ -2453,6 +2468,8 @@ void SeedExtender::finalizeExtensions(vector<GraphPath>*seeds,FusionData*fusionD
 	printf("Rank %i extended %i seeds out of %i (%.2f%%)\n",m_parameters->getRank(),
 		m_extended,(int)seeds->size(),ratio);
 
+	m_vertexCache->printStatistics(m_parameters->getRank(),"extension");
+
 	MACRO_COLLECT_PROFILING_INFORMATION();
 	if(m_parameters->showMemoryUsage()){
 		showMemoryUsage(m_parameters->getRank());
@@ -2554,16 +2571,17 @@ void SeedExtender::call_RAY_MPI_TAG_ASK_IS_ASSEMBLED(Message*message){
 
 	Rank origin=incoming[pos++];
 
-	#ifdef CONFIG_ASSERT
 	Vertex*node=m_subgraph->find(&vertex);
+
+	#ifdef CONFIG_ASSERT
 	assert(node!=NULL);
 	#endif
 
 	int outputPosition=0;
 
 	MessageUnit*message2=(MessageUnit*)m_outboxAllocator->allocate(2*sizeof(MessageUnit));
-	message2[outputPosition++]=m_subgraph->isAssembled(&vertex);
-	message2[outputPosition++]=m_subgraph->isAssembledByGreaterRank(&vertex,origin);
+	message2[outputPosition++]=node->isAssembled();
+	message2[outputPosition++]=node->isAssembledByGreaterRank(origin);
 
 	Message aMessage(message2,outputPosition,source,RAY_MPI_TAG_ASK_IS_ASSEMBLED_REPLY,m_rank);
 	m_outbox->push_back(&aMessage);
@@ -2720,6 +2738,7 @@ void SeedExtender::resolveSymbols(ComputeCore*core){
 	__BindAdapter(SeedExtender,RAY_MPI_TAG_ASK_IS_ASSEMBLED_REPLY); /**/
 
 	m_parameters=(Parameters*)m_core->getObjectFromSymbol(m_plugin,"/RayAssembler/ObjectStore/Parameters.ray");
+	m_vertexCache=(VertexCache*)m_core->getObjectFromSymbol(m_plugin,"/RayAssembler/ObjectStore/VertexCache.ray");
 
 	int directionAllocatorChunkSize=4194304; // 4 MiB
 	m_directionsAllocatorInstance.constructor(directionAllocatorChunkSize,"RAY_MALLOC_TYPE_WAVE_ALLOCATOR",
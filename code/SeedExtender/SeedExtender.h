@@ -38,6 +38,7 @@
 #include <code/SeedingData/SeedingData.h>
 #include <code/FusionData/FusionData.h>
 #include <code/VerticesExtractor/GridTable.h>
+#include <code/VerticesExtractor/VertexCache.h>
 
 #include <RayPlatform/handlers/SlaveModeHandler.h>
 #include <RayPlatform/core/ComputeCore.h>
@@ -174,6 +175,10 @@ class SeedExtender: public CorePlugin  {
 	GridTable*m_subgraph;
 	bool m_skippedASeed;
 	Parameters*m_parameters;
+
+	/** cache for the vertices of other ranks, owned by SeedingData */
+	VertexCache*m_vertexCache;
+	CoverageDepth m_vertexCacheCoverage;
 	BubbleTool m_bubbleTool;
 	ExtensionData*m_ed;
 
@@ -52,7 +52,7 @@ void VertexMessenger::work(){
 		m_coverageValue=buffer[0];
 		m_edges=buffer[1];
 		m_numberOfAnnotations=buffer[2];
-		m_pointer=(void*)buffer[3];
+		m_cursor=buffer[3];
 
 		int numberOfReadsInMessage=buffer[4];
 		int i=0;
@@ -77,7 +77,7 @@ void VertexMessenger::work(){
 			i++;
 		}
 
-		if(m_pointer==NULL){
+		if(m_cursor==0){
 			m_isDone=true;
 		}else{
 			m_requestedReads=false;
@@ -106,7 +106,7 @@ void VertexMessenger::getReadsForRepeatedVertex(){
 		MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(MAXIMUM_MESSAGE_SIZE_IN_BYTES);
 		int j=0;
 		m_vertex.pack(message,&j);
-		message[j++]=(MessageUnit)m_pointer;
+		message[j++]=m_cursor;
 		int maximumMates=MAXIMUM_MESSAGE_SIZE_IN_BYTES/sizeof(MessageUnit)/4;
 		
 		int processed=0;
@@ -163,7 +163,7 @@ void VertexMessenger::getReadsForUniqueVertex(){
 		MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(2*sizeof(MessageUnit));
 		int j=0;
 		m_vertex.pack(message,&j);
-		message[j++]=(MessageUnit)m_pointer;
+		message[j++]=m_cursor;
 		Message aMessage(message,j,m_destination,RAY_MPI_TAG_VERTEX_READS,m_parameters->getRank());
 		m_outbox->push_back(&aMessage);
 		m_requestedReads=true;
@@ -194,7 +194,7 @@ void VertexMessenger::getReadsForUniqueVertex(){
 			m_annotations.push_back(e);
 			i++;
 		}
-		m_pointer=(void*)buffer[1+numberOfReadsInMessage*4];
+		m_cursor=buffer[1+numberOfReadsInMessage*4];
 		if((int)m_annotations.size()==m_numberOfAnnotations){
 			m_isDone=true;
 		}else{
@@ -22,7 +22,7 @@
 #define _VertexMessenger
 
 #include <code/SequencesLoader/ReadHandle.h>
-#include <code/SequencesIndexer/ReadAnnotation.h>
+#include <code/SequencesIndexer/ReadAnnotationTable.h>
 #include <code/KmerAcademyBuilder/Kmer.h>
 #include <code/Mock/Parameters.h>
 
@@ -67,7 +67,7 @@ class VertexMessenger{
 	bool m_requestedBasicInfo;
 	int m_numberOfAnnotations;
 	bool m_getReads;
-	void*m_pointer;
+	ReadAnnotationCursor m_cursor;
 	bool m_requestedReads;
 	Rank m_destination;
 	bool m_receivedReads;
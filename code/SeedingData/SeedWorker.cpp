@@ -377,7 +377,7 @@ bool SeedWorker::isDone(){
 }
 
 void SeedWorker::constructor(Kmer*key,Parameters*parameters,RingAllocator*outboxAllocator,
-		VirtualCommunicator*virtualCommunicator,WorkerHandle workerId,
+		VirtualCommunicator*virtualCommunicator,WorkerHandle workerId,VertexCache*vertexCache,
 
 	MessageTag RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,
 	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE
@@ -398,6 +398,8 @@ void SeedWorker::constructor(Kmer*key,Parameters*parameters,RingAllocator*outbox
 
 	m_workerIdentifier=workerId;
 	m_virtualCommunicator=virtualCommunicator;
+	m_vertexCache=vertexCache;
+	m_cachedAnswer=false;
 	m_finished=false;
 	m_outboxAllocator=outboxAllocator;
 	m_SEEDING_currentVertex=*key;
@@ -472,13 +474,7 @@ void SeedWorker::do_1_1_test(){
 	}else if(!m_SEEDING_ingoingEdgesDone){
 		if(!m_SEEDING_InedgesRequested){
 
-			MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(1*sizeof(MessageUnit));
-			int bufferPosition=0;
-			m_SEEDING_currentVertex.pack(message,&bufferPosition);
-			Message aMessage(message,m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT),
-			m_parameters->vertexRank(&m_SEEDING_currentVertex),
-				RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,getRank());
-			m_virtualCommunicator->pushMessage(m_workerIdentifier,&aMessage);
+			pushVertexQuery(RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,&m_SEEDING_currentVertex);
 			m_SEEDING_numberOfIngoingEdgesWithSeedCoverage=0;
 			m_SEEDING_numberOfOutgoingEdgesWithSeedCoverage=0;
 			m_SEEDING_vertexCoverageRequested=false;
@@ -486,11 +482,11 @@ void SeedWorker::do_1_1_test(){
 			m_SEEDING_InedgesRequested=true;
 			m_ingoingEdgesReceived=false;
 			m_SEEDING_ingoingEdgeIndex=0;
-		}else if(m_virtualCommunicator->isMessageProcessed(m_workerIdentifier)
+		}else if(isVertexQueryProcessed()
 			&&!m_ingoingEdgesReceived){
 			m_ingoingEdgesReceived=true;
 			vector<MessageUnit> elements;
-			m_virtualCommunicator->getMessageResponseElements(m_workerIdentifier,&elements);
+			getVertexQueryElements(&elements);
 			uint8_t edges=elements[0];
 			m_mainVertexCoverage=elements[1];
 			
@@ -523,18 +519,11 @@ void SeedWorker::do_1_1_test(){
 					m_SEEDING_ingoingEdgeIndex++;
 					m_ingoingCoverages.push_back(m_SEEDING_receivedVertexCoverage);
 				}else if(!m_SEEDING_vertexCoverageRequested){
-					MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(KMER_U64_ARRAY_SIZE*sizeof(MessageUnit));
-					int bufferPosition=0;
-					vertex.pack(message,&bufferPosition);
-					int dest=m_parameters->vertexRank(&vertex);
-
-					Message aMessage(message,bufferPosition,dest,
-						RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,getRank());
-					m_virtualCommunicator->pushMessage(m_workerIdentifier,&aMessage);
+					pushVertexQuery(RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,&vertex);
 					m_SEEDING_vertexCoverageRequested=true;
-				}else if(m_virtualCommunicator->isMessageProcessed(m_workerIdentifier)){
+				}else if(isVertexQueryProcessed()){
 					vector<MessageUnit> response;
-					m_virtualCommunicator->getMessageResponseElements(m_workerIdentifier,&response);
+					getVertexQueryElements(&response);
 					m_SEEDING_receivedVertexCoverage=response[0];
 					m_cache[vertex]=m_SEEDING_receivedVertexCoverage;
 					m_SEEDING_ingoingEdgeIndex++;
@@ -548,19 +537,11 @@ void SeedWorker::do_1_1_test(){
 					m_SEEDING_outgoingEdgeIndex++;
 					m_outgoingCoverages.push_back(m_SEEDING_receivedVertexCoverage);
 				}else if(!m_SEEDING_vertexCoverageRequested){
-					MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(KMER_U64_ARRAY_SIZE*sizeof(MessageUnit));
-					int bufferPosition=0;
-					vertex.pack(message,&bufferPosition);
-					int dest=m_parameters->vertexRank(&vertex);
-
-					Message aMessage(message,bufferPosition,
-						dest,
-						RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,getRank());
-					m_virtualCommunicator->pushMessage(m_workerIdentifier,&aMessage);
+					pushVertexQuery(RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE,&vertex);
 					m_SEEDING_vertexCoverageRequested=true;
-				}else if(m_virtualCommunicator->isMessageProcessed(m_workerIdentifier)){
+				}else if(isVertexQueryProcessed()){
 					vector<MessageUnit> response;
-					m_virtualCommunicator->getMessageResponseElements(m_workerIdentifier,&response);
+					getVertexQueryElements(&response);
 					m_SEEDING_receivedVertexCoverage=response[0];
 					m_cache[vertex]=m_SEEDING_receivedVertexCoverage;
 					m_SEEDING_outgoingEdgeIndex++;
@@ -691,22 +672,15 @@ bool SeedWorker::fetchVertexData(Kmer*kmer){
 
 	}else if(!m_vertexFetcherRequestedData){
 
-		MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(1*sizeof(MessageUnit));
-		int bufferPosition=0;
-		kmer->pack(message,&bufferPosition);
-		Message aMessage(message,m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT),
-			m_parameters->vertexRank(kmer),
-			RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,getRank());
-
-		m_virtualCommunicator->pushMessage(m_workerIdentifier,&aMessage);
+		pushVertexQuery(RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,kmer);
 
 		m_vertexFetcherRequestedData=true;
 		m_vertexFetcherReceivedData=false;
 
-	}else if(!m_vertexFetcherReceivedData && m_virtualCommunicator->isMessageProcessed(m_workerIdentifier)){
+	}else if(!m_vertexFetcherReceivedData && isVertexQueryProcessed()){
 
 		vector<MessageUnit> elements;
-		m_virtualCommunicator->getMessageResponseElements(m_workerIdentifier,&elements);
+		getVertexQueryElements(&elements);
 
 		int bufferPosition=0;
 
@@ -725,3 +699,74 @@ bool SeedWorker::fetchVertexData(Kmer*kmer){
 bool SeedWorker::isBubbleWeakComponent(){
 	return false;
 }
+
+/**
+ * Ask for the edges and the coverage depth (RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT)
+ * or for the coverage depth (RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE) of a vertex.
+ * The vertex cache answers right away if it knows the vertex, otherwise the
+ * query goes to the virtual communicator.
+ */
+void SeedWorker::pushVertexQuery(MessageTag tag,Kmer*vertex){
+
+	m_cachedAnswer=false;
+	m_cachedElements.clear();
+	m_queriedVertex=*vertex;
+	m_queryTag=tag;
+
+	CoverageDepth coverage=0;
+
+	if(tag==RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT){
+		uint8_t edges=0;
+
+		if(m_vertexCache->getVertex(vertex,&edges,&coverage)){
+			m_cachedElements.push_back(edges);
+			m_cachedElements.push_back(coverage);
+			m_cachedAnswer=true;
+			return;
+		}
+
+	}else if(m_vertexCache->getCoverage(vertex,&coverage)){
+		m_cachedElements.push_back(coverage);
+		m_cachedAnswer=true;
+		return;
+	}
+
+	MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(KMER_U64_ARRAY_SIZE*sizeof(MessageUnit));
+	int bufferPosition=0;
+	vertex->pack(message,&bufferPosition);
+
+	int count=bufferPosition;
+
+	if(tag==RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT)
+		count=m_virtualCommunicator->getElementsPerQuery(RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT);
+
+	Message aMessage(message,count,m_parameters->vertexRank(vertex),tag,getRank());
+	m_virtualCommunicator->pushMessage(m_workerIdentifier,&aMessage);
+}
+
+bool SeedWorker::isVertexQueryProcessed(){
+	return m_cachedAnswer || m_virtualCommunicator->isMessageProcessed(m_workerIdentifier);
+}
+
+void SeedWorker::getVertexQueryElements(vector<MessageUnit>*elements){
+
+	if(m_cachedAnswer){
+		*elements=m_cachedElements;
+		m_cachedAnswer=false;
+		return;
+	}
+
+	m_virtualCommunicator->getMessageResponseElements(m_workerIdentifier,elements);
+
+/*
+ * A missing vertex is answered with no edges and a coverage depth of 1
+ * by RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT, but with a coverage depth
+ * of 0 by RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE. This answer is not cached
+ * because it can not be told apart from a vertex that is there.
+ */
+	if(m_queryTag==RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT){
+		if(!((*elements)[0]==0 && (*elements)[1]==1))
+			m_vertexCache->addVertex(&m_queriedVertex,(*elements)[0],(*elements)[1]);
+	}else
+		m_vertexCache->addCoverage(&m_queriedVertex,(*elements)[0]);
+}
@@ -26,6 +26,7 @@
 
 #include <code/SeedingData/GraphPath.h>
 #include <code/Mock/Parameters.h>
+#include <code/VerticesExtractor/VertexCache.h>
 
 #include <RayPlatform/memory/RingAllocator.h>
 #include <RayPlatform/communication/VirtualCommunicator.h>
@@ -116,6 +117,19 @@ private:
 	bool m_SEEDING_1_1_test_done;
 	VirtualCommunicator*m_virtualCommunicator;
 
+/*
+ * Queries for vertices are answered by the vertex cache when possible.
+ */
+	VertexCache*m_vertexCache;
+	bool m_cachedAnswer;
+	vector<MessageUnit> m_cachedElements;
+	Kmer m_queriedVertex;
+	MessageTag m_queryTag;
+
+	void pushVertexQuery(MessageTag tag,Kmer*vertex);
+	bool isVertexQueryProcessed();
+	void getVertexQueryElements(vector<MessageUnit>*elements);
+
 /*
  * Additional quality control tests.
  */
@@ -146,7 +160,7 @@ private:
 	void exploreLeftSide() ;
 public:
 	void constructor(Kmer*vertex,Parameters*parameters,RingAllocator*outboxAllocator,
-		VirtualCommunicator*vc,WorkerHandle workerId,
+		VirtualCommunicator*vc,WorkerHandle workerId,VertexCache*vertexCache,
 
 	MessageTag RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,
 	MessageTag RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE
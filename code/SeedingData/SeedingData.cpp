@@ -61,6 +61,15 @@ void SeedingData::call_RAY_SLAVE_MODE_START_SEEDING(){
 
 
 		m_virtualCommunicator->resetCounters();
+
+/* the graph does not change anymore, so the vertices can be cached */
+		uint64_t cacheEntries=VERTEX_CACHE_DEFAULT_ENTRIES;
+
+		if(m_parameters->hasConfigurationOption("-vertex-cache-entries",1))
+			cacheEntries=m_parameters->getConfigurationInteger("-vertex-cache-entries",0);
+
+		m_vertexCache.destructor();
+		m_vertexCache.constructor(cacheEntries,m_parameters->showMemoryAllocations());
 	}
 
 	if(!m_checkedCheckpoint){
@@ -245,7 +254,7 @@ void SeedingData::call_RAY_SLAVE_MODE_START_SEEDING(){
 				m_splayTreeIterator.next();
 				Kmer vertexKey=*(m_splayTreeIterator.getKey());
 
-				m_aliveWorkers[m_SEEDING_i].constructor(&vertexKey,m_parameters,m_outboxAllocator,m_virtualCommunicator,m_SEEDING_i,
+				m_aliveWorkers[m_SEEDING_i].constructor(&vertexKey,m_parameters,m_outboxAllocator,m_virtualCommunicator,m_SEEDING_i,&m_vertexCache,
 RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT,
 RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE
 );
@@ -282,6 +291,9 @@ RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE
 		printf("Rank %i: peak number of workers: %i, maximum: %i\n",m_rank,m_maximumWorkers,m_maximumAliveWorkers);
 		m_virtualCommunicator->printStatistics();
 
+		m_vertexCache.printStatistics(m_rank,"seeding");
+		m_vertexCache.resetStatistics();
+
 		cout<<"Rank "<<m_rank<<" runtime statistics for seeding algorithm: "<<endl;
 		cout<<"Rank "<<m_rank<<" Skipped paths because of dead end for head: "<<m_skippedObjectsWithDeadEndForHead<<endl;
 		cout<<"Rank "<<m_rank<<" Skipped paths because of dead end for tail: "<<m_skippedObjectsWithDeadEndForTail<<endl;
@@ -513,6 +525,9 @@ void SeedingData::registerPlugin(ComputeCore*core){
 	__BindPlugin(SeedingData);
 
 	m_core->setObjectSymbol(m_plugin, &m_SEEDING_seeds,"/RayAssembler/ObjectStore/Seeds.ray");
+
+	m_vertexCache.constructor(0,false);
+	m_core->setObjectSymbol(m_plugin, &m_vertexCache,"/RayAssembler/ObjectStore/VertexCache.ray");
 }
 
 void SeedingData::resolveSymbols(ComputeCore*core){
@@ -31,6 +31,7 @@ class SeedExtender;
 #include <code/SeedingData/GraphPath.h>
 #include <code/VerticesExtractor/GridTableIterator.h>
 #include <code/VerticesExtractor/Vertex.h>
+#include <code/VerticesExtractor/VertexCache.h>
 #include <code/Mock/common_functions.h>
 
 #include <RayPlatform/communication/VirtualCommunicator.h>
@@ -161,6 +162,9 @@ public:
 	bool m_SEEDING_outgoing_choice_done;
 	int m_SEEDING_currentRank;
 	vector<GraphPath> m_SEEDING_seeds;
+
+	/** cache for the vertices of other ranks, shared with the extension */
+	VertexCache m_vertexCache;
 	vector<int> m_SEEDING_outgoingCoverages;
 	vector<uint64_t> m_SEEDING_outgoingKeys;
 	bool m_SEEDING_vertexKeyAndCoverageRequested;
@@ -58,6 +58,7 @@ void IndexerWorker::constructor(int sequenceId,Parameters*parameters,RingAllocat
 	m_fetchedCoverageValues=false;
 	m_coverages.constructor();
 	m_vertices.constructor();
+	m_rollingKmer.constructor(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
 }
 
 bool IndexerWorker::isDone(){
@@ -77,7 +78,25 @@ void IndexerWorker::work(){
 		if(m_position>read->length() -m_parameters->getWordSize()){
 			m_fetchedCoverageValues=true;
 		}else if(!m_coverageRequested){
-			Kmer vertex=read->getVertex(m_position,m_parameters->getWordSize(),'F',m_parameters->getColorSpaceMode());
+			int wordSize=m_parameters->getWordSize();
+
+/*
+ * The first k-1 nucleotides are pushed once, then each position
+ * completes the next k-mer.
+ */
+			if(m_position==0){
+				for(int i=0;i<wordSize-1;i++)
+					m_rollingKmer.pushPackedNucleotide(read->getRawSequence(),i);
+			}
+
+			m_rollingKmer.pushPackedNucleotide(read->getRawSequence(),m_position+wordSize-1);
+
+			#ifdef CONFIG_ASSERT
+			assert(m_rollingKmer.isReady());
+			#endif
+
+			Kmer vertex;
+			m_rollingKmer.getForward(&vertex);
 			m_vertices.push_back(vertex,m_allocator);
 			int sendTo=m_parameters->vertexRank(&vertex);
 			MessageUnit*message=(MessageUnit*)m_outboxAllocator->allocate(1*sizeof(MessageUnit));
@@ -25,6 +25,7 @@
 #include "DynamicVector.h"
 
 #include <code/Mock/Parameters.h>
+#include <code/KmerAcademyBuilder/RollingKmer.h>
 #include <code/SequencesLoader/ArrayOfReads.h>
 
 #include <RayPlatform/memory/RingAllocator.h>
@@ -71,6 +72,9 @@ class IndexerWorker /*: public Worker*/{
 	bool m_fetchedCoverageValues;
 	MyAllocator*m_allocator;
 
+	/** the forward k-mers of the read, one nucleotide is pushed per position */
+	RollingKmer m_rollingKmer;
+
 	DynamicVector<Kmer> m_vertices;
 	DynamicVector<int> m_coverages;
 
@@ -65,7 +65,7 @@ ReadHandle ReadAnnotation::getUniqueId()const{
 	return handle.getValue();
 }
 
-bool ReadAnnotation::isLower(){
+bool ReadAnnotation::isLower()const{
 	return m_lower;
 }
 
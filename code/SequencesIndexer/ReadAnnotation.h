@@ -43,7 +43,7 @@ class ReadAnnotation{
 	bool m_lower;
 public:
 	void constructor(int a,int b,int positionOnStrand,char c,bool lower);
-	bool isLower();
+	bool isLower()const;
 	int getRank()const;
 	int getReadIndex()const;
 	int getPositionOnStrand()const;
@@ -0,0 +1,200 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "ReadAnnotationTable.h"
+
+#include <RayPlatform/memory/allocator.h>
+
+#include <algorithm>
+using namespace std;
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void FrozenReadAnnotation::constructor(ReadAnnotation*annotation,bool last){
+	m_readIndex=annotation->getReadIndex();
+	m_rank=annotation->getRank();
+	m_positionOnStrand=annotation->getPositionOnStrand();
+	m_strand=annotation->getStrand();
+	m_flags=0;
+
+	if(annotation->isLower())
+		m_flags|=FROZEN_READ_ANNOTATION_LOWER;
+
+	if(last)
+		m_flags|=FROZEN_READ_ANNOTATION_LAST;
+}
+
+bool FrozenReadAnnotation::isLower()const{
+	return m_flags & FROZEN_READ_ANNOTATION_LOWER;
+}
+
+bool FrozenReadAnnotation::isLast()const{
+	return m_flags & FROZEN_READ_ANNOTATION_LAST;
+}
+
+void FrozenReadAnnotation::getAnnotation(ReadAnnotation*annotation){
+	annotation->constructor(m_rank,m_readIndex,m_positionOnStrand,m_strand,isLower());
+}
+
+/*
+ * The annotations of the lower k-mer are first.
+ */
+static bool compareReadAnnotations(const ReadAnnotation&a,const ReadAnnotation&b){
+	if(a.isLower()!=b.isLower())
+		return a.isLower();
+
+	if(a.getPositionOnStrand()!=b.getPositionOnStrand())
+		return a.getPositionOnStrand()<b.getPositionOnStrand();
+
+	if(a.getRank()!=b.getRank())
+		return a.getRank()<b.getRank();
+
+	return a.getReadIndex()<b.getReadIndex();
+}
+
+void ReadAnnotationTable::constructor(bool showMemoryAllocations){
+	m_annotations=NULL;
+	m_size=0;
+	m_capacity=0;
+	m_frozen=false;
+	m_showMemoryAllocations=showMemoryAllocations;
+}
+
+void ReadAnnotationTable::allocate(LargeCount annotations){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_annotations==NULL);
+	#endif
+
+	m_capacity=annotations;
+	m_size=0;
+
+	if(m_capacity==0)
+		return;
+
+	m_annotations=(FrozenReadAnnotation*)__Malloc(m_capacity*sizeof(FrozenReadAnnotation),
+		"RAY_MALLOC_TYPE_READ_ANNOTATION_TABLE",m_showMemoryAllocations);
+}
+
+ReadAnnotationCursor ReadAnnotationTable::addAnnotations(vector<ReadAnnotation>*annotations){
+
+	if(annotations->size()==0)
+		return 0;
+
+	#ifdef CONFIG_ASSERT
+	assert(!m_frozen);
+	assert(m_size+annotations->size()<=m_capacity);
+	#endif
+
+	sort(annotations->begin(),annotations->end(),compareReadAnnotations);
+
+	ReadAnnotationCursor first=m_size+1;
+
+	for(int i=0;i<(int)annotations->size();i++){
+		bool last=(i==(int)annotations->size()-1);
+
+		m_annotations[m_size++].constructor(&(annotations->at(i)),last);
+	}
+
+	return first;
+}
+
+void ReadAnnotationTable::freeze(){
+	m_frozen=true;
+}
+
+bool ReadAnnotationTable::isFrozen(){
+	return m_frozen;
+}
+
+ReadAnnotationCursor ReadAnnotationTable::getNextCursor(ReadAnnotationCursor cursor){
+
+	if(m_annotations[cursor-1].isLast())
+		return 0;
+
+	return cursor+1;
+}
+
+/*
+ * The annotations of the lower k-mer are before the others, so
+ * the search stops at the first one of the other k-mer.
+ */
+ReadAnnotationCursor ReadAnnotationTable::skipOtherStrand(ReadAnnotationCursor cursor,bool isLower){
+
+	while(cursor!=0 && m_annotations[cursor-1].isLower()!=isLower){
+		if(isLower)
+			return 0;
+
+		cursor=getNextCursor(cursor);
+	}
+
+	return cursor;
+}
+
+bool ReadAnnotationTable::getNextAnnotation(ReadAnnotationCursor*cursor,bool isLower,ReadAnnotation*annotation){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_frozen);
+	assert(*cursor<=m_size);
+	#endif
+
+	ReadAnnotationCursor position=skipOtherStrand(*cursor,isLower);
+
+	if(position==0){
+		*cursor=0;
+		return false;
+	}
+
+	m_annotations[position-1].getAnnotation(annotation);
+
+	*cursor=skipOtherStrand(getNextCursor(position),isLower);
+
+	return true;
+}
+
+int ReadAnnotationTable::countAnnotations(ReadAnnotationCursor cursor,bool isLower){
+
+	int count=0;
+	ReadAnnotationCursor position=skipOtherStrand(cursor,isLower);
+
+	while(position!=0 && m_annotations[position-1].isLower()==isLower){
+		count++;
+		position=getNextCursor(position);
+	}
+
+	return count;
+}
+
+LargeCount ReadAnnotationTable::size(){
+	return m_size;
+}
+
+void ReadAnnotationTable::destructor(){
+
+	if(m_annotations!=NULL)
+		__Free(m_annotations,"RAY_MALLOC_TYPE_READ_ANNOTATION_TABLE",m_showMemoryAllocations);
+
+	m_annotations=NULL;
+	m_size=0;
+	m_capacity=0;
+	m_frozen=false;
+}
@@ -0,0 +1,125 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _ReadAnnotationTable_h
+#define _ReadAnnotationTable_h
+
+#include "ReadAnnotation.h"
+
+#include <code/Mock/constants.h>
+
+#include <RayPlatform/core/types.h>
+
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+/** the annotation is for the lower k-mer */
+#define FROZEN_READ_ANNOTATION_LOWER 0x1
+/** the annotation is the last one of its vertex */
+#define FROZEN_READ_ANNOTATION_LAST 0x2
+
+/**
+ * A position in the ReadAnnotationTable, plus 1.
+ * 0 means that there are no more annotations.
+ * It is sent to the other ranks to continue a list.
+ */
+typedef LargeIndex ReadAnnotationCursor;
+
+/**
+ * A read annotation in the ReadAnnotationTable.
+ * There is no pointer to the next one, it follows in the table.
+ *
+ * \author Sébastien Boisvert
+ */
+class FrozenReadAnnotation{
+	uint32_t m_readIndex;
+	uint16_t m_rank;
+	uint16_t m_positionOnStrand;
+	Strand m_strand;
+	uint8_t m_flags;
+public:
+	void constructor(ReadAnnotation*annotation,bool last);
+	bool isLower()const;
+	bool isLast()const;
+	void getAnnotation(ReadAnnotation*annotation);
+} ATTRIBUTE_PACKED;
+
+/**
+ * The read annotations of all the vertices of a rank.
+ *
+ * While the sequences are indexed, the annotations of a vertex are a
+ * linked list (ReadAnnotation::getNext) in the allocator of the
+ * SequencesIndexer. They do not change after that, so
+ * GridTable::freezeReadAnnotations copies them here before the seeding:
+ * the annotations of a vertex are contiguous (those of the lower k-mer
+ * first, then sorted by position on the strand) and the
+ * vertex only stores the cursor of its first one. The last one of a
+ * vertex has FROZEN_READ_ANNOTATION_LAST.
+ *
+ * This removes the pointer of each annotation and the lists are read
+ * sequentially.
+ *
+ * \author Sébastien Boisvert
+ */
+class ReadAnnotationTable{
+
+	FrozenReadAnnotation*m_annotations;
+	LargeCount m_size;
+	LargeCount m_capacity;
+	bool m_frozen;
+	bool m_showMemoryAllocations;
+
+	ReadAnnotationCursor getNextCursor(ReadAnnotationCursor cursor);
+	ReadAnnotationCursor skipOtherStrand(ReadAnnotationCursor cursor,bool isLower);
+
+public:
+
+	void constructor(bool showMemoryAllocations);
+
+	/** allocate the table, before the annotations are added */
+	void allocate(LargeCount annotations);
+
+	/**
+	 * Add the annotations of a vertex (they are sorted here).
+	 * Returns the cursor to store in the vertex.
+	 */
+	ReadAnnotationCursor addAnnotations(vector<ReadAnnotation>*annotations);
+
+	void freeze();
+	bool isFrozen();
+
+	/**
+	 * Get the annotation at the cursor (or after it) for the
+	 * k-mer (isLower). The cursor is moved to the next one for that
+	 * k-mer, it is 0 after the last one.
+	 * Returns false if there are none left.
+	 */
+	bool getNextAnnotation(ReadAnnotationCursor*cursor,bool isLower,ReadAnnotation*annotation);
+
+	/** the number of annotations from the cursor for the k-mer (isLower) */
+	int countAnnotations(ReadAnnotationCursor cursor,bool isLower);
+
+	LargeCount size();
+
+	void destructor();
+};
+
+#endif
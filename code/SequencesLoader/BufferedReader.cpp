@@ -140,15 +140,12 @@ int BufferedReader::getBufferSize() {
 
 int BufferedReader::findNewLine(char * sequence, int length) {
 
-	int i = 0;
+	char * newLine = (char *) memchr(sequence, '\n', length);
 
-	while(i < length) {
-		if(sequence[i] == '\n')
-			return i;
-		i++;
-	}
+	if(newLine == NULL)
+		return -1;
 
-	return -1;
+	return newLine - sequence;
 }
 
 bool BufferedReader::copyWithNewLine(char * content) {
@@ -0,0 +1,444 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifdef CONFIG_HAVE_LIBBZ2
+
+#include "Bz2Index.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sstream>
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+/* 0x314159265359 starts a block and 0x177245385090 ends a stream */
+#define BZ2_INDEX_BLOCK_MAGIC 0x314159265359ULL
+#define BZ2_INDEX_END_OF_STREAM_MAGIC 0x177245385090ULL
+#define BZ2_INDEX_MAGIC_BITS 48
+#define BZ2_INDEX_CRC_BITS 32
+
+/* the largest block size, any block can be decompressed with it */
+#define BZ2_INDEX_STREAM_HEADER "BZh9"
+
+void Bz2Index::constructor(){
+	m_file=NULL;
+	m_decompressing=false;
+	m_error=false;
+	m_sequences=0;
+}
+
+/*
+ * Find the magic of every block and of every end of stream.
+ * A block ends where the next magic starts.
+ */
+bool Bz2Index::findBlocks(FILE*stream){
+
+	m_blocks.clear();
+
+	uint64_t mask=(((uint64_t)1)<<BZ2_INDEX_MAGIC_BITS)-1;
+	uint64_t bits=0;
+	uint64_t position=0;
+	bool inBlock=false;
+
+	uint8_t*buffer=(uint8_t*)malloc(BZ2_INDEX_CHUNK);
+	int bytes=0;
+
+	while((bytes=fread(buffer,1,BZ2_INDEX_CHUNK,stream))>0){
+
+		for(int i=0;i<bytes;i++){
+			uint8_t byte=buffer[i];
+
+			for(int bit=7;bit>=0;bit--){
+				bits=((bits<<1)|((byte>>bit)&1))&mask;
+				position++;
+
+				if(bits==BZ2_INDEX_BLOCK_MAGIC){
+					if(inBlock)
+						m_blocks.back().m_end=position-BZ2_INDEX_MAGIC_BITS;
+
+					Bz2Block block;
+					block.m_start=position-BZ2_INDEX_MAGIC_BITS;
+					block.m_end=0;
+					block.m_output=0;
+					m_blocks.push_back(block);
+
+					inBlock=true;
+
+				}else if(bits==BZ2_INDEX_END_OF_STREAM_MAGIC){
+					if(inBlock)
+						m_blocks.back().m_end=position-BZ2_INDEX_MAGIC_BITS;
+
+					inBlock=false;
+				}
+			}
+		}
+	}
+
+	free(buffer);
+
+	/* a truncated file */
+	if(inBlock)
+		return false;
+
+	return true;
+}
+
+/*
+ * Copy a block in a new bzip2 stream that contains only this block.
+ * The stream is: the header, the block, the end-of-stream magic and the
+ * stream CRC, which is the block CRC because there is only one block.
+ */
+bool Bz2Index::prepareBlock(int block){
+
+	#ifdef CONFIG_ASSERT
+	assert(block<(int)m_blocks.size());
+	#endif
+
+	uint64_t start=m_blocks[block].m_start;
+	uint64_t end=m_blocks[block].m_end;
+	uint64_t bits=end-start;
+
+	uint64_t firstByte=start/8;
+	int shift=start%8;
+
+	/* one more byte for the shift */
+	uint64_t bytes=(end+7)/8-firstByte+1;
+
+	vector<uint8_t> source(bytes,0);
+
+	if(fseeko(m_file,firstByte,SEEK_SET)!=0)
+		return false;
+
+	if(fread(&(source[0]),1,bytes,m_file)+1<bytes)
+		return false;
+
+	int headerBytes=strlen(BZ2_INDEX_STREAM_HEADER);
+	uint64_t streamBits=headerBytes*8+bits+BZ2_INDEX_MAGIC_BITS+BZ2_INDEX_CRC_BITS;
+
+	m_blockStream.assign((streamBits+7)/8,0);
+
+	uint8_t*destination=(uint8_t*)&(m_blockStream[0]);
+
+	memcpy(destination,BZ2_INDEX_STREAM_HEADER,headerBytes);
+	destination+=headerBytes;
+
+	/* the header has whole bytes, so the block is copied byte by byte */
+	uint64_t wholeBytes=bits/8;
+
+	for(uint64_t i=0;i<wholeBytes;i++)
+		destination[i]=(source[i]<<shift)|(shift==0?0:(source[i+1]>>(8-shift)));
+
+	uint64_t position=headerBytes*8+wholeBytes*8;
+	uint8_t*stream=(uint8_t*)&(m_blockStream[0]);
+
+	/* the last bits of the block */
+	int remainingBits=bits%8;
+
+	if(remainingBits>0){
+		uint8_t last=(source[wholeBytes]<<shift)|(shift==0?0:(source[wholeBytes+1]>>(8-shift)));
+		stream[position/8]=last&(0xff<<(8-remainingBits));
+		position+=remainingBits;
+	}
+
+	/* the block CRC is after the block magic */
+	uint64_t crc=0;
+
+	for(int i=0;i<BZ2_INDEX_CRC_BITS;i++){
+		uint64_t sourceBit=shift+BZ2_INDEX_MAGIC_BITS+i;
+		crc=(crc<<1)|((source[sourceBit/8]>>(7-sourceBit%8))&1);
+	}
+
+	uint64_t trailer=BZ2_INDEX_END_OF_STREAM_MAGIC;
+
+	for(int i=BZ2_INDEX_MAGIC_BITS-1;i>=0;i--){
+		stream[position/8]|=((trailer>>i)&1)<<(7-position%8);
+		position++;
+	}
+
+	for(int i=BZ2_INDEX_CRC_BITS-1;i>=0;i--){
+		stream[position/8]|=((crc>>i)&1)<<(7-position%8);
+		position++;
+	}
+
+	memset(&m_stream,0,sizeof(bz_stream));
+
+	if(BZ2_bzDecompressInit(&m_stream,0,0)!=BZ_OK)
+		return false;
+
+	m_stream.next_in=&(m_blockStream[0]);
+	m_stream.avail_in=m_blockStream.size();
+
+	m_decompressing=true;
+
+	return true;
+}
+
+/*
+ * Decompress the blocks one after the other. Fewer bytes than
+ * requested are returned only at the end of the file.
+ * With recordBlocks, the uncompressed offset of each block is
+ * recorded when it starts (m_output is updated by countLines).
+ */
+int Bz2Index::decompress(char*buffer,int bytes,bool recordBlocks){
+
+	int produced=0;
+
+	while(produced<bytes){
+
+		if(!m_decompressing){
+			if(m_block>=(int)m_blocks.size())
+				break;
+
+			if(recordBlocks)
+				m_blocks[m_block].m_output=m_output+produced;
+
+			if(!prepareBlock(m_block)){
+				m_block=m_blocks.size();
+				m_error=true;
+				break;
+			}
+		}
+
+		m_stream.next_out=buffer+produced;
+		m_stream.avail_out=bytes-produced;
+
+		int returnValue=BZ2_bzDecompress(&m_stream);
+
+		produced=bytes-m_stream.avail_out;
+
+		/* the end of a block, continue with the next one */
+		if(returnValue==BZ_STREAM_END){
+			BZ2_bzDecompressEnd(&m_stream);
+			m_decompressing=false;
+			m_block++;
+			continue;
+
+		}else if(returnValue!=BZ_OK){
+			BZ2_bzDecompressEnd(&m_stream);
+			m_decompressing=false;
+			m_block=m_blocks.size();
+			m_error=true;
+			break;
+		}
+	}
+
+	return produced;
+}
+
+bool Bz2Index::build(const char*file,int period){
+
+	if(!startCounting(file,period))
+		return false;
+
+	m_file=fopen(file,"rb");
+
+	if(m_file==NULL)
+		return false;
+
+	if(!findBlocks(m_file) || m_blocks.size()==0){
+		fclose(m_file);
+		m_file=NULL;
+		m_blocks.clear();
+		return false;
+	}
+
+	char*buffer=(char*)malloc(BZ2_INDEX_CHUNK);
+
+	m_block=0;
+	m_decompressing=false;
+	m_error=false;
+
+	int bytes=0;
+
+	while((bytes=decompress(buffer,BZ2_INDEX_CHUNK,true))>0)
+		countLines(buffer,bytes);
+
+	free(buffer);
+
+	close();
+
+	if(m_error){
+		m_blocks.clear();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+ * The index is written in a temporary file of this process that is
+ * renamed, so that another rank never loads a partial index.
+ */
+bool Bz2Index::write(const char*file){
+
+	string indexFile=getIndexFile(file);
+
+	ostringstream temporaryName;
+	temporaryName<<indexFile<<".tmp."<<getpid();
+	string temporaryFile=temporaryName.str();
+
+	FILE*stream=fopen(temporaryFile.c_str(),"wb");
+
+	if(stream==NULL)
+		return false;
+
+	writeHeader(stream,BZ2_INDEX_MAGIC);
+
+	writeValue(stream,m_blocks.size());
+
+	for(int i=0;i<(int)m_blocks.size();i++){
+		writeValue(stream,m_blocks[i].m_start);
+		writeValue(stream,m_blocks[i].m_end);
+		writeValue(stream,m_blocks[i].m_output);
+	}
+
+	if(fclose(stream)!=0){
+		remove(temporaryFile.c_str());
+		return false;
+	}
+
+	if(rename(temporaryFile.c_str(),indexFile.c_str())!=0){
+		remove(temporaryFile.c_str());
+		return false;
+	}
+
+	return true;
+}
+
+bool Bz2Index::load(const char*file,int period){
+
+	m_blocks.clear();
+
+	string indexFile=getIndexFile(file);
+
+	FILE*stream=fopen(indexFile.c_str(),"rb");
+
+	if(stream==NULL)
+		return false;
+
+	bool ok=readHeader(stream,BZ2_INDEX_MAGIC,file,period);
+
+	uint64_t blocks=0;
+
+	if(ok)
+		ok=readValue(stream,&blocks);
+
+	for(uint64_t i=0;ok && i<blocks;i++){
+		Bz2Block block;
+
+		ok=readValue(stream,&block.m_start) && readValue(stream,&block.m_end)
+			&& readValue(stream,&block.m_output);
+
+		m_blocks.push_back(block);
+	}
+
+	fclose(stream);
+
+	if(!ok){
+		m_blocks.clear();
+		m_offsets.clear();
+		m_sequences=0;
+	}
+
+	return ok;
+}
+
+bool Bz2Index::openAt(const char*file,uint64_t offset){
+
+	int block=-1;
+
+	for(int i=0;i<(int)m_blocks.size();i++){
+		if(m_blocks[i].m_output>offset)
+			break;
+
+		block=i;
+	}
+
+	if(block<0)
+		return false;
+
+	m_file=fopen(file,"rb");
+
+	if(m_file==NULL)
+		return false;
+
+	m_block=block;
+	m_decompressing=false;
+	m_error=false;
+
+/*
+ * Decompress and discard what is between the start of
+ * the block and the offset.
+ */
+	uint64_t toSkip=offset-m_blocks[block].m_output;
+	char buffer[BZ2_INDEX_CHUNK];
+
+	while(toSkip>0){
+		int bytes=BZ2_INDEX_CHUNK;
+
+		if((uint64_t)bytes>toSkip)
+			bytes=toSkip;
+
+		int got=read(buffer,bytes);
+
+		if(got==0)
+			break;
+
+		toSkip-=got;
+	}
+
+	return toSkip==0;
+}
+
+int Bz2Index::read(char*buffer,int bytes){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_file!=NULL);
+	#endif
+
+	return decompress(buffer,bytes,false);
+}
+
+void Bz2Index::close(){
+
+	if(m_decompressing){
+		BZ2_bzDecompressEnd(&m_stream);
+		m_decompressing=false;
+	}
+
+	if(m_file!=NULL){
+		fclose(m_file);
+		m_file=NULL;
+	}
+
+	m_blockStream.clear();
+}
+
+void Bz2Index::destructor(){
+	close();
+
+	m_blocks.clear();
+	m_offsets.clear();
+	m_sequences=0;
+}
+
+#endif
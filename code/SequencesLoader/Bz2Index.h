@@ -0,0 +1,114 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _Bz2Index_h
+#define _Bz2Index_h
+
+#ifdef CONFIG_HAVE_LIBBZ2
+
+#include "CompressedFileIndex.h"
+
+#include <bzlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+#define BZ2_INDEX_MAGIC "RayBz2Index1"
+
+#define BZ2_INDEX_CHUNK 65536
+
+/**
+ * A bzip2 block, its bits are [m_start, m_end[ in the compressed file.
+ */
+class Bz2Block{
+public:
+	/** position in bits of the block magic */
+	uint64_t m_start;
+
+	/** position in bits of the next magic */
+	uint64_t m_end;
+
+	/** uncompressed offset */
+	uint64_t m_output;
+};
+
+/**
+ * A random access index for bzip2 files.
+ *
+ * bzip2 blocks are independent, but they are not aligned on bytes.
+ * They are found with their 48-bit magic (the digits of pi), like
+ * bzip2recover does. To decompress one block, it is copied in a new
+ * one-block bzip2 stream in memory with a header and an end-of-stream marker.
+ * For a single block, the stream CRC is the block CRC.
+ *
+ * Concatenated streams (pbzip2) are supported.
+ *
+ * \author Sébastien Boisvert
+ */
+class Bz2Index: public CompressedFileIndex{
+
+	vector<Bz2Block> m_blocks;
+
+	/* the reader */
+
+	FILE*m_file;
+	bz_stream m_stream;
+
+	/** a one-block bzip2 stream */
+	vector<char> m_blockStream;
+
+	/** the block being decompressed */
+	int m_block;
+
+	bool m_decompressing;
+	bool m_error;
+
+	bool findBlocks(FILE*stream);
+	bool prepareBlock(int block);
+	int decompress(char*buffer,int bytes,bool recordBlocks);
+
+public:
+
+	void constructor();
+
+	/** build the index with one pass on the file */
+	bool build(const char*file,int period);
+
+	/** load the index of a file, if it exists and if it matches the file */
+	bool load(const char*file,int period);
+
+	/** write the index next to the file */
+	bool write(const char*file);
+
+	/** start reading at an uncompressed offset */
+	bool openAt(const char*file,uint64_t offset);
+
+	/** read uncompressed bytes, returns 0 at the end */
+	int read(char*buffer,int bytes);
+
+	void close();
+
+	void destructor();
+};
+
+#endif
+
+#endif
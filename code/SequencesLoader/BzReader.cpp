@@ -28,9 +28,21 @@
 #include <code/Mock/common_functions.h>
 
 #include <stdlib.h>
+#include <string.h>
 #include <assert.h>
 
+void BzReader::constructor(){
+	m_file=NULL;
+	m_bzFile=NULL;
+	m_buffer=NULL;
+	m_index=NULL;
+
+	m_decompressionThread.constructor();
+}
+
 void BzReader::open(const char*file){
+	close();
+
 	m_file=fopen(file,"r");
 	m_bzFile=NULL;
 	m_buffer=(char*)__Malloc(__BzReader_MAXIMUM_LENGTH*sizeof(char),"RAY_MALLOC_TYPE_BZ2",false);
@@ -39,28 +51,101 @@ void BzReader::open(const char*file){
 
 	m_nUnused=0;
 	m_bytesLoaded=0;
+	m_index=NULL;
+
+	m_decompressionThread.start(this);
 }
 
-char*BzReader::readLine(char*s, int n){
+void BzReader::openAt(Bz2Index*index){
+	close();
+
+	m_file=NULL;
+	m_bzFile=NULL;
+	m_buffer=(char*)__Malloc(__BzReader_MAXIMUM_LENGTH*sizeof(char),"RAY_MALLOC_TYPE_BZ2",false);
+	m_bufferSize=0;
+	m_bufferPosition=0;
+
+	m_nUnused=0;
+	m_bytesLoaded=0;
+	m_index=index;
+
+	m_decompressionThread.start(this);
+}
+
+/*
+ * With CONFIG_PTHREADS, this runs in the thread of m_decompressionThread.
+ * A file can have many bzip2 streams, the unused bytes of one stream
+ * are the beginning of the next one.
+ */
+int BzReader::readBytes(char*buffer,int bytes){
+
+	if(m_index!=NULL)
+		return m_index->read(buffer,bytes);
 
 	int error=BZ_OK;
 	int verbosity=0;
 	int small=0;
 
-	if(m_bzFile==NULL && !feof(m_file)){
+	while(1){
+		if(m_bzFile==NULL){
+			if(feof(m_file))
+				return 0;
+
+			#ifdef __bz2_verbose__
+			cout<<"Opening bz2 file"<<endl;
+			#endif
+
+			m_bzFile=BZ2_bzReadOpen(&error,m_file,verbosity,small,
+				m_unused,m_nUnused);
+
+			if(error!=BZ_OK){
+				cout<<"Error: BZ2_bzReadOpen failed."<<endl;
+				return 0;
+			}
+		}
+
+		int count=BZ2_bzRead(&error,m_bzFile,buffer,bytes);
+
+		if(error==BZ_STREAM_END){
+			#ifdef __bz2_verbose__
+			cout<<"Notice: BZ2_bzRead returned BZ_STREAM_END"<<endl;
+			cout<<"Total bytes: "<<m_bytesLoaded+count<<endl;
+			#endif
+
+			// get unused bytes for the next round
+			BZ2_bzReadGetUnused ( &error, m_bzFile, &m_unused1, &m_nUnused );
+
+			if(error!=BZ_OK)
+				cout<<"Error with BZ2_bzReadGetUnused"<<endl;
+
+			// copy unused bytes
+			memcpy(m_unused,m_unused1,m_nUnused);
+
+			BZ2_bzReadClose ( &error, m_bzFile );
+
+			m_bzFile=NULL;
+
+/* an empty stream gives no bytes, try the next one */
+			if(count==0)
+				continue;
 
-		#ifdef __bz2_verbose__
-		cout<<"Opening bz2 file"<<endl;
-		#endif
+		}else if(error!=BZ_OK){
+			cout<<"Error: BZ2_bzRead did not return BZ_OK or BZ_STREAM_END."<<endl;
 
-		m_bzFile=BZ2_bzReadOpen(&error,m_file,verbosity,small,
-			m_unused,m_nUnused);
+			cout<<"bzFile= "<<m_bzFile<<endl;
+			processError(error);
+			return 0;
+		}
+
+		m_bytesLoaded+=count;
 
-		if(error!=BZ_OK)
-			cout<<"Error: BZ2_bzReadOpen failed."<<endl;
+		return count;
 	}
 
-	//cout<<"[BzReader::readLine]"<<endl;
+	return 0;
+}
+
+char*BzReader::readLine(char*s, int n){
 
 	#ifdef CONFIG_ASSERT
 	if(!(n<=__BzReader_MAXIMUM_LENGTH)){
@@ -70,11 +155,11 @@ char*BzReader::readLine(char*s, int n){
 	#endif
 
 	int pos=-1;
-	for(int i=m_bufferPosition;i<m_bufferSize;i++){
-		if(m_buffer[i]=='\n'){
-			pos=i;
-		}
-	}
+	char*newLine=(char*)memchr(m_buffer+m_bufferPosition,'\n',m_bufferSize-m_bufferPosition);
+
+	if(newLine!=NULL)
+		pos=newLine-m_buffer;
+
 	if(pos!=-1){
 		int i=0;
 		while(m_buffer[m_bufferPosition]!='\n' && m_bufferPosition<m_bufferSize){
@@ -105,57 +190,10 @@ char*BzReader::readLine(char*s, int n){
 		s[i++]=m_buffer[m_bufferPosition++];
 	}
 
-	/* read some bytes from the compressed file */
+	/* get the next decompressed bytes */
 	m_bufferPosition=0;
 
-	m_bufferSize=0;
-
-	if(m_bzFile!=NULL)
-		m_bufferSize=BZ2_bzRead(&error,m_bzFile,m_buffer,__BzReader_MAXIMUM_LENGTH);
-
-	if(error==BZ_STREAM_END){
-		#ifdef __bz2_verbose__
-		// no more thing to read.
-		cout<<"Notice: BZ2_bzRead returned BZ_STREAM_END"<<endl;
-		cout<<"Total bytes: "<<m_bytesLoaded<<endl;
-		#endif
-
-		// get unused bytes for the next round
-		BZ2_bzReadGetUnused ( &error, m_bzFile, &m_unused1, &m_nUnused );
-
-		if(error!=BZ_OK)
-			cout<<"Error with BZ2_bzReadGetUnused"<<endl;
-
-		// copy unused bytes
-		memcpy(m_unused,m_unused1,m_nUnused);
-
-		#ifdef __bz2_verbose__
-		cout<<"Closing file for now."<<endl;
-		#endif
-
-   		BZ2_bzReadClose ( &error, m_bzFile );
-
-		m_bzFile=NULL;
-
-		#ifdef __bz2_verbose__
-		if(feof(m_file))
-			cout<<"Reached end of file, bufferSize is "<<m_bufferSize<<endl;
-		#endif
-
-		// nothing more is available.
-		if(m_bufferSize==0 && feof(m_file)){
-			return NULL;
-		}
-
-	}else if(error!=BZ_OK){
-		cout<<"Error: BZ2_bzRead did not return BZ_OK or BZ_STREAM_END."<<endl;
-
-		cout<<"bzFile= "<<m_bzFile<<endl;
-		processError(error);
-		return NULL;
-	}
-
-	m_bytesLoaded+=m_bufferSize;
+	m_bufferSize=m_decompressionThread.read(m_buffer,__BzReader_MAXIMUM_LENGTH);
 
 	/* copy up to \n (including it) into secondaryBuffer */
 	while(i<n && m_buffer[m_bufferPosition]!='\n' && m_bufferPosition<m_bufferSize){
@@ -187,10 +225,30 @@ char*BzReader::readLine(char*s, int n){
 }
 
 void BzReader::close(){
-	fclose(m_file);
+
+/* the thread must not read anymore */
+	m_decompressionThread.stop();
+
+	if(m_bzFile!=NULL){
+		int error=BZ_OK;
+		BZ2_bzReadClose(&error,m_bzFile);
+	}
+
+	if(m_index!=NULL){
+		m_index->close();
+		m_index=NULL;
+	}
+
+	if(m_file!=NULL)
+		fclose(m_file);
+
 	m_bzFile=NULL;
 	m_file=NULL;
-	__Free(m_buffer,"RAY_MALLOC_TYPE_BZ2",false);
+
+	if(m_buffer!=NULL){
+		__Free(m_buffer,"RAY_MALLOC_TYPE_BZ2",false);
+		m_buffer=NULL;
+	}
 }
 
 void BzReader::processError(int error){
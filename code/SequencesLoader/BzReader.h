@@ -24,14 +24,20 @@
 
 #ifdef CONFIG_HAVE_LIBBZ2
 
+#include "Bz2Index.h"
+#include "DecompressionThread.h"
+
 #include <bzlib.h>
 #include <stdint.h>
 #include <stdio.h>
 
 /**
+ * The decompression is done by a DecompressionThread, so the
+ * next bytes are decompressed while the lines are parsed.
+ *
  * \author Sébastien Boisvert
  */
-class BzReader{
+class BzReader: public ByteSource{
 	BZFILE*m_bzFile;
 	FILE*m_file;
 	char*m_buffer;
@@ -43,11 +49,26 @@ class BzReader{
 	int m_nUnused;
 	void*m_unused1;
 
+	/** when not NULL, the bytes come from the index */
+	Bz2Index*m_index;
+
+	DecompressionThread m_decompressionThread;
+
 	void processError(int error);
 
 public:
+	void constructor();
+
+	/** decompressed bytes of the file or of the index, 0 at the end */
+	int readBytes(char*buffer,int bytes);
+
 	void open(const char*file);
+
+	/** read from an index on which openAt was called */
+	void openAt(Bz2Index*index);
 	char*readLine(char*s, int n);
+
+	/** stop the thread and release everything, it can be called more than once */
 	void close();
 };
 
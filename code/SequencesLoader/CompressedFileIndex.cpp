@@ -0,0 +1,161 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "CompressedFileIndex.h"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <string.h>
+
+bool CompressedFileIndex::readFileStatus(const char*file,uint64_t*size,uint64_t*modificationTime){
+	struct stat status;
+
+	if(stat(file,&status)!=0)
+		return false;
+
+	(*size)=status.st_size;
+	(*modificationTime)=status.st_mtime;
+
+	return true;
+}
+
+string CompressedFileIndex::getIndexFile(const char*file){
+	string indexFile=file;
+	indexFile+=COMPRESSED_FILE_INDEX_SUFFIX;
+	return indexFile;
+}
+
+bool CompressedFileIndex::startCounting(const char*file,int period){
+	m_offsets.clear();
+	m_sequences=0;
+	m_period=period;
+	m_output=0;
+	m_lines=0;
+	m_lineStart=true;
+
+	return readFileStatus(file,&m_fileSize,&m_modificationTime);
+}
+
+/*
+ * Entries have m_period lines, the sequence is the second one.
+ * This is what the loaders do with their rotating variable.
+ */
+void CompressedFileIndex::countLines(const char*data,int bytes){
+	const char*start=data;
+	const char*end=data+bytes;
+
+	while(data<end){
+		if(m_lineStart){
+			uint64_t line=m_lines%m_period;
+
+			if(line==0 && (m_lines/m_period)%LOADER_OFFSET_PERIOD==0)
+				m_offsets.push_back(m_output+(data-start));
+			else if(line==1)
+				m_sequences++;
+
+			m_lineStart=false;
+		}
+
+		const char*newLine=(const char*)memchr(data,'\n',end-data);
+
+		if(newLine==NULL)
+			break;
+
+		m_lines++;
+		m_lineStart=true;
+		data=newLine+1;
+	}
+
+	m_output+=bytes;
+}
+
+bool CompressedFileIndex::writeValue(FILE*stream,uint64_t value){
+	return fwrite(&value,sizeof(uint64_t),1,stream)==1;
+}
+
+bool CompressedFileIndex::readValue(FILE*stream,uint64_t*value){
+	return fread(value,sizeof(uint64_t),1,stream)==1;
+}
+
+void CompressedFileIndex::writeHeader(FILE*stream,const char*magic){
+	fwrite(magic,1,strlen(magic),stream);
+
+	writeValue(stream,m_fileSize);
+	writeValue(stream,m_modificationTime);
+	writeValue(stream,m_period);
+	writeValue(stream,m_sequences);
+	writeValue(stream,m_offsets.size());
+
+	for(int i=0;i<(int)m_offsets.size();i++)
+		writeValue(stream,m_offsets[i]);
+}
+
+bool CompressedFileIndex::readHeader(FILE*stream,const char*magic,const char*file,int period){
+
+	char buffer[32];
+	int length=strlen(magic);
+
+	if((int)fread(buffer,1,length,stream)!=length || memcmp(buffer,magic,length)!=0)
+		return false;
+
+	uint64_t fileSize=0;
+	uint64_t modificationTime=0;
+
+	if(!readFileStatus(file,&fileSize,&modificationTime))
+		return false;
+
+	uint64_t value=0;
+
+	if(!readValue(stream,&m_fileSize) || m_fileSize!=fileSize)
+		return false;
+
+	if(!readValue(stream,&m_modificationTime) || m_modificationTime!=modificationTime)
+		return false;
+
+	if(!readValue(stream,&value) || (int)value!=period)
+		return false;
+
+	m_period=period;
+
+	if(!readValue(stream,&value))
+		return false;
+
+	m_sequences=value;
+
+	if(!readValue(stream,&value))
+		return false;
+
+	m_offsets.resize(value);
+
+	for(int i=0;i<(int)m_offsets.size();i++){
+		if(!readValue(stream,&(m_offsets[i])))
+			return false;
+	}
+
+	return true;
+}
+
+LargeCount CompressedFileIndex::getNumberOfSequences(){
+	return m_sequences;
+}
+
+void CompressedFileIndex::getOffsets(vector<uint64_t>*offsets){
+	(*offsets)=m_offsets;
+}
@@ -0,0 +1,90 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _CompressedFileIndex_h
+#define _CompressedFileIndex_h
+
+#include "LoaderInterface.h"
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+using namespace std;
+
+/** the index of file.fastq.gz is file.fastq.gz.rayindex */
+#define COMPRESSED_FILE_INDEX_SUFFIX ".rayindex"
+
+/**
+ * The common part of the side-car indexes for compressed
+ * sequence files (GzipIndex and Bz2Index) and of the
+ * manifests (SequenceFileManifest).
+ *
+ * An index knows the number of entries in the file and the
+ * uncompressed byte offset of every LOADER_OFFSET_PERIOD entries,
+ * so that the file never needs to be decompressed only to count them.
+ *
+ * The size and the modification time of the compressed file are stored
+ * too. An index that does not match its file is not used.
+ *
+ * \author Sébastien Boisvert
+ */
+class CompressedFileIndex{
+
+	/** lines seen while counting */
+	uint64_t m_lines;
+
+	/** the next byte starts a line */
+	bool m_lineStart;
+
+protected:
+
+	vector<uint64_t> m_offsets;
+	LargeCount m_sequences;
+	int m_period;
+	uint64_t m_fileSize;
+	uint64_t m_modificationTime;
+
+	/** uncompressed bytes seen while counting */
+	uint64_t m_output;
+
+	bool startCounting(const char*file,int period);
+	void countLines(const char*data,int bytes);
+
+	void writeHeader(FILE*stream,const char*magic);
+	bool readHeader(FILE*stream,const char*magic,const char*file,int period);
+
+	bool writeValue(FILE*stream,uint64_t value);
+	bool readValue(FILE*stream,uint64_t*value);
+
+	string getIndexFile(const char*file);
+
+	bool readFileStatus(const char*file,uint64_t*size,uint64_t*modificationTime);
+
+public:
+
+	/** the number of entries (sequences) in the file */
+	LargeCount getNumberOfSequences();
+
+	/** uncompressed byte offsets of every LOADER_OFFSET_PERIOD entries */
+	void getOffsets(vector<uint64_t>*offsets);
+};
+
+#endif
@@ -0,0 +1,205 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "DecompressionThread.h"
+
+#include <RayPlatform/memory/allocator.h>
+
+#include <string.h>
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void DecompressionThread::constructor(){
+	m_source=NULL;
+	m_started=false;
+}
+
+bool DecompressionThread::isStarted(){
+	return m_started;
+}
+
+#ifdef CONFIG_PTHREADS
+
+void DecompressionThread::start(ByteSource*source){
+
+	#ifdef CONFIG_ASSERT
+	assert(!m_started);
+	#endif
+
+	m_source=source;
+	m_started=true;
+
+	for(int i=0;i<DECOMPRESSION_THREAD_BLOCKS;i++){
+		m_blocks[i]=(char*)__Malloc(DECOMPRESSION_THREAD_BLOCK_SIZE*sizeof(char),
+			"RAY_MALLOC_TYPE_DECOMPRESSION_THREAD",false);
+		m_blockBytes[i]=0;
+		m_filledBlocks[i]=false;
+	}
+
+	m_currentBlock=0;
+	m_currentOffset=0;
+	m_stopRequested=false;
+
+	pthread_mutex_init(&m_mutex,NULL);
+	pthread_cond_init(&m_blockFilled,NULL);
+	pthread_cond_init(&m_blockEmptied,NULL);
+
+	pthread_create(&m_thread,NULL,startThread,this);
+}
+
+void*DecompressionThread::startThread(void*object){
+	DecompressionThread*thread=(DecompressionThread*)object;
+
+	thread->fillBlocks();
+
+	return NULL;
+}
+
+/*
+ * This runs in the thread.
+ */
+void DecompressionThread::fillBlocks(){
+
+	int block=0;
+
+	while(1){
+		pthread_mutex_lock(&m_mutex);
+
+		while(m_filledBlocks[block] && !m_stopRequested)
+			pthread_cond_wait(&m_blockEmptied,&m_mutex);
+
+		bool stopRequested=m_stopRequested;
+
+		pthread_mutex_unlock(&m_mutex);
+
+		if(stopRequested)
+			return;
+
+		int bytes=m_source->readBytes(m_blocks[block],DECOMPRESSION_THREAD_BLOCK_SIZE);
+
+		if(bytes<0)
+			bytes=0;
+
+		pthread_mutex_lock(&m_mutex);
+		m_blockBytes[block]=bytes;
+		m_filledBlocks[block]=true;
+		pthread_cond_signal(&m_blockFilled);
+		pthread_mutex_unlock(&m_mutex);
+
+/* the empty block marks the end */
+		if(bytes==0)
+			return;
+
+		block=(block+1)%DECOMPRESSION_THREAD_BLOCKS;
+	}
+}
+
+/*
+ * Like gzread and fread, fewer bytes are returned only at the end.
+ */
+int DecompressionThread::read(char*buffer,int bytes){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_started);
+	#endif
+
+	int copied=0;
+
+	while(copied<bytes){
+		pthread_mutex_lock(&m_mutex);
+
+		while(!m_filledBlocks[m_currentBlock])
+			pthread_cond_wait(&m_blockFilled,&m_mutex);
+
+		pthread_mutex_unlock(&m_mutex);
+
+		int available=m_blockBytes[m_currentBlock]-m_currentOffset;
+
+/* the last block is empty and it stays filled, so the next calls return 0 too */
+		if(available==0)
+			break;
+
+		int count=bytes-copied;
+
+		if(count>available)
+			count=available;
+
+		memcpy(buffer+copied,m_blocks[m_currentBlock]+m_currentOffset,count);
+		copied+=count;
+		m_currentOffset+=count;
+
+		if(m_currentOffset==m_blockBytes[m_currentBlock]){
+			pthread_mutex_lock(&m_mutex);
+			m_filledBlocks[m_currentBlock]=false;
+			pthread_cond_signal(&m_blockEmptied);
+			pthread_mutex_unlock(&m_mutex);
+
+			m_currentBlock=(m_currentBlock+1)%DECOMPRESSION_THREAD_BLOCKS;
+			m_currentOffset=0;
+		}
+	}
+
+	return copied;
+}
+
+void DecompressionThread::stop(){
+
+	if(!m_started)
+		return;
+
+	pthread_mutex_lock(&m_mutex);
+	m_stopRequested=true;
+	pthread_cond_signal(&m_blockEmptied);
+	pthread_mutex_unlock(&m_mutex);
+
+	pthread_join(m_thread,NULL);
+
+	pthread_mutex_destroy(&m_mutex);
+	pthread_cond_destroy(&m_blockFilled);
+	pthread_cond_destroy(&m_blockEmptied);
+
+	for(int i=0;i<DECOMPRESSION_THREAD_BLOCKS;i++){
+		__Free(m_blocks[i],"RAY_MALLOC_TYPE_DECOMPRESSION_THREAD",false);
+		m_blocks[i]=NULL;
+	}
+
+	m_source=NULL;
+	m_started=false;
+}
+
+#else
+
+void DecompressionThread::start(ByteSource*source){
+	m_source=source;
+	m_started=true;
+}
+
+int DecompressionThread::read(char*buffer,int bytes){
+	return m_source->readBytes(buffer,bytes);
+}
+
+void DecompressionThread::stop(){
+	m_source=NULL;
+	m_started=false;
+}
+
+#endif
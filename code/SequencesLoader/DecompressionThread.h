@@ -0,0 +1,105 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _DecompressionThread_h
+#define _DecompressionThread_h
+
+#include <code/Mock/constants.h>
+
+#ifdef CONFIG_PTHREADS
+#include <pthread.h>
+#endif
+
+/** number of blocks between the thread and the rank */
+#define DECOMPRESSION_THREAD_BLOCKS 2
+
+/** bytes in a block */
+#define DECOMPRESSION_THREAD_BLOCK_SIZE SIZE_4M
+
+/**
+ * Something that gives decompressed bytes.
+ *
+ * \author Sébastien Boisvert
+ */
+class ByteSource{
+public:
+	/** returns the number of bytes read, 0 at the end */
+	virtual int readBytes(char*buffer,int bytes)=0;
+
+	virtual ~ByteSource(){}
+};
+
+/**
+ * Decompresses a file in the background.
+ *
+ * With CONFIG_PTHREADS, a thread calls ByteSource::readBytes
+ * (gzread, BZ2_bzRead or an index) and fills the blocks while the rank
+ * splits the lines of the previous block and builds the Read objects.
+ * There are DECOMPRESSION_THREAD_BLOCKS blocks, so the thread is at
+ * most that many blocks ahead.
+ *
+ * Without CONFIG_PTHREADS, read() calls ByteSource::readBytes directly.
+ *
+ * The source must not be used by anything else between start() and stop().
+ *
+ * \author Sébastien Boisvert
+ */
+class DecompressionThread{
+
+	ByteSource*m_source;
+	bool m_started;
+
+#ifdef CONFIG_PTHREADS
+	char*m_blocks[DECOMPRESSION_THREAD_BLOCKS];
+	int m_blockBytes[DECOMPRESSION_THREAD_BLOCKS];
+	bool m_filledBlocks[DECOMPRESSION_THREAD_BLOCKS];
+
+	/** the block that the rank reads */
+	int m_currentBlock;
+	int m_currentOffset;
+
+	bool m_stopRequested;
+
+	pthread_t m_thread;
+	pthread_mutex_t m_mutex;
+	pthread_cond_t m_blockFilled;
+	pthread_cond_t m_blockEmptied;
+
+	void fillBlocks();
+	static void*startThread(void*object);
+#endif
+
+public:
+
+	void constructor();
+
+	/** start to read from the source */
+	void start(ByteSource*source);
+
+	/** same as ByteSource::readBytes */
+	int read(char*buffer,int bytes);
+
+	/** wait for the thread, the source can be closed after */
+	void stop();
+
+	bool isStarted();
+};
+
+#endif
@@ -48,4 +48,13 @@ void FastaBz2Loader::close(){
 	m_fastqBz2Loader.close();
 }
 
+void FastaBz2Loader::getOffsets(vector<uint64_t>*offsets){
+	m_fastqBz2Loader.getOffsets(offsets);
+}
+
+int FastaBz2Loader::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return m_fastqBz2Loader.openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,2);
+}
+
 #endif
@@ -49,5 +49,14 @@ void FastaGzLoader::close(){
 	m_fastqGzLoader.close();
 }
 
+void FastaGzLoader::getOffsets(vector<uint64_t>*offsets){
+	m_fastqGzLoader.getOffsets(offsets);
+}
+
+int FastaGzLoader::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return m_fastqGzLoader.openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,2);
+}
+
 #endif
 
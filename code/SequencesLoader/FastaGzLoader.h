@@ -49,6 +49,9 @@ public:
 	int getSize();
 	void load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator);
 	void close();
+	void getOffsets(vector<uint64_t>*offsets);
+	int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
 };
 
 #endif
@@ -47,3 +47,16 @@ int FastaLoaderForReads::getSize(){
 void FastaLoaderForReads::close(){
 	m_fastqLoader.close();
 }
+
+void FastaLoaderForReads::getOffsets(vector<uint64_t>*offsets){
+	m_fastqLoader.getOffsets(offsets);
+}
+
+bool FastaLoaderForReads::getLengths(vector<LargeCount>*lengths){
+	return m_fastqLoader.getLengths(lengths);
+}
+
+int FastaLoaderForReads::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return m_fastqLoader.openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,2);
+}
@@ -48,6 +48,10 @@ public:
 	int getSize();
 	void load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator);
 	void close();
+	void getOffsets(vector<uint64_t>*offsets);
+	bool getLengths(vector<LargeCount>*lengths);
+	int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
 };
 
 #endif
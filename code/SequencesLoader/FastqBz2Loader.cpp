@@ -25,12 +25,18 @@
 #include "BzReader.h"
 
 #include <stdlib.h>
+#include <assert.h>
 #include <fstream>
 using namespace std;
 
 FastqBz2Loader::FastqBz2Loader() {
 	addExtension(".fq.bz2");
 	addExtension(".fastq.bz2");
+
+	m_index.constructor();
+	m_reader.constructor();
+	m_size=0;
+	m_loaded=0;
 }
 
 int FastqBz2Loader::getSize(){
@@ -41,11 +47,44 @@ int FastqBz2Loader::open(string file){
 	return openWithPeriod(file,4);
 }
 
+/*
+ * The side-car index has the number of entries. If there is
+ * none, it is built: this is the pass that counts the entries anyway.
+ */
+bool FastqBz2Loader::countWithIndex(string file,int period){
+	bool indexed=m_index.load(file.c_str(),period);
+
+	if(!indexed && m_index.build(file.c_str(),period)){
+		indexed=true;
+
+		if(m_index.write(file.c_str()))
+			cout<<"Wrote "<<file<<COMPRESSED_FILE_INDEX_SUFFIX<<endl;
+	}
+
+	if(!indexed)
+		return false;
+
+	m_size=m_index.getNumberOfSequences();
+	m_index.getOffsets(&m_offsets);
+	m_index.destructor();
+
+	return true;
+}
+
 int FastqBz2Loader::openWithPeriod(string file,int period){
-	m_reader.open(file.c_str());
-	char buffer[RAY_MAXIMUM_READ_LENGTH];
+	close();
+
 	m_loaded=0;
 	m_size=0;
+	m_offsets.clear();
+
+	if(countWithIndex(file,period)){
+		m_reader.open(file.c_str());
+		return EXIT_SUCCESS;
+	}
+
+	m_reader.open(file.c_str());
+	char buffer[RAY_MAXIMUM_READ_LENGTH];
 
 	int rotatingVariable=0;
 	while(NULL!=m_reader.readLine(buffer,RAY_MAXIMUM_READ_LENGTH)){
@@ -89,11 +128,64 @@ void FastqBz2Loader::loadWithPeriod(int maxToLoad,ArrayOfReads*reads,MyAllocator
 		}
 	}
 	if(m_loaded==m_size){
-		m_reader.close();
+		close();
 	}
 }
 
+/*
+ * A rank can stop before the end of the file, so everything is
+ * released here and not only after the last sequence.
+ */
 void FastqBz2Loader::close(){
+	m_reader.close();
+	m_index.destructor();
+}
+
+void FastqBz2Loader::getOffsets(vector<uint64_t>*offsets){
+	(*offsets)=m_offsets;
+}
+
+int FastqBz2Loader::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,4);
+}
+
+/*
+ * Without the side-car index, there is no way to seek in a bzip2 file.
+ * With it, only the block that contains the offset is decompressed.
+ */
+int FastqBz2Loader::openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period){
+
+	#ifdef CONFIG_ASSERT
+	assert(indexedSequence<=sequence);
+	assert(sequence<sequences);
+	#endif
+
+	close();
+
+	if(!m_index.load(file.c_str(),period) || !m_index.openAt(file.c_str(),offset)){
+		m_index.destructor();
+		return EXIT_FAILURE;
+	}
+
+	m_reader.openAt(&m_index);
+
+	char buffer[RAY_MAXIMUM_READ_LENGTH];
+	LargeCount linesToSkip=(sequence-indexedSequence)*period;
+
+	while(linesToSkip>0 && NULL!=m_reader.readLine(buffer,RAY_MAXIMUM_READ_LENGTH))
+		linesToSkip--;
+
+	if(linesToSkip>0){
+		close();
+		return EXIT_FAILURE;
+	}
+
+	m_size=sequences;
+	m_loaded=sequence;
+
+	return EXIT_SUCCESS;
 }
 
 #endif
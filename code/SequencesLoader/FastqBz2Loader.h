@@ -28,6 +28,7 @@
 #include "ArrayOfReads.h"
 #include "Read.h"
 #include "BzReader.h"
+#include "Bz2Index.h"
 
 #include <RayPlatform/memory/MyAllocator.h>
 
@@ -42,6 +43,12 @@ class FastqBz2Loader: public LoaderInterface{
 	int m_loaded;
 	int m_size;
 	BzReader m_reader;
+	Bz2Index m_index;
+
+	/** uncompressed byte offsets of every LOADER_OFFSET_PERIOD sequences */
+	vector<uint64_t> m_offsets;
+
+	bool countWithIndex(string file,int period);
 public:
 	FastqBz2Loader();
 	int openWithPeriod(string file,int period);
@@ -50,6 +57,11 @@ public:
 	void load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator);
 	void loadWithPeriod(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator,int period);
 	void close();
+	int openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period);
+	void getOffsets(vector<uint64_t>*offsets);
+	int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
 };
 
 #endif
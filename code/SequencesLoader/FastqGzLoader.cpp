@@ -31,11 +31,25 @@
 #include <fstream>
 #include <zlib.h>
 #include <stdlib.h>
+#include <string.h>
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
 using namespace std;
 
 FastqGzLoader::FastqGzLoader() {
 	addExtension(".fastq.gz");
 	addExtension(".fq.gz");
+
+	m_index.constructor();
+	m_useIndex=false;
+	m_f=NULL;
+	m_readaheadBuffer=NULL;
+	m_bufferedBytes=0;
+	m_size=0;
+	m_loaded=0;
+
+	m_decompressionThread.constructor();
 }
 
 int FastqGzLoader::open(string file){
@@ -44,6 +58,8 @@ int FastqGzLoader::open(string file){
 
 int FastqGzLoader::openWithPeriod(string file,int period){
 
+	close();
+
 	m_debug=false;
 
 	m_completed=false;
@@ -54,13 +70,48 @@ int FastqGzLoader::openWithPeriod(string file,int period){
 	m_noMoreBytes=false;
 #endif
 
-	m_f=gzopen(file.c_str(),"r");
-	char buffer[CONFIG_ZLIB_MAXIMUM_READ_LENGTH];
+	m_useIndex=false;
 	m_size=0;
 	m_loaded=0;
 
+/*
+ * The side-car index has the number of entries. If there is
+ * none, it is built: this is the pass that counts the entries anyway.
+ */
+	bool indexed=m_index.load(file.c_str(),period);
+
+	if(!indexed && m_index.build(file.c_str(),period)){
+		indexed=true;
+
+		if(m_index.write(file.c_str()))
+			cout<<"Wrote "<<file<<COMPRESSED_FILE_INDEX_SUFFIX<<endl;
+	}
+
+	if(indexed){
+		m_size=m_index.getNumberOfSequences();
+		m_index.getOffsets(&m_offsets);
+		m_index.destructor();
+
+		m_f=gzopen(file.c_str(),"r");
+
+		return EXIT_SUCCESS;
+	}
+
+	m_f=gzopen(file.c_str(),"r");
+	char buffer[CONFIG_ZLIB_MAXIMUM_READ_LENGTH];
+
+	m_offsets.clear();
+	uint64_t offset=0;
+
 	int rotatingVariable=0;
 	while(readOneSingleLine(buffer,CONFIG_ZLIB_MAXIMUM_READ_LENGTH)){
+
+		if(rotatingVariable==0 && m_size%LOADER_OFFSET_PERIOD==0){
+			m_offsets.push_back(offset);
+		}
+
+		offset+=strlen(buffer);
+
 		if(rotatingVariable==1){
 			m_size++;
 		}
@@ -69,19 +120,81 @@ int FastqGzLoader::openWithPeriod(string file,int period){
 			rotatingVariable=0;
 		}
 	}
-	gzclose(m_f);
+	close();
 	m_f=gzopen(file.c_str(),"r");
 
+#ifdef CONFIG_ZLIB_USE_READAHEAD
+	m_noMoreBytes=false;
+	m_completed=false;
+#endif
+
+	return EXIT_SUCCESS;
+}
+
+int FastqGzLoader::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,4);
+}
+
+/*
+ * With the side-car index, inflate starts at the closest access point.
+ * Otherwise, gzseek inflates everything before the offset, but
+ * the lines are not parsed and the entries are not counted again.
+ */
+int FastqGzLoader::openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period){
+
+	#ifdef CONFIG_ASSERT
+	assert(indexedSequence<=sequence);
+	assert(sequence<sequences);
+	#endif
+
+	close();
+
+	m_debug=false;
+	m_completed=false;
+
+	if(m_index.load(file.c_str(),period) && m_index.openAt(file.c_str(),offset)){
+		m_useIndex=true;
+	}else{
+		m_index.destructor();
+
+		m_f=gzopen(file.c_str(),"r");
+
+		if(m_f==NULL)
+			return EXIT_FAILURE;
+
+		if(gzseek(m_f,offset,SEEK_SET)!=(z_off_t)offset){
+			close();
+			return EXIT_FAILURE;
+		}
+	}
+
 #ifdef CONFIG_ZLIB_USE_READAHEAD
 	m_bufferedBytes=0;
 	m_readaheadBuffer=NULL;
 	m_noMoreBytes=false;
-	m_completed=false;
 #endif
 
+	m_offsets.clear();
+	m_size=sequences;
+
+	char buffer[CONFIG_ZLIB_MAXIMUM_READ_LENGTH];
+	LargeCount linesToSkip=(sequence-indexedSequence)*period;
+
+	while(linesToSkip>0 && readOneSingleLine(buffer,CONFIG_ZLIB_MAXIMUM_READ_LENGTH)){
+		linesToSkip--;
+	}
+
+	m_loaded=sequence;
+
 	return EXIT_SUCCESS;
 }
 
+void FastqGzLoader::getOffsets(vector<uint64_t>*offsets){
+	(*offsets)=m_offsets;
+}
+
 void FastqGzLoader::load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator){
 	loadWithPeriod(maxToLoad,reads,seqMyAllocator,4);
 }
@@ -108,10 +221,17 @@ void FastqGzLoader::loadWithPeriod(int maxToLoad,ArrayOfReads*reads,MyAllocator*
 		}
 	}
 	if(m_loaded==m_size){
-		gzclose(m_f);
+		close();
 	}
 }
 
+int FastqGzLoader::readBytes(char*buffer,int bytes){
+	if(m_useIndex)
+		return m_index.read(buffer,bytes);
+
+	return gzread(m_f,buffer,bytes);
+}
+
 int FastqGzLoader::getSize(){
 	return m_size;
 }
@@ -153,6 +273,8 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 		#ifdef CONFIG_ASSERT
 		assert(m_readaheadBuffer!=NULL);
 		#endif
+
+		m_decompressionThread.start(this);
 	}
 
 	#ifdef CONFIG_ASSERT
@@ -169,12 +291,8 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 		if(m_debug)
 			cout<<"Moving data around"<<endl;
 
-		int destination=0;
-
 /* move data on the left to make room */
-		for(int i=m_currentStart;i<m_bufferedBytes;i++){
-			m_readaheadBuffer[destination++]=m_readaheadBuffer[i];
-		}
+		memmove(m_readaheadBuffer,m_readaheadBuffer+m_currentStart,m_bufferedBytes-m_currentStart);
 
 		m_bufferedBytes-=m_currentStart;
 		m_firstNewLine-=m_currentStart;
@@ -193,12 +311,12 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 
 		assert(m_bufferedBytes<=CONFIG_ZLIB_READAHEAD_SIZE);
 
-		assert(m_f!=NULL);
+		assert(m_useIndex || m_f!=NULL);
 		assert(m_readaheadBuffer!=NULL);
 
 		#endif
 
-		int bytes=gzread(m_f,m_readaheadBuffer+m_bufferedBytes,CONFIG_ZLIB_READAHEAD_SIZE);
+		int bytes=m_decompressionThread.read(m_readaheadBuffer+m_bufferedBytes,CONFIG_ZLIB_READAHEAD_SIZE);
 		m_bufferedBytes+=bytes;
 
 		if(bytes==0)
@@ -214,11 +332,15 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 		cout<<"Searching for new line at m_firstNewLine "<<m_firstNewLine<<endl;
 	
 /* find the next new line */
-	while(m_firstNewLine<m_bufferedBytes && m_readaheadBuffer[m_firstNewLine]!='\n')
-		m_firstNewLine++;
+	char*newLine=NULL;
+
+	if(m_firstNewLine<m_bufferedBytes)
+		newLine=(char*)memchr(m_readaheadBuffer+m_firstNewLine,'\n',m_bufferedBytes-m_firstNewLine);
 
-	if(m_firstNewLine==m_bufferedBytes)
-		m_firstNewLine--;
+	if(newLine!=NULL)
+		m_firstNewLine=newLine-m_readaheadBuffer;
+	else
+		m_firstNewLine=m_bufferedBytes-1;
 
 	if(m_debug)
 		cout<<"seek offset if at m_firstNewLine "<<m_firstNewLine<<endl;
@@ -249,6 +371,8 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 			cout<<endl;
 		}
 
+		m_decompressionThread.stop();
+
 		free(m_readaheadBuffer);
 		m_readaheadBuffer=NULL;
 		m_bufferedBytes=0;
@@ -298,7 +422,28 @@ bool FastqGzLoader::pullLineWithReadaheadTechnology(char*buffer,int maximumLengt
 	return true;
 }
 
+/*
+ * A rank can stop before the end of the file, so everything is
+ * released here and not only after the last sequence.
+ * The thread is stopped first, it reads from m_f or m_index.
+ */
 void FastqGzLoader::close(){
+	m_decompressionThread.stop();
+
+	if(m_useIndex)
+		m_index.destructor();
+	else if(m_f!=NULL)
+		gzclose(m_f);
+
+	m_f=NULL;
+	m_useIndex=false;
+
+	if(m_readaheadBuffer!=NULL){
+		free(m_readaheadBuffer);
+		m_readaheadBuffer=NULL;
+	}
+
+	m_bufferedBytes=0;
 }
 
 #endif
@@ -25,6 +25,8 @@
 #ifdef CONFIG_HAVE_LIBZ
 
 #include "LoaderInterface.h"
+#include "GzipIndex.h"
+#include "DecompressionThread.h"
 #include "Read.h"
 #include "ArrayOfReads.h"
 
@@ -38,9 +40,13 @@ using namespace std;
 
 /**
  * This class is responsible for reading .fastq.gz files.
+ *
+ * gzread (or the index) is called by m_decompressionThread, so
+ * inflate runs while the lines are parsed.
+ *
  * \author Sébastien Boisvert
  */
-class FastqGzLoader: public LoaderInterface{
+class FastqGzLoader: public LoaderInterface, public ByteSource{
 
 	bool m_completed;
 	bool m_noMoreBytes;
@@ -57,18 +63,37 @@ class FastqGzLoader: public LoaderInterface{
 	int m_size;
 	int m_loaded;
 
+	/** uncompressed byte offsets of every LOADER_OFFSET_PERIOD sequences */
+	vector<uint64_t> m_offsets;
+
+	GzipIndex m_index;
+
+	/** read with the index instead of m_f */
+	bool m_useIndex;
+
+	DecompressionThread m_decompressionThread;
+
 	bool readOneSingleLine(char*buffer,int maximumLength);
 	bool pullLineWithReadaheadTechnology(char*buffer,int maximumLength);
 
 public:
 	FastqGzLoader();
+
+	/** decompressed bytes of the file or of the index, 0 at the end */
+	int readBytes(char*buffer,int bytes);
+
 	int openWithPeriod(string file,int period);
 	void loadWithPeriod(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator,int period);
+	int openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period);
 
 	int open(string file);
 	int getSize();
 	void load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator);
 	void close();
+	void getOffsets(vector<uint64_t>*offsets);
+	int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
 };
 
 #endif
@@ -25,6 +25,10 @@
 
 #include <fstream>
 #include <stdlib.h>
+#include <string.h>
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
 using namespace std;
 
 FastqLoader::FastqLoader() {
@@ -32,6 +36,7 @@ FastqLoader::FastqLoader() {
 	addExtension(".fq");
 
 	m_f = NULL;
+	m_hasLengths = false;
 }
 
 int FastqLoader::open(string file){
@@ -50,6 +55,12 @@ int FastqLoader::openWithPeriod(string file,int period){
 	int rotatingVariable=0;
 	char buffer[RAY_MAXIMUM_READ_LENGTH];
 
+	m_offsets.clear();
+	uint64_t offset=0;
+
+	m_lengths.clear();
+	m_hasLengths=true;
+
 	while(NULL!= m_lineReader.readLine(buffer,RAY_MAXIMUM_READ_LENGTH,m_f)){
 
 		/*
@@ -57,7 +68,28 @@ int FastqLoader::openWithPeriod(string file,int period){
 			//cout << "[DEBUG] buffer= " << buffer << endl;
 			*/
 
+/*
+ * Keep the offset of the first line of some entries
+ * so that the file can be loaded from the middle later on.
+ */
+		if(rotatingVariable==0 && m_size%LOADER_OFFSET_PERIOD==0){
+			m_offsets.push_back(offset);
+		}
+
+		int length=strlen(buffer);
+		offset+=length;
+
 		if(rotatingVariable==1){
+
+/* the new line is not a nucleotide */
+			while(length>0 && (buffer[length-1]=='\n' || buffer[length-1]=='\r'))
+				length--;
+
+			if(length>=(int)m_lengths.size())
+				m_lengths.resize(length+1,0);
+
+			m_lengths[length]++;
+
 			m_size++;
 		}
 		rotatingVariable++;
@@ -81,6 +113,64 @@ int FastqLoader::openWithPeriod(string file,int period){
 	return EXIT_SUCCESS;
 }
 
+int FastqLoader::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return openAtWithPeriod(file,sequences,sequence,indexedSequence,offset,4);
+}
+
+/*
+ * Go directly to the entry indexedSequence and skip the lines
+ * up to the entry sequence. The entries are not counted again.
+ */
+int FastqLoader::openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period){
+
+	#ifdef CONFIG_ASSERT
+	assert(indexedSequence<=sequence);
+	assert(sequence<sequences);
+	#endif
+
+	m_f=fopen(file.c_str(),"r");
+
+	if(m_f==NULL)
+		return EXIT_FAILURE;
+
+	if(fseeko(m_f,offset,SEEK_SET)!=0){
+		fclose(m_f);
+		m_f=NULL;
+		return EXIT_FAILURE;
+	}
+
+	m_lineReader.initialize();
+
+	m_offsets.clear();
+	m_lengths.clear();
+	m_hasLengths=false;
+	m_size=sequences;
+	m_loaded=indexedSequence;
+
+	char buffer[RAY_MAXIMUM_READ_LENGTH];
+	LargeCount linesToSkip=(sequence-indexedSequence)*period;
+
+	while(linesToSkip>0 && NULL!=m_lineReader.readLine(buffer,RAY_MAXIMUM_READ_LENGTH,m_f)){
+		linesToSkip--;
+	}
+
+	m_loaded=sequence;
+
+	return EXIT_SUCCESS;
+}
+
+void FastqLoader::getOffsets(vector<uint64_t>*offsets){
+	(*offsets)=m_offsets;
+}
+
+bool FastqLoader::getLengths(vector<LargeCount>*lengths){
+	(*lengths)=m_lengths;
+
+	return m_hasLengths;
+}
+
 void FastqLoader::load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator){
 
 	//cout << "[DEBUG] loading fastq file maxToLoad= " << maxToLoad << endl;
@@ -46,15 +46,28 @@ class FastqLoader: public LoaderInterface{
 	int m_size;
 	FILE*m_f;
 
+	/** byte offsets of every LOADER_OFFSET_PERIOD sequences */
+	vector<uint64_t> m_offsets;
+
+	/** histogram of the lengths of the sequences seen while counting */
+	vector<LargeCount> m_lengths;
+	bool m_hasLengths;
+
 public:
 	FastqLoader();
 	void loadWithPeriod(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator,int period);
 	int openWithPeriod(string file,int period);
+	int openAtWithPeriod(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset,int period);
 
 	int open(string file);
 	int getSize();
 	void load(int maxToLoad,ArrayOfReads*reads,MyAllocator*seqMyAllocator);
 	void close();
+	void getOffsets(vector<uint64_t>*offsets);
+	bool getLengths(vector<LargeCount>*lengths);
+	int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
 };
 
 #endif
@@ -0,0 +1,436 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifdef CONFIG_HAVE_LIBZ
+
+#include "GzipIndex.h"
+
+#include <stdlib.h>
+#include <string.h>
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+/* windowBits for a raw deflate stream and for a gzip stream */
+#define GZIP_INDEX_RAW -15
+#define GZIP_INDEX_GZIP 31
+
+/* the gzip trailer has a CRC-32 and a size */
+#define GZIP_INDEX_TRAILER_BYTES 8
+
+void GzipIndex::constructor(){
+	m_file=NULL;
+	m_input=NULL;
+	m_sequences=0;
+}
+
+void GzipIndex::addAccessPoint(int bits,uint64_t input,uint64_t output,uint8_t*window,int left){
+
+	GzipAccessPoint point;
+	point.m_bits=bits;
+	point.m_input=input;
+	point.m_output=output;
+	m_points.push_back(point);
+
+	int first=m_windows.size();
+	m_windows.resize(first+GZIP_INDEX_WINDOW_SIZE);
+
+	uint8_t*destination=&(m_windows[first]);
+
+/*
+ * The window is circular, the oldest bytes are after
+ * the last output.
+ */
+	if(left>0)
+		memcpy(destination,window+GZIP_INDEX_WINDOW_SIZE-left,left);
+
+	if(left<GZIP_INDEX_WINDOW_SIZE)
+		memcpy(destination+left,window,GZIP_INDEX_WINDOW_SIZE-left);
+}
+
+bool GzipIndex::build(const char*file,int period){
+
+	m_points.clear();
+	m_windows.clear();
+
+	if(!startCounting(file,period))
+		return false;
+
+	FILE*stream=fopen(file,"rb");
+
+	if(stream==NULL)
+		return false;
+
+	z_stream inflater;
+	memset(&inflater,0,sizeof(z_stream));
+
+	if(inflateInit2(&inflater,GZIP_INDEX_GZIP)!=Z_OK){
+		fclose(stream);
+		return false;
+	}
+
+	uint8_t*input=(uint8_t*)malloc(GZIP_INDEX_CHUNK);
+	uint8_t*window=(uint8_t*)malloc(GZIP_INDEX_WINDOW_SIZE);
+
+	memset(window,0,GZIP_INDEX_WINDOW_SIZE);
+
+	uint64_t totalInput=0;
+	uint64_t totalOutput=0;
+	uint64_t last=0;
+	int returnValue=Z_OK;
+
+	inflater.avail_in=0;
+	inflater.avail_out=0;
+
+	while(1){
+		if(inflater.avail_in==0){
+			inflater.avail_in=fread(input,1,GZIP_INDEX_CHUNK,stream);
+			inflater.next_in=input;
+
+			if(inflater.avail_in==0)
+				break;
+		}
+
+		if(inflater.avail_out==0){
+			inflater.avail_out=GZIP_INDEX_WINDOW_SIZE;
+			inflater.next_out=window;
+		}
+
+		uint8_t*start=inflater.next_out;
+
+/*
+ * Z_BLOCK stops at the end of each deflate block.
+ */
+		totalInput+=inflater.avail_in;
+		totalOutput+=inflater.avail_out;
+		returnValue=inflate(&inflater,Z_BLOCK);
+		totalInput-=inflater.avail_in;
+		totalOutput-=inflater.avail_out;
+
+		countLines((char*)start,inflater.next_out-start);
+
+		if(returnValue==Z_NEED_DICT || returnValue==Z_DATA_ERROR || returnValue==Z_MEM_ERROR)
+			break;
+
+		if(returnValue==Z_STREAM_END){
+
+			/* another gzip member may follow */
+			if(inflater.avail_in==0){
+				int character=getc(stream);
+
+				if(character==EOF)
+					break;
+
+				ungetc(character,stream);
+			}
+
+			inflateReset(&inflater);
+			continue;
+		}
+
+/*
+ * bit 128 is set at the end of a block, bit 64 is set
+ * after the last block.
+ */
+		if((inflater.data_type&128) && !(inflater.data_type&64)
+			&& (totalOutput==0 || totalOutput-last>=GZIP_INDEX_SPAN)){
+
+			addAccessPoint(inflater.data_type&7,totalInput,totalOutput,window,inflater.avail_out);
+			last=totalOutput;
+		}
+	}
+
+	inflateEnd(&inflater);
+	free(input);
+	free(window);
+	fclose(stream);
+
+	if(returnValue!=Z_STREAM_END){
+		m_points.clear();
+		m_windows.clear();
+		return false;
+	}
+
+	return true;
+}
+
+bool GzipIndex::write(const char*file){
+
+	string indexFile=getIndexFile(file);
+
+	FILE*stream=fopen(indexFile.c_str(),"wb");
+
+	if(stream==NULL)
+		return false;
+
+	writeHeader(stream,GZIP_INDEX_MAGIC);
+
+	writeValue(stream,m_points.size());
+
+	for(int i=0;i<(int)m_points.size();i++){
+		writeValue(stream,m_points[i].m_output);
+		writeValue(stream,m_points[i].m_input);
+		writeValue(stream,m_points[i].m_bits);
+	}
+
+	bool ok=true;
+
+	if(m_windows.size()>0)
+		ok=fwrite(&(m_windows[0]),1,m_windows.size(),stream)==m_windows.size();
+
+	if(fclose(stream)!=0)
+		ok=false;
+
+	if(!ok)
+		remove(indexFile.c_str());
+
+	return ok;
+}
+
+bool GzipIndex::load(const char*file,int period){
+
+	m_points.clear();
+	m_windows.clear();
+
+	string indexFile=getIndexFile(file);
+
+	FILE*stream=fopen(indexFile.c_str(),"rb");
+
+	if(stream==NULL)
+		return false;
+
+	bool ok=readHeader(stream,GZIP_INDEX_MAGIC,file,period);
+
+	uint64_t points=0;
+
+	if(ok)
+		ok=readValue(stream,&points);
+
+	for(uint64_t i=0;ok && i<points;i++){
+		GzipAccessPoint point;
+
+		ok=readValue(stream,&point.m_output) && readValue(stream,&point.m_input)
+			&& readValue(stream,&point.m_bits);
+
+		m_points.push_back(point);
+	}
+
+	if(ok){
+		m_indexFile=indexFile;
+		m_windowsOffset=ftello(stream);
+	}
+
+	fclose(stream);
+
+	if(!ok){
+		m_points.clear();
+		m_windows.clear();
+		m_offsets.clear();
+		m_sequences=0;
+	}
+
+	return ok;
+}
+
+bool GzipIndex::getWindow(int point,uint8_t*window){
+
+	if(m_windows.size()>0){
+		memcpy(window,&(m_windows[point*GZIP_INDEX_WINDOW_SIZE]),GZIP_INDEX_WINDOW_SIZE);
+		return true;
+	}
+
+	FILE*stream=fopen(m_indexFile.c_str(),"rb");
+
+	if(stream==NULL)
+		return false;
+
+	uint64_t position=m_windowsOffset+(uint64_t)point*GZIP_INDEX_WINDOW_SIZE;
+
+	bool ok=fseeko(stream,position,SEEK_SET)==0
+		&& fread(window,1,GZIP_INDEX_WINDOW_SIZE,stream)==GZIP_INDEX_WINDOW_SIZE;
+
+	fclose(stream);
+
+	return ok;
+}
+
+bool GzipIndex::openAt(const char*file,uint64_t offset){
+
+	int point=-1;
+
+	for(int i=0;i<(int)m_points.size();i++){
+		if(m_points[i].m_output>offset)
+			break;
+
+		point=i;
+	}
+
+	if(point<0)
+		return false;
+
+	uint8_t window[GZIP_INDEX_WINDOW_SIZE];
+
+	if(!getWindow(point,window))
+		return false;
+
+	m_file=fopen(file,"rb");
+
+	if(m_file==NULL)
+		return false;
+
+	GzipAccessPoint*accessPoint=&(m_points[point]);
+
+	int bits=accessPoint->m_bits;
+	uint64_t position=accessPoint->m_input;
+
+	if(bits>0)
+		position--;
+
+	if(fseeko(m_file,position,SEEK_SET)!=0){
+		fclose(m_file);
+		m_file=NULL;
+		return false;
+	}
+
+	memset(&m_stream,0,sizeof(z_stream));
+	inflateInit2(&m_stream,GZIP_INDEX_RAW);
+
+	m_raw=true;
+	m_trailerBytes=0;
+	m_endOfFile=false;
+
+	if(bits>0){
+		int character=getc(m_file);
+		inflatePrime(&m_stream,bits,character>>(8-bits));
+	}
+
+	inflateSetDictionary(&m_stream,window,GZIP_INDEX_WINDOW_SIZE);
+
+	m_input=(uint8_t*)malloc(GZIP_INDEX_CHUNK);
+	m_stream.avail_in=0;
+
+/*
+ * Inflate and discard what is between the access point and the offset.
+ */
+	uint64_t toSkip=offset-accessPoint->m_output;
+	char buffer[GZIP_INDEX_CHUNK];
+
+	while(toSkip>0){
+		int bytes=GZIP_INDEX_CHUNK;
+
+		if((uint64_t)bytes>toSkip)
+			bytes=toSkip;
+
+		int got=read(buffer,bytes);
+
+		if(got==0)
+			break;
+
+		toSkip-=got;
+	}
+
+	return toSkip==0;
+}
+
+bool GzipIndex::fillInput(){
+	m_stream.avail_in=fread(m_input,1,GZIP_INDEX_CHUNK,m_file);
+	m_stream.next_in=m_input;
+
+	return m_stream.avail_in>0;
+}
+
+int GzipIndex::read(char*buffer,int bytes){
+
+	#ifdef CONFIG_ASSERT
+	assert(m_file!=NULL);
+	#endif
+
+	m_stream.next_out=(uint8_t*)buffer;
+	m_stream.avail_out=bytes;
+
+	while(m_stream.avail_out>0 && !m_endOfFile){
+
+		if(m_stream.avail_in==0 && !fillInput()){
+			m_endOfFile=true;
+			break;
+		}
+
+/*
+ * Started from an access point, the end of the member is reached
+ * without reading its trailer. The next member has a gzip header.
+ */
+		if(m_trailerBytes>0){
+			int skipped=m_trailerBytes;
+
+			if((int)m_stream.avail_in<skipped)
+				skipped=m_stream.avail_in;
+
+			m_stream.next_in+=skipped;
+			m_stream.avail_in-=skipped;
+			m_trailerBytes-=skipped;
+
+			if(m_trailerBytes==0){
+				inflateReset2(&m_stream,GZIP_INDEX_GZIP);
+				m_raw=false;
+			}
+
+			continue;
+		}
+
+		int returnValue=inflate(&m_stream,Z_NO_FLUSH);
+
+		if(returnValue==Z_NEED_DICT || returnValue==Z_DATA_ERROR || returnValue==Z_MEM_ERROR){
+			m_endOfFile=true;
+			break;
+		}
+
+		if(returnValue==Z_STREAM_END){
+			if(m_raw)
+				m_trailerBytes=GZIP_INDEX_TRAILER_BYTES;
+			else
+				inflateReset(&m_stream);
+		}
+	}
+
+	return bytes-m_stream.avail_out;
+}
+
+void GzipIndex::close(){
+	if(m_file==NULL)
+		return;
+
+	inflateEnd(&m_stream);
+	fclose(m_file);
+	m_file=NULL;
+
+	free(m_input);
+	m_input=NULL;
+}
+
+void GzipIndex::destructor(){
+	close();
+
+	m_points.clear();
+	m_windows.clear();
+	m_offsets.clear();
+	m_sequences=0;
+}
+
+#endif
@@ -0,0 +1,133 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _GzipIndex_h
+#define _GzipIndex_h
+
+#ifdef CONFIG_HAVE_LIBZ
+
+#include "CompressedFileIndex.h"
+
+#include <zlib.h>
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+using namespace std;
+
+/** deflate can refer to the last 32 KiB */
+#define GZIP_INDEX_WINDOW_SIZE 32768
+
+/** uncompressed bytes between access points */
+#define GZIP_INDEX_SPAN 33554432
+
+#define GZIP_INDEX_CHUNK 65536
+
+#define GZIP_INDEX_MAGIC "RayGzipIndex1"
+
+/**
+ * A place in a gzip file where inflate can start.
+ */
+class GzipAccessPoint{
+public:
+	/** uncompressed offset */
+	uint64_t m_output;
+
+	/** compressed offset of the first complete byte */
+	uint64_t m_input;
+
+	/** number of bits of the previous byte that are in the block, 0 to 7 */
+	uint64_t m_bits;
+};
+
+/**
+ * A random access index for gzip files.
+ *
+ * This is the approach of zran.c in the zlib distribution:
+ * an access point is kept at a deflate block boundary every GZIP_INDEX_SPAN
+ * uncompressed bytes with a copy of the 32 KiB window that
+ * precedes it. To start reading at an offset, inflate is started at the
+ * closest access point before it, with the window as its dictionary.
+ *
+ * Concatenated gzip members are supported.
+ *
+ * The index is stored next to the gzip file (see CompressedFileIndex).
+ *
+ * \see http://svn.ghostscript.com/ghostscript/tags/zlib-1.2.3/examples/zran.c
+ * \author Sébastien Boisvert
+ */
+class GzipIndex: public CompressedFileIndex{
+
+	vector<GzipAccessPoint> m_points;
+
+	/** the windows of the access points, GZIP_INDEX_WINDOW_SIZE bytes each */
+	vector<uint8_t> m_windows;
+
+/*
+ * When the index is loaded, the windows stay in the index file
+ * and only the one that is needed is read.
+ */
+	string m_indexFile;
+	uint64_t m_windowsOffset;
+
+	/* the reader */
+
+	FILE*m_file;
+	z_stream m_stream;
+	uint8_t*m_input;
+
+	/** the deflate stream has no gzip header (we started at an access point) */
+	bool m_raw;
+
+	/** bytes of the gzip trailer that remain to be skipped */
+	int m_trailerBytes;
+
+	bool m_endOfFile;
+
+	void addAccessPoint(int bits,uint64_t input,uint64_t output,uint8_t*window,int left);
+	bool fillInput();
+	bool getWindow(int point,uint8_t*window);
+
+public:
+
+	void constructor();
+
+	/** build the index with one pass on the file */
+	bool build(const char*file,int period);
+
+	/** load the index of a file, if it exists and if it matches the file */
+	bool load(const char*file,int period);
+
+	/** write the index next to the file */
+	bool write(const char*file);
+
+	/** start reading at an uncompressed offset */
+	bool openAt(const char*file,uint64_t offset);
+
+	/** read uncompressed bytes, returns 0 at the end */
+	int read(char*buffer,int bytes);
+
+	void close();
+
+	void destructor();
+};
+
+#endif
+
+#endif
@@ -37,6 +37,7 @@ void Loader::constructor(const char*prefix,bool show,Rank rank){
 
 	m_maxToLoad=500000;
 	m_currentOffset=0;
+	m_interface=NULL;
 	//m_type=FORMAT_NULL;
 	ostringstream prefixFull;
 	prefixFull<<prefix<<"_Loader";
@@ -82,6 +83,106 @@ int Loader::load(string file,bool isGenome){
 	return EXIT_FAILURE;
 }
 
+int Loader::loadAt(string file,LargeCount sequences,LargeIndex sequence,string offsetsFile){
+
+	#ifdef CONFIG_ASSERT
+	assert(sequence<sequences);
+	#endif
+
+	ifstream index(offsetsFile.c_str());
+
+	if(!index)
+		return EXIT_FAILURE;
+
+	LoaderInterface*interface=m_factory.makeLoader(file);
+
+	if(interface==NULL)
+		return EXIT_FAILURE;
+
+/*
+ * Find the last indexed sequence that is not after the sequence.
+ */
+	string header;
+	getline(index,header);
+
+	LargeIndex indexedSequence=0;
+	uint64_t offset=0;
+	bool found=false;
+
+	LargeIndex entrySequence=0;
+	uint64_t entryOffset=0;
+
+	while(index>>entrySequence>>entryOffset){
+		if(entrySequence>sequence)
+			break;
+
+		indexedSequence=entrySequence;
+		offset=entryOffset;
+		found=true;
+	}
+
+	index.close();
+
+	if(!found)
+		return EXIT_FAILURE;
+
+	if(interface->openAt(file,sequences,sequence,indexedSequence,offset)==EXIT_FAILURE)
+		return EXIT_FAILURE;
+
+	cout<<"Rank "<<m_rank<<" is fetching file "<<file<<" from sequence "<<sequence;
+	cout<<" (byte "<<offset<<" is sequence "<<indexedSequence<<")"<<endl;
+
+	m_interface=interface;
+	m_allocator.reset();
+	m_reads.reset();
+	m_size=sequences;
+	m_currentOffset=sequence;
+
+	return EXIT_SUCCESS;
+}
+
+void Loader::writeOffsets(string offsetsFile){
+
+	vector<uint64_t> offsets;
+	getOffsets(&offsets);
+
+	writeOffsets(offsetsFile,&offsets);
+}
+
+void Loader::writeOffsets(string offsetsFile,vector<uint64_t>*offsets){
+
+	if(offsets->size()==0)
+		return;
+
+	ofstream f(offsetsFile.c_str());
+
+	f<<"#Sequence	Offset"<<endl;
+
+	for(int i=0;i<(int)offsets->size();i++){
+		LargeIndex sequence=i;
+		sequence*=LOADER_OFFSET_PERIOD;
+
+		f<<sequence<<"	"<<(*offsets)[i]<<endl;
+	}
+
+	f.close();
+}
+
+void Loader::getOffsets(vector<uint64_t>*offsets){
+	offsets->clear();
+
+	if(m_interface!=NULL)
+		m_interface->getOffsets(offsets);
+}
+
+bool Loader::getLengths(vector<LargeCount>*lengths){
+
+	if(m_interface==NULL)
+		return false;
+
+	return m_interface->getLengths(lengths);
+}
+
 Read*Loader::at(LargeIndex i){
 	#ifdef CONFIG_ASSERT
 	assert(i<m_size);
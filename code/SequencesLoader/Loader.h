@@ -63,6 +63,21 @@ class Loader{
 public:
 	void constructor(const char*prefix,bool show,Rank rank);
 	int load(string file,bool isGenome);
+
+/**
+ * Open a file at a given sequence with the byte offsets written by writeOffsets.
+ * The sequences before sequence are not read.
+ * \return EXIT_FAILURE if this is not possible
+ */
+	int loadAt(string file,LargeCount sequences,LargeIndex sequence,string offsetsFile);
+
+	/** write the byte offsets recorded while opening the file, if any */
+	void writeOffsets(string offsetsFile);
+	void writeOffsets(string offsetsFile,vector<uint64_t>*offsets);
+
+	/** what was recorded while opening the file, for its manifest */
+	void getOffsets(vector<uint64_t>*offsets);
+	bool getLengths(vector<LargeCount>*lengths);
 	LargeCount size();
 	Read*at(LargeIndex i);
 	void clear();
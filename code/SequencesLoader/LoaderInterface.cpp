@@ -21,6 +21,8 @@
 
 #include "LoaderInterface.h"
 
+#include <stdlib.h>
+
 bool LoaderInterface::hasSuffix(const char* fileName,const char*suffix) {
 	int fileNameLength=strlen(fileName);
         int suffixLength=strlen(suffix);
@@ -52,3 +54,16 @@ bool LoaderInterface::checkFileType(const char* fileName) {
 	}
 	return false;
 }
+
+void LoaderInterface::getOffsets(vector<uint64_t>*offsets){
+	offsets->clear();
+}
+
+bool LoaderInterface::getLengths(vector<LargeCount>*lengths){
+	return false;
+}
+
+int LoaderInterface::openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset){
+	return EXIT_FAILURE;
+}
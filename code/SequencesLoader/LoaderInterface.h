@@ -26,8 +26,16 @@
 #include "ArrayOfReads.h"
 
 #include <string>
+#include <vector>
+#include <stdint.h>
 using namespace std;
 
+/**
+ * A byte offset is kept for one sequence every
+ * LOADER_OFFSET_PERIOD sequences.
+ */
+#define LOADER_OFFSET_PERIOD 65536
+
 /**
  * This is a interface for implementing new file formats.
  *
@@ -44,6 +52,33 @@ public:
 	virtual void load(int maxToLoad,ArrayOfReads*reads,
 		MyAllocator*seqMyAllocator) = 0;
 	virtual void close() = 0;
+
+/**
+ * Get the byte offsets recorded by open(), one for every
+ * LOADER_OFFSET_PERIOD sequences. The default implementation
+ * records nothing.
+ */
+	virtual void getOffsets(vector<uint64_t>*offsets);
+
+/**
+ * Get the histogram of the lengths of the sequences seen by open():
+ * lengths[length] is the number of sequences with that length.
+ * The default implementation records nothing.
+ *
+ * \return false if the lengths were not recorded
+ */
+	virtual bool getLengths(vector<LargeCount>*lengths);
+
+/**
+ * Open a file whose number of sequences is already known and
+ * go to a given sequence without reading what is before
+ * indexedSequence. offset is the byte offset of indexedSequence.
+ *
+ * \return EXIT_FAILURE if the format can not seek
+ */
+	virtual int openAt(string file,LargeCount sequences,LargeIndex sequence,
+		LargeIndex indexedSequence,uint64_t offset);
+
 	bool checkFileType(const char* fileName);
 	void addExtension(const char* fileName);
 };
@@ -183,9 +183,65 @@ int Read::length()const{
  *                     p p-1 p-2               0
  */
 Kmer Read::getVertex(int pos,int w,char strand,bool color) const {
-	char buffer[RAY_MAXIMUM_READ_LENGTH];
-	getSeq(buffer,color,false);
-	return kmerAtPosition(buffer,pos,w,strand,color);
+	#ifdef CONFIG_ASSERT
+	assert(w<=CONFIG_MAXKMERLENGTH);
+	#endif
+
+	if(pos>m_length-w){
+		cout<<"Fatal: offset is too large: position= "<<pos<<" Length= "<<m_length<<" WordSize=" <<w<<endl;
+		exit(0);
+	}
+	if(pos<0){
+		cout<<"Fatal: negative offset. "<<pos<<endl;
+		exit(0);
+	}
+
+	Kmer kmer;
+
+	if(strand=='F'){
+		getPackedKmer(pos,w,&kmer);
+		return kmer;
+	}else if(strand=='R'){
+		getPackedKmer(m_length-pos-w,w,&kmer);
+		return kmer.complementVertex(w,color);
+	}
+
+	return kmer;
+}
+
+/*
+ * The read and the k-mer use the same layout (the nucleotide at
+ * position p is at bits 2p and 2p+1), so each 64-bit word of the k-mer
+ * is made of at most 9 bytes of the read shifted by the same amount.
+ */
+void Read::getPackedKmer(int pos,int w,Kmer*kmer) const {
+
+	int requiredBytes=(2*m_length+7)/8;
+	int numberOfWords=(2*w+63)/64;
+
+	for(int word=0;word<numberOfWords;word++){
+		int firstBit=2*pos+64*word;
+		int firstByte=firstBit/8;
+		int shift=firstBit%8;
+
+		uint64_t value=0;
+
+		for(int i=0;i<8 && firstByte+i<requiredBytes;i++)
+			value|=((uint64_t)m_sequence[firstByte+i])<<(8*i);
+
+		value>>=shift;
+
+		if(shift>0 && firstByte+8<requiredBytes)
+			value|=((uint64_t)m_sequence[firstByte+8])<<(64-shift);
+
+/* remove the nucleotides after the k-mer */
+		int bits=2*w-64*word;
+
+		if(bits<64)
+			value&=(((uint64_t)1)<<bits)-1;
+
+		kmer->setU64(word,value);
+	}
 }
 
 bool Read::hasPairedRead()const{
@@ -55,6 +55,9 @@ class Read{
 	uint8_t m_reverseOffset;
 
 	char*trim(char*a,const char*b);
+
+	/** build the forward k-mer at a position from the 2-bit codes */
+	void getPackedKmer(int pos,int w,Kmer*kmer)const;
 public:
 	void constructor(const char*sequence,MyAllocator*seqMyAllocator,bool trim);
 	void constructorWithRawSequence(const char*sequence,uint8_t*raw,bool trim);
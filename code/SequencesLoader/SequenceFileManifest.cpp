@@ -0,0 +1,200 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "SequenceFileManifest.h"
+
+#include <iostream>
+#include <stdio.h>
+#include <string.h>
+using namespace std;
+
+/*
+ * The entries of a manifest do not have a fixed number of lines,
+ * so the period of the header is always 0.
+ */
+void SequenceFileManifest::constructor(){
+	m_offsets.clear();
+	m_sequences=0;
+	m_period=0;
+	m_fileSize=0;
+	m_modificationTime=0;
+	m_output=0;
+
+	m_lengths.clear();
+	m_hasLengths=false;
+}
+
+bool SequenceFileManifest::create(const char*file,LargeCount sequences,vector<uint64_t>*offsets){
+	constructor();
+
+	m_sequences=sequences;
+	m_offsets=*offsets;
+
+	return readFileStatus(file,&m_fileSize,&m_modificationTime);
+}
+
+void SequenceFileManifest::setLengths(vector<LargeCount>*lengths){
+	m_lengths.clear();
+
+	for(int length=0;length<(int)lengths->size();length++){
+		if(lengths->at(length)>0)
+			m_lengths[length]=lengths->at(length);
+	}
+
+	m_hasLengths=true;
+}
+
+bool SequenceFileManifest::writeFile(const char*manifestFile){
+
+	FILE*stream=fopen(manifestFile,"wb");
+
+	if(stream==NULL)
+		return false;
+
+	writeHeader(stream,SEQUENCE_FILE_MANIFEST_MAGIC);
+
+	writeValue(stream,m_hasLengths);
+
+	bool ok=writeValue(stream,m_lengths.size());
+
+	for(map<int,LargeCount>::iterator i=m_lengths.begin();i!=m_lengths.end();i++){
+		if(!writeValue(stream,i->first) || !writeValue(stream,i->second))
+			ok=false;
+	}
+
+	if(fclose(stream)!=0)
+		ok=false;
+
+	if(!ok)
+		remove(manifestFile);
+
+	return ok;
+}
+
+bool SequenceFileManifest::write(const char*file,const char*otherManifestFile){
+
+	string manifestFile=file;
+	manifestFile+=SEQUENCE_FILE_MANIFEST_SUFFIX;
+
+/* the directory of the input file can be read-only */
+	if(!writeFile(manifestFile.c_str())){
+		manifestFile=otherManifestFile;
+
+		if(manifestFile=="" || !writeFile(manifestFile.c_str()))
+			return false;
+	}
+
+	cout<<"Wrote "<<manifestFile<<endl;
+
+	return true;
+}
+
+bool SequenceFileManifest::loadFile(const char*file,const char*manifestFile){
+
+	FILE*stream=fopen(manifestFile,"rb");
+
+	if(stream==NULL)
+		return false;
+
+	uint64_t hasLengths=0;
+	uint64_t entries=0;
+
+	bool ok=readHeader(stream,SEQUENCE_FILE_MANIFEST_MAGIC,file,0)
+		&& readValue(stream,&hasLengths) && readValue(stream,&entries);
+
+	for(uint64_t i=0;ok && i<entries;i++){
+		uint64_t length=0;
+		uint64_t count=0;
+
+		ok=readValue(stream,&length) && readValue(stream,&count);
+
+		if(ok)
+			m_lengths[length]=count;
+	}
+
+	fclose(stream);
+
+	m_hasLengths=hasLengths;
+
+	return ok;
+}
+
+bool SequenceFileManifest::load(const char*file,const char*otherManifestFile){
+
+	constructor();
+
+	string manifestFile=file;
+	manifestFile+=SEQUENCE_FILE_MANIFEST_SUFFIX;
+
+	if(loadFile(file,manifestFile.c_str()))
+		return true;
+
+	constructor();
+
+	if(strlen(otherManifestFile)>0 && loadFile(file,otherManifestFile))
+		return true;
+
+	constructor();
+
+	return false;
+}
+
+bool SequenceFileManifest::hasLengths(){
+	return m_hasLengths;
+}
+
+LargeCount SequenceFileManifest::getNumberOfBases(){
+
+	LargeCount bases=0;
+
+	for(map<int,LargeCount>::iterator i=m_lengths.begin();i!=m_lengths.end();i++)
+		bases+=i->first*i->second;
+
+	return bases;
+}
+
+int SequenceFileManifest::getMinimumLength(){
+
+	if(m_lengths.size()==0)
+		return 0;
+
+	return m_lengths.begin()->first;
+}
+
+int SequenceFileManifest::getMaximumLength(){
+
+	if(m_lengths.size()==0)
+		return 0;
+
+	return m_lengths.rbegin()->first;
+}
+
+/*
+ * A sequence of length L has L-k+1 k-mers, and none if it is shorter than k.
+ */
+LargeCount SequenceFileManifest::getNumberOfKmerPositions(int kmerLength){
+
+	LargeCount positions=0;
+
+	for(map<int,LargeCount>::iterator i=m_lengths.lower_bound(kmerLength);i!=m_lengths.end();i++)
+		positions+=(i->first-kmerLength+1)*i->second;
+
+	return positions;
+}
@@ -0,0 +1,84 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _SequenceFileManifest_h
+#define _SequenceFileManifest_h
+
+#include "CompressedFileIndex.h"
+
+#include <map>
+#include <string>
+#include <vector>
+using namespace std;
+
+/** the manifest of file.fastq is file.fastq.raymanifest */
+#define SEQUENCE_FILE_MANIFEST_SUFFIX ".raymanifest"
+
+#define SEQUENCE_FILE_MANIFEST_MAGIC "RayManifest2"
+
+/**
+ * What the Partitioner learns when it counts the sequences of
+ * an input file: the number of sequences, the byte offset of every
+ * LOADER_OFFSET_PERIOD sequences and the histogram of the lengths of
+ * the sequences, if the loader recorded them. Only the lengths that
+ * occur are stored.
+ *
+ * The manifest is written next to the input file, or in the checkpoint
+ * directory if this is not possible. The next runs (and the restarts
+ * from checkpoints) read it and do not count the sequences again.
+ * Like the indexes, a manifest that does not match the size and the
+ * modification time of its file is not used.
+ *
+ * \author Sébastien Boisvert
+ */
+class SequenceFileManifest: public CompressedFileIndex{
+
+	/** the number of sequences for each length */
+	map<int,LargeCount> m_lengths;
+	bool m_hasLengths;
+
+	bool writeFile(const char*manifestFile);
+	bool loadFile(const char*file,const char*manifestFile);
+
+public:
+
+	void constructor();
+
+	/** describe file, its status is read now */
+	bool create(const char*file,LargeCount sequences,vector<uint64_t>*offsets);
+	/** lengths[length] is the number of sequences with that length */
+	void setLengths(vector<LargeCount>*lengths);
+
+	/** read the manifest next to file or else otherManifestFile, which can be empty */
+	bool load(const char*file,const char*otherManifestFile);
+
+	/** write the manifest next to file or else in otherManifestFile, which can be empty */
+	bool write(const char*file,const char*otherManifestFile);
+
+	bool hasLengths();
+	LargeCount getNumberOfBases();
+	int getMinimumLength();
+	int getMaximumLength();
+
+	/** the number of k-mers in the sequences */
+	LargeCount getNumberOfKmerPositions(int kmerLength);
+};
+
+#endif
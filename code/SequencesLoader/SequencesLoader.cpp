@@ -284,17 +284,10 @@ bool SequencesLoader::call_RAY_SLAVE_MODE_LOAD_SEQUENCES(){
 		m_totalNumberOfSequences+=m_parameters->getNumberOfSequences(i);
 	}
 
-	LargeCount sequencesPerRank=m_totalNumberOfSequences/m_size;
-	LargeIndex sequencesOnRanksBeforeThisOne=m_rank*sequencesPerRank;
-
-	LargeIndex startingSequenceId=sequencesOnRanksBeforeThisOne;
-	LargeIndex endingSequenceId=startingSequenceId+sequencesPerRank-1;
-
-	if(m_rank==m_size-1){
-		endingSequenceId=m_totalNumberOfSequences-1;
-	}
-
-	LargeCount sequences=endingSequenceId-startingSequenceId+1;
+/* the partition balances the k-mers, see Parameters::computeSequencePartition */
+	LargeIndex startingSequenceId=m_parameters->getFirstSequenceOfRank(m_rank);
+	LargeCount sequences=m_parameters->getFirstSequenceOfRank(m_rank+1)-startingSequenceId;
+	LargeIndex endingSequenceId=startingSequenceId+sequences-1;
 
 	cout<<"Rank "<<m_rank<<" : partition is ["<<startingSequenceId;
 	cout<<";"<<endingSequenceId<<"], "<<sequences<<" sequence reads"<<endl;
@@ -302,7 +295,9 @@ bool SequencesLoader::call_RAY_SLAVE_MODE_LOAD_SEQUENCES(){
 	m_distribution_currentSequenceId=0;
 	m_loader.constructor(m_parameters->getMemoryPrefix().c_str(),m_parameters->showMemoryAllocations(),
 		m_rank);
-	for(m_distribution_file_id=0;m_distribution_file_id<(int)allFiles.size();
+
+/* a rank has no sequences if a few long ones cost more than its share */
+	for(m_distribution_file_id=0;sequences>0 && m_distribution_file_id<(int)allFiles.size();
 		m_distribution_file_id++){
 
 		/** should not load more sequences than required */
@@ -321,7 +316,25 @@ bool SequencesLoader::call_RAY_SLAVE_MODE_LOAD_SEQUENCES(){
 			break;// we are done
 		}
 
-		m_loader.load(allFiles[(m_distribution_file_id)],false);
+		LargeIndex firstSequenceInFile=0;
+
+		if(startingSequenceId>m_distribution_currentSequenceId)
+			firstSequenceInFile=startingSequenceId-m_distribution_currentSequenceId;
+
+/*
+ * Go directly to the first sequence of this rank with the byte offsets
+ * recorded when the file was counted. Otherwise, the file
+ * is parsed from the beginning.
+ */
+		if(m_loader.loadAt(allFiles[m_distribution_file_id],sequencesInFile,firstSequenceInFile,
+			m_parameters->getSequenceOffsetsFile(m_distribution_file_id))==EXIT_SUCCESS){
+
+			m_distribution_sequence_id=firstSequenceInFile;
+			m_distribution_currentSequenceId+=firstSequenceInFile;
+		}else{
+			m_loader.load(allFiles[(m_distribution_file_id)],false);
+			m_distribution_sequence_id=0;
+		}
 
 		m_isInterleavedFile=(m_LOADER_isLeftFile)=(m_LOADER_isRightFile)=false;
 
@@ -333,8 +346,7 @@ bool SequencesLoader::call_RAY_SLAVE_MODE_LOAD_SEQUENCES(){
 			m_isInterleavedFile=true;
 		}
 
-		for(m_distribution_sequence_id=0;
-			m_distribution_sequence_id<m_loader.size();
+		for(;m_distribution_sequence_id<m_loader.size();
 				m_distribution_sequence_id++){
 
 			m_loader.at(m_distribution_sequence_id);
@@ -405,23 +417,26 @@ void SequencesLoader::call_RAY_MPI_TAG_SET_FILE_ENTRIES(Message*message){
 	MessageUnit*incoming=(MessageUnit*)message->getBuffer();
 
 	#ifdef CONFIG_ASSERT
-	assert(message->getCount()>=2);
-	assert(message->getCount()%2==0);
+	assert(message->getCount()>=3);
+	assert(message->getCount()%3==0);
 	#endif
 
 	int input=0;
 
 /*
  * The source can multiplex the body.
+ * Each file has its number of sequences and its number of k-mers.
  */
 	while(input<message->getCount()){
 		int file=incoming[input++];
 		LargeCount count=incoming[input++];
+		LargeCount positions=incoming[input++];
 
 		if(m_parameters->hasOption("-debug-partitioner"))
-			cout<<"Rank "<<m_parameters->getRank()<<" RAY_MPI_TAG_SET_FILE_ENTRIES File "<<file<<" "<<count<<endl;
+			cout<<"Rank "<<m_parameters->getRank()<<" RAY_MPI_TAG_SET_FILE_ENTRIES File "<<file<<" "<<count<<" "<<positions<<endl;
 
 		m_parameters->setNumberOfSequences(file,count);
+		m_parameters->setNumberOfKmerPositions(file,positions);
 	}
 
 	Message aMessage(NULL,0,message->getSource(),RAY_MPI_TAG_SET_FILE_ENTRIES_REPLY,m_rank);
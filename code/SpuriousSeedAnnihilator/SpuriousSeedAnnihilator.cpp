@@ -1257,8 +1257,7 @@ void SpuriousSeedAnnihilator::gatherCoverageValues() {
 			Kmer kmer;
 			seed.at(m_seedPosition, &kmer);
 
-			Rank rankToFlush = kmer.vertexRank(m_parameters->getSize(),m_parameters->getWordSize(),
-				m_parameters->getColorSpaceMode());
+			Rank rankToFlush = m_parameters->vertexRank(&kmer);
 
 			for(int i=0;i<KMER_U64_ARRAY_SIZE;i++){
 				m_buffersForMessages->addAt(rankToFlush, kmer.getU64(i));
@@ -1340,7 +1339,7 @@ void SpuriousSeedAnnihilator::call_RAY_MESSAGE_TAG_REQUEST_VERTEX_COVERAGE_WITH_
 		CoverageDepth coverage=0;
 
 		if(node!=NULL){
-			coverage=node->getCoverage(&vertex);
+			coverage=m_subgraph->getCoverage(node);
 
 			#ifdef CONFIG_ASSERT
 			assert(coverage!=0);
@@ -47,8 +47,8 @@ private:
 
 	int getVertexDestination(Kmer & kmer);
 
-	bool classifyKmerInBuffer(int producer, int & sample, Vertex & vertex);
-	bool addKmerInBuffer(int producer, int & actor, int & sample, Vertex & vertex);
+	bool classifyKmerInBuffer(int producer, int & sample, Vertex & vertex, CoverageDepth coverage);
+	bool addKmerInBuffer(int producer, int & actor, int & sample, Vertex & vertex, CoverageDepth coverage);
 
 	char * getBuffer(int actorIndex);
 	void flushBuffer(int producer, int consumer);
@@ -230,7 +230,7 @@ void GenomeGraphReader::readLine() {
 		char messageBuffer[100];
 		int position = 0;
 
-		position += vertex.dump(messageBuffer + position);
+		position += vertex.dump(messageBuffer + position, coverage);
 		memcpy(messageBuffer + position, &m_sample, sizeof(m_sample));
 
 		position += sizeof(m_sample);
@@ -70,21 +70,29 @@ void KmerMatrixOwner::receive(Message & message) {
 
 	} else if(tag == PUSH_KMER_SAMPLES) {
 
-		vector<bool> samplesWithKmer;
+		int numberOfSamples = m_sampleNames->size();
+		int sampleBytes = ((numberOfSamples + 63) / 64) * sizeof(uint64_t);
 
+		int bytes = message.getNumberOfBytes();
 		int offset = 0;
 
-		Kmer kmer;
-		offset += kmer.load(buffer);
-		int numberOfSamples = m_sampleNames->size();
-		char * bufferForSamples = buffer + offset;
+		vector<bool> samplesWithKmer(numberOfSamples, false);
 
-		for(int i=0; i<numberOfSamples; ++i){
-			bool state = bufferForSamples[i];
-			samplesWithKmer.push_back(state);
-		}
+		while(offset < bytes) {
+
+			Kmer kmer;
+			offset += kmer.load(buffer + offset);
+			char * bufferForSamples = buffer + offset;
 
-		dumpKmerMatrixBuffer(kmer, samplesWithKmer, false);
+			for(int i=0; i<numberOfSamples; ++i){
+				bool state = (bufferForSamples[i / 8] >> (i % 8)) & 1;
+				samplesWithKmer[i] = state;
+			}
+
+			offset += sampleBytes;
+
+			dumpKmerMatrixBuffer(kmer, samplesWithKmer, false);
+		}
 
 		Message response;
 		response.setTag(PUSH_KMER_SAMPLES_OK);
@@ -92,21 +100,7 @@ void KmerMatrixOwner::receive(Message & message) {
 
 	} else if(tag == PUSH_KMER_SAMPLES_END) {
 
-		vector<bool> samplesWithKmer;
-
-		int offset = 0;
-
-		Kmer kmer;
-		offset += kmer.load(buffer);
-		int numberOfSamples = m_sampleNames->size();
-		char * bufferForSamples = buffer + offset;
-
-		for(int i=0; i<numberOfSamples; ++i){
-			bool state = bufferForSamples[i];
-			samplesWithKmer.push_back(state);
-		}
-
-		dumpKmerMatrixBuffer(kmer, samplesWithKmer, true);
+		flushFileOperationBuffer(true, &m_kmerMatrix, &m_kmerMatrixFile, CONFIG_FILE_IO_BUFFER_SIZE);
 
 		Message response;
 		response.setTag(PUSH_KMER_SAMPLES_END);
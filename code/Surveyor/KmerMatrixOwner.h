@@ -58,7 +58,7 @@ public:
 	enum {
 		FIRST_TAG = 10350,
 		GREETINGS,
-		PUSH_KMER_SAMPLES,
+		PUSH_KMER_SAMPLES, /* k-mers, each followed by one bit per sample */
 		PUSH_KMER_SAMPLES_OK,
 		PUSH_KMER_SAMPLES_END,
 		KMER_MATRIX_IS_READY,
@@ -37,6 +37,7 @@ MatrixOwner::MatrixOwner() {
 
 	m_receivedPayloads = 0;
 
+	m_numberOfSamples = 0;
 }
 
 MatrixOwner::~MatrixOwner() {
@@ -70,28 +71,40 @@ void MatrixOwner::receive(Message & message) {
 
 	} else if(tag == PUSH_PAYLOAD) {
 
-		SampleIdentifier sample1 = -1;
-		SampleIdentifier sample2 = -1;
-		LargeCount count = 0;
+		if(m_localGramMatrix.empty())
+			allocateMatrices();
 
+		int bytes = message.getNumberOfBytes();
 		int offset = 0;
 
-		memcpy(&sample1, buffer + offset, sizeof(sample1));
-		offset += sizeof(sample1);
-		memcpy(&sample2, buffer + offset, sizeof(sample2));
-		offset += sizeof(sample2);
-		memcpy(&count, buffer + offset, sizeof(count));
-		offset += sizeof(count);
+		while(offset < bytes) {
+
+			SampleIdentifier sample1 = -1;
+			SampleIdentifier sample2 = -1;
+			LargeCount count = 0;
+
+			memcpy(&sample1, buffer + offset, sizeof(sample1));
+			offset += sizeof(sample1);
+			memcpy(&sample2, buffer + offset, sizeof(sample2));
+			offset += sizeof(sample2);
+			memcpy(&count, buffer + offset, sizeof(count));
+			offset += sizeof(count);
 
 #ifdef CONFIG_ASSERT
-		assert(sample1 >= 0);
-		assert(sample2 >= 0);
-		assert(count >= 0);
+			assert(sample1 >= 0);
+			assert(sample2 >= 0);
+			assert(sample1 < m_numberOfSamples);
+			assert(sample2 < m_numberOfSamples);
 #endif
 
-		m_receivedPayloads ++;
+			m_receivedPayloads ++;
+
+			// StoreKeeper only sends the upper triangle
+			m_localGramMatrix[sample1 * m_numberOfSamples + sample2] += count;
 
-		m_localGramMatrix[sample1][sample2] += count;
+			if(sample1 != sample2)
+				m_localGramMatrix[sample2 * m_numberOfSamples + sample1] += count;
+		}
 
 		Message response;
 		response.setTag(PUSH_PAYLOAD_OK);
@@ -102,6 +115,9 @@ void MatrixOwner::receive(Message & message) {
 
 		if(m_completedStoreActors == getSize()) {
 
+			if(m_localGramMatrix.empty())
+				allocateMatrices();
+
 			printName();
 			cout << "MatrixOwner received " << m_receivedPayloads << " payloads" << endl;
 
@@ -157,43 +173,54 @@ void MatrixOwner::receive(Message & message) {
 
 			// clear matrices
 
-			m_localGramMatrix.clear();
-			m_kernelDistanceMatrix.clear();
+			vector<LargeCount> empty1;
+			vector<LargeCount> empty2;
+			m_localGramMatrix.swap(empty1);
+			m_kernelDistanceMatrix.swap(empty2);
 		}
 	}
 }
 
 
-// TODO: save time by only computing the lower triangle.
+/**
+ * All the samples are known when the matrix is merged.
+ */
+void MatrixOwner::allocateMatrices() {
+
+	m_numberOfSamples = m_sampleNames->size();
+
+	m_localGramMatrix.resize(m_numberOfSamples * m_numberOfSamples, 0);
+	m_kernelDistanceMatrix.resize(m_numberOfSamples * m_numberOfSamples, 0);
+}
+
 void MatrixOwner::computeDistanceMatrix() {
 
-	for(map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator row = m_localGramMatrix.begin();
-			row != m_localGramMatrix.end(); ++row) {
+	for(SampleIdentifier sample1 = 0 ; sample1 < m_numberOfSamples ; ++sample1) {
 
-		SampleIdentifier sample1 = row->first;
+		for(SampleIdentifier sample2 = 0 ; sample2 <= sample1 ; ++sample2) {
 
-		for(map<SampleIdentifier, LargeCount>::iterator cell = row->second.begin();
-				cell != row->second.end(); ++cell) {
+			LargeCount hits = m_localGramMatrix[sample1 * m_numberOfSamples + sample2];
 
-			SampleIdentifier sample2 = cell->first;
+			// the sparse matrix had no distance for samples without
+			// shared k-mers
+			if(hits == 0)
+				continue;
 
 			// d(x, x') = sqrt( k(x,x) + k(x', x') - 2 k (x, x'))
 			LargeCount distance = 0;
-			distance += m_localGramMatrix[sample1][sample1];
-			distance += m_localGramMatrix[sample2][sample2];
-			distance -= 2 * m_localGramMatrix[sample1][sample2];
+			distance += m_localGramMatrix[sample1 * m_numberOfSamples + sample1];
+			distance += m_localGramMatrix[sample2 * m_numberOfSamples + sample2];
+			distance -= 2 * hits;
 
 			distance = (LargeCount) sqrt((double)distance);
 
-			m_kernelDistanceMatrix[sample1][sample2] = distance;
-			m_kernelDistanceMatrix[sample2][sample1] = distance;
-
+			m_kernelDistanceMatrix[sample1 * m_numberOfSamples + sample2] = distance;
+			m_kernelDistanceMatrix[sample2 * m_numberOfSamples + sample1] = distance;
 		}
-
 	}
 }
 
-void MatrixOwner::printLocalGramMatrix(ostream & stream, map<SampleIdentifier, map<SampleIdentifier, LargeCount> > & matrix) {
+void MatrixOwner::printLocalGramMatrix(ostream & stream, vector<LargeCount> & matrix) {
 
 	int numberOfSamples = m_sampleNames->size();
 
@@ -215,14 +242,7 @@ void MatrixOwner::printLocalGramMatrix(ostream & stream, map<SampleIdentifier, m
 
 		for(int j = 0 ; j < numberOfSamples ; ++j) {
 
-			//string & sampleName2 = m_sampleNames->at(j);
-
-			LargeCount hits = 0;
-
-			if(matrix.count(i) > 0 && matrix[i].count(j) > 0) {
-
-				hits = matrix[i][j];
-			}
+			LargeCount hits = matrix[i * m_numberOfSamples + j];
 
 			stream << "	" << hits;
 		}
@@ -230,47 +250,3 @@ void MatrixOwner::printLocalGramMatrix(ostream & stream, map<SampleIdentifier, m
 		stream << endl;
 	}
 }
-
-/**
- * Write it in RaySurveyorResults/SurveyorMatrix.tsv
- * Also write a distance matrix too !
- */
-void MatrixOwner::printLocalGramMatrixWithHash(ostream & stream, map<SampleIdentifier, map<SampleIdentifier, LargeCount> > & matrix) {
-
-	/*
-	printName();
-	cout << "Local Gram Matrix: " << endl;
-	cout << endl;
-	*/
-
-	for(map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator column = matrix.begin();
-			column != matrix.end(); ++column) {
-
-		SampleIdentifier sample = column->first;
-
-		stream << "	" << m_sampleNames->at(sample);
-	}
-
-	stream << endl;
-
-	for(map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator row = matrix.begin();
-			row != matrix.end(); ++row) {
-
-		SampleIdentifier sample1 = row->first;
-
-		stream << m_sampleNames->at(sample1);
-
-		for(map<SampleIdentifier, LargeCount>::iterator cell = row->second.begin();
-				cell != row->second.end(); ++cell) {
-
-			//SampleIdentifier sample2 = cell->first;
-
-			LargeCount hits = cell->second;
-
-			stream << "	" << hits;
-		}
-
-		stream << endl;
-	}
-}
-
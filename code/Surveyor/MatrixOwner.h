@@ -27,6 +27,7 @@
 #include <RayPlatform/actors/Actor.h>
 
 #include <map>
+#include <vector>
 #include <iostream>
 #include <sstream>
 using namespace std;
@@ -39,14 +40,19 @@ private:
 	Parameters * m_parameters;
 	vector<string> * m_sampleNames;
 
-	map<SampleIdentifier, map<SampleIdentifier, LargeCount> > m_localGramMatrix;
-	map<SampleIdentifier, map<SampleIdentifier, LargeCount> > m_kernelDistanceMatrix;
+	/**
+	 * Dense matrices, the cell (sample1, sample2) is at
+	 * sample1 * m_numberOfSamples + sample2.
+	 */
+	vector<LargeCount> m_localGramMatrix;
+	vector<LargeCount> m_kernelDistanceMatrix;
+	int m_numberOfSamples;
 
 	int m_mother;
 	int m_completedStoreActors;
 
-	void printLocalGramMatrix(ostream & stream, map<SampleIdentifier, map<SampleIdentifier, LargeCount> > & matrix);
-	void printLocalGramMatrixWithHash(ostream & stream, map<SampleIdentifier, map<SampleIdentifier, LargeCount> > & matrix);
+	void allocateMatrices();
+	void printLocalGramMatrix(ostream & stream, vector<LargeCount> & matrix);
 
 	void computeDistanceMatrix();
 
@@ -60,7 +66,7 @@ public:
 	enum {
 		FIRST_TAG = 10300,
 		GREETINGS,
-		PUSH_PAYLOAD,
+		PUSH_PAYLOAD, /* cells (sample1, sample2, count) packed one after the other */
 		PUSH_PAYLOAD_OK,
 		PUSH_PAYLOAD_END,
 		GRAM_MATRIX_IS_READY,
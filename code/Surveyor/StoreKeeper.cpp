@@ -28,6 +28,7 @@
 #include <RayPlatform/structures/MyHashTableIterator.h>
 #include <RayPlatform/core/OperatingSystem.h>
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -48,6 +49,12 @@ StoreKeeper::StoreKeeper() {
 	m_kmerLength = 0;
 
 	m_receivedPushes = 0;
+
+	m_outstandingMessages = 0;
+
+	m_sampleSize = 0;
+	m_row = 0;
+	m_column = 0;
 }
 
 StoreKeeper::~StoreKeeper() {
@@ -108,17 +115,18 @@ void StoreKeeper::receive(Message & message) {
 		cout << "DEBUG m_matrixOwner " << m_matrixOwner << endl;
 */
 
-		m_iterator1 = m_localGramMatrix.begin();
+		m_row = 0;
+		m_column = 0;
 
-		if(m_iterator1 != m_localGramMatrix.end()) {
-
-			m_iterator2 = m_iterator1->second.begin();
-		}
+		m_outstandingMessages = 0;
 
-		sendMatrixCell();
+		sendMatrixCells();
 
 	} else if(tag == MatrixOwner::PUSH_PAYLOAD_OK) {
-		sendMatrixCell();
+
+		m_outstandingMessages --;
+
+		sendMatrixCells();
 	} else if(tag == MERGE_KMER_MATRIX) {
 
 		m_mother = source;
@@ -127,10 +135,15 @@ void StoreKeeper::receive(Message & message) {
 
 		m_hashTableIterator.constructor(&m_hashTable);
 
+		m_outstandingMessages = 0;
+
 		sendKmersSamples();
 	} else if (tag == KmerMatrixOwner::PUSH_KMER_SAMPLES_END) {
 
 	} else if(tag == KmerMatrixOwner::PUSH_KMER_SAMPLES_OK) {
+
+		m_outstandingMessages --;
+
 		sendKmersSamples();
 	} else if(tag == CoalescenceManager::SET_KMER_LENGTH) {
 
@@ -160,53 +173,79 @@ void StoreKeeper::receive(Message & message) {
 	}
 }
 
-void StoreKeeper::sendMatrixCell() {
+/**
+ * Send the cells of the local Gram matrix to MatrixOwner.
+ *
+ * Only the non-zero cells of the upper triangle are sent, MatrixOwner
+ * fills the lower triangle.
+ *
+ * Each message has as many cells as MAXIMUM_MESSAGE_SIZE_IN_BYTES allows
+ * and up to STORE_KEEPER_MAXIMUM_OUTSTANDING_MESSAGES messages are
+ * sent without waiting for PUSH_PAYLOAD_OK.
+ */
+void StoreKeeper::sendMatrixCells() {
+
+	int cellSize = sizeof(SampleIdentifier) + sizeof(SampleIdentifier) + sizeof(LargeCount);
+
+	if(m_localGramMatrix.empty())
+		m_row = m_sampleSize;
 
-	if(m_iterator1 != m_localGramMatrix.end()) {
+	while(m_outstandingMessages < STORE_KEEPER_MAXIMUM_OUTSTANDING_MESSAGES
+			&& m_row < m_sampleSize) {
 
-		if(m_iterator2 != m_iterator1->second.end()) {
+		char buffer[MAXIMUM_MESSAGE_SIZE_IN_BYTES];
+		int offset = 0;
 
-			SampleIdentifier sample1 = m_iterator1->first;
-			SampleIdentifier sample2 = m_iterator2->first;
-			LargeCount count = m_iterator2->second;
+		while(m_row < m_sampleSize
+				&& offset + cellSize <= MAXIMUM_MESSAGE_SIZE_IN_BYTES) {
+
+			SampleIdentifier sample1 = m_row;
+			SampleIdentifier sample2 = m_column;
+			LargeCount count = getGramMatrixRow(sample1)[sample2];
+
+			m_column ++;
+
+			// end of the line
+			if(m_column == m_sampleSize) {
+
+				m_row ++;
+				m_column = m_row;
+			}
+
+			if(count == 0)
+				continue;
 
-			Message message;
-			char buffer[20];
-			int offset = 0;
 			memcpy(buffer + offset, &sample1, sizeof(sample1));
 			offset += sizeof(sample1);
 			memcpy(buffer + offset, &sample2, sizeof(sample2));
 			offset += sizeof(sample2);
 			memcpy(buffer + offset, &count, sizeof(count));
 			offset += sizeof(count);
+		}
 
-			message.setBuffer(buffer);
-			message.setNumberOfBytes(offset);
-			message.setTag(MatrixOwner::PUSH_PAYLOAD);
-
-			send(m_matrixOwner, message);
-
-			m_iterator2++;
-
-			// end of the line
-			if(m_iterator2 == m_iterator1->second.end()) {
-
-				m_iterator1++;
+		// only zeros were left
+		if(offset == 0)
+			break;
 
-				if(m_iterator1 != m_localGramMatrix.end()) {
+		Message message;
+		message.setBuffer(buffer);
+		message.setNumberOfBytes(offset);
+		message.setTag(MatrixOwner::PUSH_PAYLOAD);
 
-					m_iterator2 = m_iterator1->second.begin();
-				}
-			}
+		send(m_matrixOwner, message);
 
-			return;
-		}
+		m_outstandingMessages ++;
 	}
 
+	// wait for the cells that are on the way
+	if(m_row < m_sampleSize || m_outstandingMessages > 0)
+		return;
+
 	// we processed all the matrix
 
 	// free memory.
-	m_localGramMatrix.clear();
+	vector<LargeCount> emptyMatrix;
+	m_localGramMatrix.swap(emptyMatrix);
 
 	printName();
 
@@ -245,12 +284,29 @@ void StoreKeeper::printColorReport() {
 	m_colorSet.printColors(&cout);
 }
 
+/**
+ * Get the row of a sample in the upper triangle of the local Gram matrix.
+ *
+ * The row starts at column sample, so the cell (sample1, sample2)
+ * with sample1 <= sample2 is getGramMatrixRow(sample1)[sample2].
+ */
+LargeCount * StoreKeeper::getGramMatrixRow(SampleIdentifier sample) {
+
+	// the rows before this one have m_sampleSize, m_sampleSize - 1, ... cells
+	uint64_t start = (uint64_t)sample * (2 * m_sampleSize - sample - 1) / 2;
+
+	return &(m_localGramMatrix[0]) + start;
+}
+
 void StoreKeeper::computeLocalGramMatrix() {
 
 	uint64_t sum = 0;
 
 	// compute the local Gram matrix
 
+	uint64_t cells = (uint64_t)m_sampleSize * (m_sampleSize + 1) / 2;
+	m_localGramMatrix.assign(cells, 0);
+
 	int colors = m_colorSet.getTotalNumberOfVirtualColors();
 
 #if 0
@@ -266,7 +322,7 @@ void StoreKeeper::computeLocalGramMatrix() {
 
 		VirtualKmerColorHandle virtualColor = i;
 
-		set<PhysicalKmerColor> * samples = m_colorSet.getPhysicalColors(virtualColor);
+		vector<PhysicalKmerColor> * samples = m_colorSet.getPhysicalColors(virtualColor);
 
 		LargeCount hits = m_colorSet.getNumberOfReferences(virtualColor);
 
@@ -284,7 +340,7 @@ void StoreKeeper::computeLocalGramMatrix() {
 		bool useFirstColorToFilter = false;
 
 		int filterColor = 0;
-		bool hasFilter = samples->count(filterColor) > 0;
+		bool hasFilter = m_colorSet.virtualColorHasPhysicalColor(virtualColor, filterColor);
 
 		// since people are going to use this to check
 		// for genome size, don't duplicate counts
@@ -299,7 +355,7 @@ void StoreKeeper::computeLocalGramMatrix() {
 #endif
 
 #if 0
-		for(set<PhysicalKmerColor>:: iterator sampleIterator = samples->begin();
+		for(vector<PhysicalKmerColor>:: iterator sampleIterator = samples->begin();
 				sampleIterator != samples->end() ;
 				++sampleIterator) {
 
@@ -323,41 +379,36 @@ void StoreKeeper::computeLocalGramMatrix() {
 		if(reportTwoDNAStrands)
 			hits *= 2;
 
-		// TODO: samples could be ordered and stored in a vector
-		// to stop as soon as j > i
-
-		// Complexity: quadratic in the number of samples.
-		for(set<PhysicalKmerColor>::iterator sample1 = samples->begin();
-				sample1 != samples->end();
-				++sample1) {
+		if(useFirstColorToFilter && !hasFilter) {
+			continue;
+		}
 
-			SampleIdentifier sample1Index = *sample1;
+		// The samples of a virtual color are sorted, so the pairs
+		// with sample1 <= sample2 are the ones with j >= i.
+		// Complexity: quadratic in the number of samples of the color.
+		int count = samples->size();
+		PhysicalKmerColor * sampleList = NULL;
 
-			for(set<PhysicalKmerColor>::iterator sample2 = samples->begin();
-				sample2 != samples->end();
-				++sample2) {
+		if(count > 0)
+			sampleList = &(samples->at(0));
 
-				SampleIdentifier sample2Index = *sample2;
+		for(int i = 0 ; i < count ; ++i) {
 
-				//if(sample2 < sample1)
-				// this is a diagonal matrix
+			SampleIdentifier sample1Index = sampleList[i];
 
-				if(useFirstColorToFilter && !hasFilter) {
-					continue;
-				}
+#ifdef CONFIG_ASSERT
+			assert(sample1Index < m_sampleSize);
+			assert(i == 0 || sampleList[i - 1] < sampleList[i]);
+#endif
 
-				m_localGramMatrix[sample1Index][sample2Index] += hits;
+			LargeCount * row = getGramMatrixRow(sample1Index);
 
-				/*
-				cout << "DEBUG count entry ";
-				cout << "[ " << sample1Index << " ";
-				cout << sample2Index << " ";
-				cout <<
-				*/
+			for(int j = i ; j < count ; ++j) {
 
-				sum += hits;
-				//m_localGramMatrix[sample2Index][sample1Index] += hits;
+				row[sampleList[j]] += hits;
 			}
+
+			sum += hits * (count - i);
 		}
 	}
 
@@ -378,28 +429,28 @@ void StoreKeeper::printLocalGramMatrix() {
 	cout << "Local Gram Matrix: " << endl;
 	cout << endl;
 
-	for(map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator column = m_localGramMatrix.begin();
-			column != m_localGramMatrix.end(); ++column) {
+	if(m_localGramMatrix.empty())
+		return;
 
-		SampleIdentifier sample = column->first;
+	for(SampleIdentifier sample = 0; sample < m_sampleSize; ++sample) {
 
 		cout << "	" << sample;
 	}
 
 	cout << endl;
 
-	for(map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator row = m_localGramMatrix.begin();
-			row != m_localGramMatrix.end(); ++row) {
-
-		SampleIdentifier sample1 = row->first;
+	for(SampleIdentifier sample1 = 0; sample1 < m_sampleSize; ++sample1) {
 
 		cout << sample1;
-		for(map<SampleIdentifier, LargeCount>::iterator cell = row->second.begin();
-				cell != row->second.end(); ++cell) {
 
-			//SampleIdentifier sample2 = cell->first;
+		for(SampleIdentifier sample2 = 0; sample2 < m_sampleSize; ++sample2) {
+
+			LargeCount hits = 0;
 
-			LargeCount hits = cell->second;
+			if(sample1 <= sample2)
+				hits = getGramMatrixRow(sample1)[sample2];
+			else
+				hits = getGramMatrixRow(sample2)[sample1];
 
 			cout << "	" << hits;
 		}
@@ -532,20 +583,20 @@ void StoreKeeper::storeData(Vertex & vertex, int & sample) {
 
 #ifdef CONFIG_ASSERT
 
-	set<PhysicalKmerColor> * theOldSamples = m_colorSet.getPhysicalColors(oldVirtualColor);
-	set<PhysicalKmerColor> oldSamples = *theOldSamples;
+	vector<PhysicalKmerColor> * theOldSamples = m_colorSet.getPhysicalColors(oldVirtualColor);
+	vector<PhysicalKmerColor> oldSamples = *theOldSamples;
 
-	assert(oldSamples.count(sampleColor) == 0);
+	assert(!binary_search(oldSamples.begin(), oldSamples.end(), sampleColor));
 #endif
 
 	VirtualKmerColorHandle newVirtualColor= m_colorSet.getVirtualColorFrom(oldVirtualColor, sampleColor);
 
 #ifdef CONFIG_ASSERT
 	assert(m_colorSet.virtualColorHasPhysicalColor(newVirtualColor, sampleColor));
-	set<PhysicalKmerColor>* samples = m_colorSet.getPhysicalColors(newVirtualColor);
+	vector<PhysicalKmerColor>* samples = m_colorSet.getPhysicalColors(newVirtualColor);
 
 
-	assert(samples->count(sampleColor) > 0);
+	assert(binary_search(samples->begin(), samples->end(), sampleColor));
 #endif
 
 
@@ -558,7 +609,7 @@ void StoreKeeper::storeData(Vertex & vertex, int & sample) {
 
 		cout << " >>> Old samples " << oldSamples.size () << endl;
 
-		for(set<PhysicalKmerColor>::iterator i = oldSamples.begin();
+		for(vector<PhysicalKmerColor>::iterator i = oldSamples.begin();
 				i != oldSamples.end() ; ++i) {
 
 			cout << " " << *i;
@@ -571,11 +622,11 @@ void StoreKeeper::storeData(Vertex & vertex, int & sample) {
 		cout << " refs " << m_colorSet.getNumberOfReferences(oldVirtualColor) << endl;
 
 
-		set<PhysicalKmerColor>* samples = m_colorSet.getPhysicalColors(newVirtualColor);
+		vector<PhysicalKmerColor>* samples = m_colorSet.getPhysicalColors(newVirtualColor);
 
 		cout << " >>> new samples " << samples->size () << endl;
 
-		for(set<PhysicalKmerColor>::iterator i = samples->begin();
+		for(vector<PhysicalKmerColor>::iterator i = samples->begin();
 				i != samples->end() ; ++i) {
 
 			cout << " " << *i;
@@ -627,50 +678,64 @@ void StoreKeeper::setSampleSize(int sampleSize) {
 }
 
 
+/**
+ * Send the k-mers and their samples to KmerMatrixOwner.
+ *
+ * A message contains as many k-mers as MAXIMUM_MESSAGE_SIZE_IN_BYTES
+ * allows. Each k-mer is followed by one bit per sample, padded to
+ * 8 bytes. Up to STORE_KEEPER_MAXIMUM_OUTSTANDING_MESSAGES messages are
+ * sent without waiting for PUSH_KMER_SAMPLES_OK.
+ */
 void StoreKeeper::sendKmersSamples() {
 
-	char buffer[MAXIMUM_MESSAGE_SIZE_IN_BYTES];
-	int bytes = 0;
+	int kmerBytes = KMER_U64_ARRAY_SIZE * sizeof(MessageUnit);
+	int sampleBytes = ((m_sampleSize + 63) / 64) * sizeof(uint64_t);
 
-	ExperimentVertex * currentVertex = NULL;
-	VirtualKmerColorHandle currentVirtualColor = NULL_VIRTUAL_COLOR;
+	while(m_outstandingMessages < STORE_KEEPER_MAXIMUM_OUTSTANDING_MESSAGES
+			&& m_hashTableIterator.hasNext()) {
 
-	vector<bool> samplesVector (m_sampleSize, false);
+		char buffer[MAXIMUM_MESSAGE_SIZE_IN_BYTES];
+		int bytes = 0;
 
-	if(m_hashTableIterator.hasNext()){
+		while(m_hashTableIterator.hasNext()
+				&& bytes + kmerBytes + sampleBytes <= MAXIMUM_MESSAGE_SIZE_IN_BYTES) {
 
-		currentVertex = m_hashTableIterator.next();
-		Kmer kmer = currentVertex->getKey();
+			ExperimentVertex * currentVertex = m_hashTableIterator.next();
+			Kmer kmer = currentVertex->getKey();
 
-		bytes += kmer.dump(buffer);
+			bytes += kmer.dump(buffer + bytes);
 
-		currentVirtualColor = currentVertex->getVirtualColor();
-		set<PhysicalKmerColor> * samples = m_colorSet.getPhysicalColors(currentVirtualColor);
+			char * samplesBits = buffer + bytes;
+			memset(samplesBits, 0, sampleBytes);
 
-		for(set<PhysicalKmerColor>:: iterator sampleIterator = samples->begin();
-			sampleIterator != samples->end(); ++sampleIterator) {
-			PhysicalKmerColor value = *sampleIterator;
-			samplesVector[value] = true;
-		}
+			VirtualKmerColorHandle currentVirtualColor = currentVertex->getVirtualColor();
+			vector<PhysicalKmerColor> * samples = m_colorSet.getPhysicalColors(currentVirtualColor);
+
+			for(vector<PhysicalKmerColor>:: iterator sampleIterator = samples->begin();
+				sampleIterator != samples->end(); ++sampleIterator) {
+				PhysicalKmerColor value = *sampleIterator;
+				samplesBits[value / 8] |= (1 << (value % 8));
+			}
 
-		for (std::vector<bool>::iterator it = samplesVector.begin();
-			it != samplesVector.end(); ++it) {
-			buffer[bytes] = *it;
-			bytes++;
+			bytes += sampleBytes;
 		}
-	}
 
+		Message message;
+		message.setNumberOfBytes(bytes);
+		message.setBuffer(buffer);
+		message.setTag(KmerMatrixOwner::PUSH_KMER_SAMPLES);
 
-	Message message;
-	message.setNumberOfBytes(bytes);
-	message.setBuffer(buffer);
+		send(m_kmerMatrixOwner, message);
 
-	if(m_hashTableIterator.hasNext()){
-		message.setTag(KmerMatrixOwner::PUSH_KMER_SAMPLES);
-	}else{
-		message.setTag(KmerMatrixOwner::PUSH_KMER_SAMPLES_END);
+		m_outstandingMessages ++;
 	}
 
-	send(m_kmerMatrixOwner, message);
+	// wait for the k-mers that are on the way
+	if(m_hashTableIterator.hasNext() || m_outstandingMessages > 0)
+		return;
 
+	Message message;
+	message.setTag(KmerMatrixOwner::PUSH_KMER_SAMPLES_END);
+
+	send(m_kmerMatrixOwner, message);
 }
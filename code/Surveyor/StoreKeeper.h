@@ -25,6 +25,9 @@
 
 #define PLAN_STORE_KEEPER_ACTORS_PER_RANK 1
 
+/* messages sent to MatrixOwner or KmerMatrixOwner without a response yet */
+#define STORE_KEEPER_MAXIMUM_OUTSTANDING_MESSAGES 4
+
 #include "ExperimentVertex.h"
 
 #include <code/Searcher/ColorSet.h>
@@ -50,10 +53,16 @@ private:
 
 	int m_storeDataCalls;
 	int m_receivedPushes;
-	map<SampleIdentifier, map<SampleIdentifier, LargeCount> > m_localGramMatrix;
 
-	map<SampleIdentifier, map<SampleIdentifier, LargeCount> >::iterator m_iterator1;
-	map<SampleIdentifier, LargeCount>::iterator m_iterator2;
+	/**
+	 * The local Gram matrix is symmetric, so only the upper triangle
+	 * (sample1 <= sample2) is stored, row after row.
+	 */
+	vector<LargeCount> m_localGramMatrix;
+
+	/* next cell to send to MatrixOwner */
+	SampleIdentifier m_row;
+	SampleIdentifier m_column;
 
 	ColorSet m_colorSet;
 
@@ -83,14 +92,17 @@ private:
 	void storeData(Vertex & vertex, int & sample);
 	void configureHashTable();
 	void computeLocalGramMatrix();
+	LargeCount * getGramMatrixRow(SampleIdentifier sample);
 	void printLocalGramMatrix();
 	void printColorReport();
 
 	int m_sampleSize;
+	int m_outstandingMessages;
+
 	void printLocalKmersMatrix(string & m_kmer, string & m_samplesKmers);
 	void sendKmersSamples();
 
-	void sendMatrixCell();
+	void sendMatrixCells();
 
 public:
 
@@ -0,0 +1,197 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "TaxonomyIndex.h"
+
+#include <algorithm>
+#include <iostream>
+#include <set>
+using namespace std;
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void TaxonomyIndex::build(map<TaxonIdentifier,TaxonIdentifier>*parents){
+
+	set<TaxonIdentifier> taxons;
+
+	for(map<TaxonIdentifier,TaxonIdentifier>::iterator i=parents->begin();i!=parents->end();i++){
+		taxons.insert(i->first);
+		taxons.insert(i->second);
+	}
+
+	m_taxons.clear();
+	m_taxons.insert(m_taxons.end(),taxons.begin(),taxons.end());
+
+	int count=m_taxons.size();
+
+	vector<int> parentIndexes(count,TAXONOMY_INDEX_NONE);
+
+	for(map<TaxonIdentifier,TaxonIdentifier>::iterator i=parents->begin();i!=parents->end();i++)
+		parentIndexes[getIndex(i->first)]=getIndex(i->second);
+
+	computeDepths(&parentIndexes);
+
+	int maximumDepth=0;
+
+	for(int i=0;i<count;i++){
+		if(m_depths[i]>maximumDepth)
+			maximumDepth=m_depths[i];
+	}
+
+/* 2^(m_levels-1) must reach the deepest root */
+	m_levels=1;
+	while((1<<(m_levels-1))<maximumDepth)
+		m_levels++;
+
+	m_ancestors.resize(m_levels*count);
+
+	for(int i=0;i<count;i++)
+		m_ancestors[i]=parentIndexes[i];
+
+	for(int level=1;level<m_levels;level++){
+		for(int i=0;i<count;i++){
+			int middle=getAncestor(level-1,i);
+			int ancestor=TAXONOMY_INDEX_NONE;
+
+			if(middle!=TAXONOMY_INDEX_NONE)
+				ancestor=getAncestor(level-1,middle);
+
+			m_ancestors[level*count+i]=ancestor;
+		}
+	}
+}
+
+/*
+ * The depth of a taxon is the number of ancestors it has.
+ * The taxonomy files can contain a cycle, in that case it is
+ * cut where it is detected so that every walk ends at a root.
+ */
+void TaxonomyIndex::computeDepths(vector<int>*parents){
+
+	int count=m_taxons.size();
+
+	m_depths.assign(count,-1);
+
+	vector<char> onPath(count,0);
+	vector<int> path;
+
+	for(int start=0;start<count;start++){
+		if(m_depths[start]>=0)
+			continue;
+
+		int current=start;
+
+		while(current!=TAXONOMY_INDEX_NONE && m_depths[current]<0){
+
+			if(onPath[current]){
+				cout<<"Warning: the taxonomy contains a cycle at taxon "<<m_taxons[current]<<endl;
+
+				(*parents)[path.back()]=TAXONOMY_INDEX_NONE;
+				break;
+			}
+
+			onPath[current]=1;
+			path.push_back(current);
+			current=(*parents)[current];
+		}
+
+		while(!path.empty()){
+			int index=path.back();
+			path.pop_back();
+			onPath[index]=0;
+
+			int parent=(*parents)[index];
+
+			if(parent==TAXONOMY_INDEX_NONE)
+				m_depths[index]=0;
+			else
+				m_depths[index]=m_depths[parent]+1;
+		}
+	}
+}
+
+int TaxonomyIndex::getAncestor(int level,int index){
+	return m_ancestors[level*m_taxons.size()+index];
+}
+
+int TaxonomyIndex::getIndex(TaxonIdentifier taxon){
+
+	vector<TaxonIdentifier>::iterator position=lower_bound(m_taxons.begin(),m_taxons.end(),taxon);
+
+	if(position==m_taxons.end() || *position!=taxon)
+		return TAXONOMY_INDEX_NONE;
+
+	return position-m_taxons.begin();
+}
+
+TaxonIdentifier TaxonomyIndex::getTaxon(int index){
+
+	#ifdef CONFIG_ASSERT
+	assert(index>=0 && index<(int)m_taxons.size());
+	#endif
+
+	return m_taxons[index];
+}
+
+int TaxonomyIndex::getParent(int index){
+	return getAncestor(0,index);
+}
+
+int TaxonomyIndex::findCommonAncestor(int first,int second){
+
+	if(m_depths[first]<m_depths[second]){
+		int other=first;
+		first=second;
+		second=other;
+	}
+
+/* bring the deepest one at the same depth */
+	int difference=m_depths[first]-m_depths[second];
+
+	for(int level=0;difference>0;level++){
+		if(difference & 1)
+			first=getAncestor(level,first);
+
+		difference>>=1;
+	}
+
+	if(first==second)
+		return first;
+
+/* move both just below their common ancestor */
+	for(int level=m_levels-1;level>=0;level--){
+		int firstAncestor=getAncestor(level,first);
+		int secondAncestor=getAncestor(level,second);
+
+		if(firstAncestor!=secondAncestor){
+			first=firstAncestor;
+			second=secondAncestor;
+		}
+	}
+
+/* this is TAXONOMY_INDEX_NONE if they have different roots */
+	return getParent(first);
+}
+
+int TaxonomyIndex::size(){
+	return m_taxons.size();
+}
@@ -0,0 +1,78 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _TaxonomyIndex_h
+#define _TaxonomyIndex_h
+
+#include "types.h"
+
+#include <map>
+#include <vector>
+using namespace std;
+
+/** a taxon that is not in the index */
+#define TAXONOMY_INDEX_NONE (-1)
+
+/**
+ * The taxonomic tree with dense indexes.
+ *
+ * The taxons are sorted, so the index of a taxon is its position
+ * in m_taxons. The parent of every taxon is stored at level 0 of
+ * m_ancestors and the ancestor 2^level generations above is stored at
+ * each next level (binary lifting). A common ancestor is therefore
+ * found in O(log(depth)) steps instead of walking up to the root.
+ *
+ * The index is built once, after the tree is loaded.
+ *
+ * \author Sébastien Boisvert
+ */
+class TaxonomyIndex{
+
+	vector<TaxonIdentifier> m_taxons;
+	vector<int> m_depths;
+
+	/** m_ancestors[level*m_taxons.size()+index] */
+	vector<int> m_ancestors;
+	int m_levels;
+
+	int getAncestor(int level,int index);
+	void computeDepths(vector<int>*parents);
+
+public:
+
+	void build(map<TaxonIdentifier,TaxonIdentifier>*parents);
+
+	/** returns TAXONOMY_INDEX_NONE if the taxon is not in the tree */
+	int getIndex(TaxonIdentifier taxon);
+	TaxonIdentifier getTaxon(int index);
+
+	/** returns TAXONOMY_INDEX_NONE for a root */
+	int getParent(int index);
+
+	/**
+	 * The deepest taxon that is an ancestor of both (or one of them).
+	 * Returns TAXONOMY_INDEX_NONE if they are not in the same tree.
+	 */
+	int findCommonAncestor(int first,int second);
+
+	int size();
+};
+
+#endif
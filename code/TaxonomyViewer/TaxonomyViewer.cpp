@@ -388,6 +388,18 @@ void TaxonomyViewer::gatherKmerObservations(){
 
 	map<CoverageDepth,LargeCount> frequencies;
 
+	m_taxonomyIndex.build(&m_treeParents);
+
+/* all the k-mers with the same virtual color are classified together */
+	VirtualColorClassification empty;
+	empty.m_taxons=-1;
+	empty.m_hasTaxon=false;
+	empty.m_taxon=0;
+	empty.m_kmers=0;
+	empty.m_coverage=0;
+
+	m_virtualColorClassifications.assign(m_colorSet->getTotalNumberOfVirtualColors(),empty);
+
 	while(iterator.hasNext()){
 
 		#ifdef CONFIG_ASSERT
@@ -433,68 +445,39 @@ void TaxonomyViewer::gatherKmerObservations(){
 
 		// at this point, we have a nicely assembled k-mer
 		
-		int kmerCoverage=node->getCoverage(&key);
+		int kmerCoverage=m_subgraph->getCoverage(node);
 
 		VirtualKmerColorHandle color=node->getVirtualColor();
-		set<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
-
-		vector<TaxonIdentifier> taxons;
-
-		// get a list of taxons associated with this kmer
-		for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
-			j!=physicalColors->end();j++){
-
-			PhysicalKmerColor physicalColor=*j;
-	
-			PhysicalKmerColor nameSpace=physicalColor/COLOR_NAMESPACE_MULTIPLIER;
-		
-			// associated with -with-taxonomy
-			if(nameSpace==COLOR_NAMESPACE_PHYLOGENY){
-				PhysicalKmerColor colorForPhylogeny=physicalColor % COLOR_NAMESPACE_MULTIPLIER;
-
-				#ifdef CONFIG_ASSERT
-				if(m_colorsForPhylogeny.count(colorForPhylogeny)==0){
-					//cout<<"Error: color "<<colorForPhylogeny<<" should be in m_colorsForPhylogeny which contains "<<m_colorsForPhylogeny.size()<<endl;
-				}
-				#endif
-
-				//assert(m_colorsForPhylogeny.count(colorForPhylogeny)>0);
-
-				// this means that this genome is not in the taxonomy tree
-				if(m_genomeToTaxon.count(colorForPhylogeny)==0){
-
-					if(m_warnings.count(colorForPhylogeny)==0){
-						cout<<"Warning, color "<<colorForPhylogeny<<" is not stored, "<<m_genomeToTaxon.size()<<" available. This means that you provided a genome sequence that is not classified in the taxonomy."<<endl;
-
-						#ifdef VERBOSE
-						for(map<GenomeIdentifier,TaxonIdentifier>::iterator i=m_genomeToTaxon.begin();i!=m_genomeToTaxon.end();i++){
-							cout<<" "<<i->first<<"->"<<i->second;
-						}
-						cout<<endl;
-						#endif
-					}
 
-					m_warnings.insert(colorForPhylogeny);
+		#ifdef CONFIG_ASSERT
+		assert(color<m_virtualColorClassifications.size());
+		#endif
 
-					continue;
-				}
+		VirtualColorClassification*classification=&(m_virtualColorClassifications[color]);
 
-				#ifdef CONFIG_ASSERT
-				assert(m_genomeToTaxon.count(colorForPhylogeny)>0);
-				#endif
+		if(classification->m_taxons<0)
+			classifyVirtualColor(color,classification);
 
-				TaxonIdentifier taxon=m_genomeToTaxon[colorForPhylogeny];
+		classification->m_kmers++;
+		classification->m_coverage+=kmerCoverage;
+	}
 
-				taxons.push_back(taxon);
-			}
-		}
+/* add the coverage of each virtual color to its taxon */
+	for(int i=0;i<(int)m_virtualColorClassifications.size();i++){
+		VirtualColorClassification*classification=&(m_virtualColorClassifications[i]);
 
-		classifySignal(&taxons,kmerCoverage,node,&key);
+		if(classification->m_taxons<0)
+			continue;
 
-		int count=taxons.size();
+		frequencies[classification->m_taxons]+=classification->m_kmers;
 
-		frequencies[count]++;
+		if(classification->m_taxons==0)
+			m_unknown+=classification->m_coverage;
+		else if(classification->m_hasTaxon)
+			m_taxonObservations[classification->m_taxon]+=classification->m_coverage;
 	}
+
+	m_virtualColorClassifications.clear();
 	
 /*
  *
@@ -522,6 +505,73 @@ void TaxonomyViewer::gatherKmerObservations(){
 	m_countIterator=m_taxonObservations.begin();
 }
 
+void TaxonomyViewer::getVirtualColorTaxons(VirtualKmerColorHandle color,vector<TaxonIdentifier>*taxons){
+
+	vector<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
+
+	// get a list of taxons associated with this kmer
+	for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
+		j!=physicalColors->end();j++){
+
+		PhysicalKmerColor physicalColor=*j;
+	
+		PhysicalKmerColor nameSpace=physicalColor/COLOR_NAMESPACE_MULTIPLIER;
+	
+		// associated with -with-taxonomy
+		if(nameSpace==COLOR_NAMESPACE_PHYLOGENY){
+			PhysicalKmerColor colorForPhylogeny=physicalColor % COLOR_NAMESPACE_MULTIPLIER;
+
+			#ifdef CONFIG_ASSERT
+			if(m_colorsForPhylogeny.count(colorForPhylogeny)==0){
+				//cout<<"Error: color "<<colorForPhylogeny<<" should be in m_colorsForPhylogeny which contains "<<m_colorsForPhylogeny.size()<<endl;
+			}
+			#endif
+
+			//assert(m_colorsForPhylogeny.count(colorForPhylogeny)>0);
+
+			// this means that this genome is not in the taxonomy tree
+			if(m_genomeToTaxon.count(colorForPhylogeny)==0){
+
+				if(m_warnings.count(colorForPhylogeny)==0){
+					cout<<"Warning, color "<<colorForPhylogeny<<" is not stored, "<<m_genomeToTaxon.size()<<" available. This means that you provided a genome sequence that is not classified in the taxonomy."<<endl;
+
+					#ifdef VERBOSE
+					for(map<GenomeIdentifier,TaxonIdentifier>::iterator i=m_genomeToTaxon.begin();i!=m_genomeToTaxon.end();i++){
+						cout<<" "<<i->first<<"->"<<i->second;
+					}
+					cout<<endl;
+					#endif
+				}
+
+				m_warnings.insert(colorForPhylogeny);
+
+				continue;
+			}
+
+			#ifdef CONFIG_ASSERT
+			assert(m_genomeToTaxon.count(colorForPhylogeny)>0);
+			#endif
+
+			TaxonIdentifier taxon=m_genomeToTaxon[colorForPhylogeny];
+
+			taxons->push_back(taxon);
+		}
+	}
+}
+
+void TaxonomyViewer::classifyVirtualColor(VirtualKmerColorHandle color,VirtualColorClassification*classification){
+
+	vector<TaxonIdentifier> taxons;
+
+	getVirtualColorTaxons(color,&taxons);
+
+	classification->m_taxons=taxons.size();
+	classification->m_hasTaxon=false;
+
+	if(taxons.size()>0)
+		classification->m_hasTaxon=classifySignal(&taxons,&(classification->m_taxon));
+}
+
 LargeCount TaxonomyViewer::getSelfCount(TaxonIdentifier taxon){
 	if(m_taxonObservations.count(taxon)==0){
 		return 0;
@@ -810,13 +860,14 @@ void TaxonomyViewer::showObservations(ostream*stream){
 	(*stream)<<" k-mer observations: "<<m_unknown<<endl;
 }
 
-void TaxonomyViewer::classifySignal(vector<TaxonIdentifier>*taxons,int kmerCoverage,Vertex*vertex,Kmer*key){
+bool TaxonomyViewer::classifySignal(vector<TaxonIdentifier>*taxons,TaxonIdentifier*taxon){
 	// given a list of taxon,
-	// place the kmer coverage somewhere in
+	// find where the kmer coverage goes in
 	// the tree
 	//
 	// case 1.
 	// if there are 0 taxons, this is unknown stuff
+	// (this is handled by the caller)
 	//
 	// case 2.
 	// if there is one taxon, place the coverage on it
@@ -828,132 +879,105 @@ void TaxonomyViewer::classifySignal(vector<TaxonIdentifier>*taxons,int kmerCover
 	// if there is at least 2 taxons and they don't have the same parent
 	//  but they have a common ancestor
 	
+	#ifdef CONFIG_ASSERT
+	assert(taxons->size()>0);
+	#endif
 
+	if(taxons->size()==1){
+		*taxon=taxons->at(0); // case 2.
 
-	if(taxons->size()==0){
-
-		m_unknown+=kmerCoverage; // case 1.
-
-	}else if(taxons->size()==1){
-		TaxonIdentifier taxon=taxons->at(0);
-
-		m_taxonObservations[taxon]+=kmerCoverage; // case 2.
-
-	}else{ // more than 1
-
-		#ifdef CONFIG_ASSERT
-		assert(taxons->size()>1);
-		#endif
-
-		// a taxon can only have one parent,
-		// simply check if they have all the same parent...
+		return true;
+	}
 
-		map<TaxonIdentifier,int> parentCount;
+	// more than 1
 
-		int found=0;
+	// a taxon can only have one parent,
+	// simply check if they have all the same parent...
 
-		for(int i=0;i<(int)taxons->size();i++){
-			TaxonIdentifier taxon=taxons->at(i);
+	int firstParent=TAXONOMY_INDEX_NONE;
+	bool sameParent=true;
+	bool missingTaxon=false;
 
-			if(m_treeParents.count(taxon)==0){
-				
-				cout<<"Warning: Taxon "<<taxon<<" is not in the tree"<<endl;
-				continue;
-			}
+	for(int i=0;i<(int)taxons->size();i++){
+		TaxonIdentifier current=taxons->at(i);
 
-			TaxonIdentifier parent=getTaxonParent(taxon);
+		int index=m_taxonomyIndex.getIndex(current);
+		int parent=TAXONOMY_INDEX_NONE;
 
-			parentCount[parent]++;
-			found++;
-		}
+		if(index!=TAXONOMY_INDEX_NONE)
+			parent=m_taxonomyIndex.getParent(index);
 
-		if(parentCount.size()==1){ // only 1 common ancestor, easy
+		if(parent==TAXONOMY_INDEX_NONE){
 			
-			#ifdef CONFIG_ASSERT
-			if(!(parentCount.begin()->second == found)){
-				cout<<"Error: taxons: "<<taxons->size()<<", parentCount: "<<parentCount.size()<<" 1 element with "<<parentCount.begin()->second<<" taxons"<<endl;
-			}
-			assert(parentCount.begin()->second == found);
-			#endif
-
-			TaxonIdentifier taxon=parentCount.begin()->first;
+			cout<<"Warning: Taxon "<<current<<" is not in the tree"<<endl;
+			missingTaxon=true;
+			continue;
+		}
 
-			m_taxonObservations[taxon]+=kmerCoverage; // case 3.
+		if(firstParent==TAXONOMY_INDEX_NONE)
+			firstParent=parent;
+		else if(parent!=firstParent)
+			sameParent=false;
+	}
 
-			return;
-		}
+	if(firstParent==TAXONOMY_INDEX_NONE){
+		cout<<"Error, no parents, returning now."<<endl;
+		return false;
+	}
 
-		if(parentCount.size()==0){
-			cout<<"Error, no parents, returning now."<<endl;
-			return;
-		}
+	if(sameParent){ // only 1 common ancestor, easy
+		*taxon=m_taxonomyIndex.getTaxon(firstParent); // case 3.
 
-		// at this point, we have more than one taxon and
-		// they don't share the same parent
+		return true;
+	}
 
-		// since we have a tree, find the nearest common ancestor
-		// in the worst case, the common ancestor is the root
+	// at this point, we have more than one taxon and
+	// they don't share the same parent
 
-		#ifdef CONFIG_ASSERT
-		assert(parentCount.size()>1);
-		#endif
+	// since we have a tree, find the nearest common ancestor
+	// in the worst case, the common ancestor is the root
 
-		TaxonIdentifier taxon=findCommonAncestor(taxons);
+	if(missingTaxon)
+		*taxon=999999999999ULL;
+	else
+		*taxon=findCommonAncestor(taxons); // case 4.
 
-		// classify it
-		m_taxonObservations[taxon]+=kmerCoverage; // case 4.
-	}
+	return true;
 }
 
+/*
+ * Returns the deepest common ancestor of the parents of the taxons.
+ * Every taxon must have a parent in the tree.
+ */
 TaxonIdentifier TaxonomyViewer::findCommonAncestor(vector<TaxonIdentifier>*taxons){
 
-	map<TaxonIdentifier,int> counts;
-
-	// for a deep tree, this algorithm would not be really fast.
-	// so instead of computing path to the root,
-	// the algorithm should stop when one ancestor is found
-
-	vector<TaxonIdentifier> currentTaxons;
+	int ancestor=TAXONOMY_INDEX_NONE;
 
 	for(int i=0;i<(int)taxons->size();i++){
-		TaxonIdentifier taxon=taxons->at(i);
-		currentTaxons.push_back(taxon);
-	}
-
-	while(1){
-		int blocked=0;
+		int index=m_taxonomyIndex.getIndex(taxons->at(i));
 
-		// compute each path to the root
-		for(int i=0;i<(int)currentTaxons.size();i++){
-			TaxonIdentifier taxon=currentTaxons[i];
-
-			// no more parents
-			if(m_treeParents.count(taxon)==0){
-				blocked++;
-				continue;
-			}
-
-			TaxonIdentifier parent=m_treeParents[taxon];
+		#ifdef CONFIG_ASSERT
+		assert(index!=TAXONOMY_INDEX_NONE);
+		#endif
 
-			counts[parent]++;
+		int parent=m_taxonomyIndex.getParent(index);
 
-			// we found a common ancestor
-			// this is the deepest
-			if(counts[parent]==(int)currentTaxons.size()){ 
-				return parent;
-			}
-			
-			currentTaxons[i]=parent; // update it
-		}
+		if(i==0)
+			ancestor=parent;
+		else
+			ancestor=m_taxonomyIndex.findCommonAncestor(ancestor,parent);
 
-		if(blocked==(int)currentTaxons.size()){ // this will happen if it is not a tree
+		if(ancestor==TAXONOMY_INDEX_NONE){ // this will happen if it is not a tree
 			
-			cout<<"Error, this is not a tree, blocked: "<<blocked<<" currentTaxons: "<<currentTaxons.size()<<endl;
+			cout<<"Error, this is not a tree, the taxons have different roots"<<endl;
 			break;
 		}
 	}
 
-	return 999999999999ULL;
+	if(ancestor==TAXONOMY_INDEX_NONE)
+		return 999999999999ULL;
+
+	return m_taxonomyIndex.getTaxon(ancestor);
 }
 
 TaxonIdentifier TaxonomyViewer::getTaxonParent(TaxonIdentifier taxon){
@@ -1279,9 +1303,9 @@ void TaxonomyViewer::extractColorsForPhylogeny(){
 		}
 
 		VirtualKmerColorHandle color=node->getVirtualColor();
-		set<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
+		vector<PhysicalKmerColor>*physicalColors=m_colorSet->getPhysicalColors(color);
 
-		for(set<PhysicalKmerColor>::iterator j=physicalColors->begin();
+		for(vector<PhysicalKmerColor>::iterator j=physicalColors->begin();
 			j!=physicalColors->end();j++){
 
 			PhysicalKmerColor physicalColor=*j;
@@ -22,6 +22,7 @@
 #define _TaxonomyViewer_h
 
 #include "types.h"
+#include "TaxonomyIndex.h"
 
 #include <code/Searcher/ColorSet.h>
 #include <code/Mock/Parameters.h>
@@ -38,6 +39,7 @@
 #include <set>
 #include <stdint.h>
 #include <map>
+#include <vector>
 using namespace std;
 
 /*
@@ -71,6 +73,26 @@ Genome-to-Taxon.tsv  Taxon-Names.tsv  Taxon-Types.tsv  TreeOfLife-Edges.tsv
 
 
 
+/**
+ * The classification of the k-mers that have a given virtual color.
+ * They all have the same taxons, so the work is done once per
+ * virtual color and the coverage is added to the taxon at the end.
+ *
+ * \author Sébastien Boisvert
+ */
+class VirtualColorClassification{
+public:
+	/** number of taxons in the virtual color, -1 until it is classified */
+	int m_taxons;
+
+	/** false if the k-mers are not placed in the tree */
+	bool m_hasTaxon;
+	TaxonIdentifier m_taxon;
+
+	LargeCount m_kmers;
+	LargeCount m_coverage;
+};
+
 __DeclarePlugin(TaxonomyViewer);
 
 __DeclareMasterModeAdapter(TaxonomyViewer,RAY_MASTER_MODE_PHYLOGENY_MAIN);
@@ -135,6 +157,9 @@ class TaxonomyViewer: public CorePlugin{
 	map<TaxonIdentifier,set<TaxonIdentifier> > m_treeChildren;
 	map<TaxonIdentifier,TaxonIdentifier> m_treeParents;
 
+	TaxonomyIndex m_taxonomyIndex;
+	vector<VirtualColorClassification> m_virtualColorClassifications;
+
 	GridTable*m_subgraph;
 	Parameters*m_parameters;
 	SwitchMan*m_switchMan;
@@ -192,7 +217,9 @@ class TaxonomyViewer: public CorePlugin{
 	string getTaxonName(TaxonIdentifier taxon);
 
 	void gatherKmerObservations();
-	void classifySignal(vector<TaxonIdentifier>*taxons,int kmerCoverage,Vertex*vertex,Kmer*key);
+	void getVirtualColorTaxons(VirtualKmerColorHandle color,vector<TaxonIdentifier>*taxons);
+	void classifyVirtualColor(VirtualKmerColorHandle color,VirtualColorClassification*classification);
+	bool classifySignal(vector<TaxonIdentifier>*taxons,TaxonIdentifier*taxon);
 	void printTaxonPath(TaxonIdentifier taxon,vector<TaxonIdentifier>*path,ostream*stream);
 	TaxonIdentifier getTaxonParent(TaxonIdentifier taxon);
 	void showObservations(ostream*stream);
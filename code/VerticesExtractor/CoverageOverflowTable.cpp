@@ -0,0 +1,144 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "CoverageOverflowTable.h"
+
+#include <stdlib.h>
+
+void CoverageOverflowTable::constructor(){
+	m_entries.clear();
+	m_size=0;
+}
+
+uint64_t CoverageOverflowTable::getSlot(const Kmer*key){
+	return key->hash_function_2()&(m_entries.size()-1);
+}
+
+CoverageOverflowEntry*CoverageOverflowTable::findEntry(const Kmer*key){
+
+	if(m_size==0)
+		return NULL;
+
+	uint64_t mask=m_entries.size()-1;
+
+	for(uint64_t slot=getSlot(key);m_entries[slot].m_used;slot=(slot+1)&mask){
+		if(m_entries[slot].m_key==*key)
+			return &(m_entries[slot]);
+	}
+
+	return NULL;
+}
+
+/* twice the slots, and the entries are inserted again */
+void CoverageOverflowTable::grow(){
+
+	vector<CoverageOverflowEntry> entries;
+	entries.swap(m_entries);
+
+	uint64_t slots=entries.size()*2;
+
+	if(slots==0)
+		slots=COVERAGE_OVERFLOW_TABLE_INITIAL_SLOTS;
+
+	CoverageOverflowEntry emptyEntry;
+	emptyEntry.m_coverage=0;
+	emptyEntry.m_used=false;
+
+	m_entries.assign(slots,emptyEntry);
+	m_size=0;
+
+	for(uint64_t i=0;i<entries.size();i++){
+		if(entries[i].m_used)
+			setCoverage(&(entries[i].m_key),entries[i].m_coverage);
+	}
+}
+
+CoverageDepth CoverageOverflowTable::getCoverage(const Kmer*lowerKey){
+	CoverageOverflowEntry*entry=findEntry(lowerKey);
+
+	if(entry==NULL)
+		return 0;
+
+	return entry->m_coverage;
+}
+
+void CoverageOverflowTable::setCoverage(const Kmer*lowerKey,CoverageDepth coverage){
+
+	CoverageOverflowEntry*entry=findEntry(lowerKey);
+
+	if(entry!=NULL){
+		entry->m_coverage=coverage;
+		return;
+	}
+
+	if((m_size+1)*2>m_entries.size())
+		grow();
+
+	uint64_t mask=m_entries.size()-1;
+	uint64_t slot=getSlot(lowerKey);
+
+	while(m_entries[slot].m_used)
+		slot=(slot+1)&mask;
+
+	m_entries[slot].m_key=*lowerKey;
+	m_entries[slot].m_coverage=coverage;
+	m_entries[slot].m_used=true;
+	m_size++;
+}
+
+/*
+ * The entries after the removed one are moved back when their
+ * slot is not between the hole and them, so that a lookup never
+ * stops at the hole before finding them.
+ */
+void CoverageOverflowTable::removeCoverage(const Kmer*lowerKey){
+
+	CoverageOverflowEntry*entry=findEntry(lowerKey);
+
+	if(entry==NULL)
+		return;
+
+	uint64_t mask=m_entries.size()-1;
+	uint64_t hole=entry-&(m_entries[0]);
+
+	m_entries[hole].m_used=false;
+	m_size--;
+
+	for(uint64_t slot=(hole+1)&mask;m_entries[slot].m_used;slot=(slot+1)&mask){
+		uint64_t home=getSlot(&(m_entries[slot].m_key));
+
+/* the distances from home, the entry stays if the hole is not on its path */
+		if(((slot-home)&mask)<((slot-hole)&mask))
+			continue;
+
+		m_entries[hole]=m_entries[slot];
+		m_entries[slot].m_used=false;
+		hole=slot;
+	}
+}
+
+LargeCount CoverageOverflowTable::size(){
+	return m_size;
+}
+
+void CoverageOverflowTable::destructor(){
+	m_entries.clear();
+	m_size=0;
+}
@@ -0,0 +1,86 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _CoverageOverflowTable_h
+#define _CoverageOverflowTable_h
+
+#include <code/KmerAcademyBuilder/Kmer.h>
+#include <code/Mock/constants.h>
+
+#include <vector>
+using namespace std;
+
+/** the first number of slots of a CoverageOverflowTable, a power of 2 */
+#define COVERAGE_OVERFLOW_TABLE_INITIAL_SLOTS 64
+
+/**
+ * A slot of the CoverageOverflowTable.
+ */
+class CoverageOverflowEntry{
+public:
+	Kmer m_key;
+	CoverageDepth m_coverage;
+	bool m_used;
+};
+
+/**
+ * The coverage depths that do not fit in the counter of a Vertex.
+ *
+ * A Vertex has a small counter (VertexCoverage). When it saturates,
+ * the real value is stored here with the lower k-mer as the key.
+ * Only high-copy k-mers (rRNA operons, plasmids, ...) are stored here,
+ * so this table is small.
+ *
+ * This is an open addressing hash table with linear probing. It is
+ * at most half full, and a removed entry is filled by the entries that
+ * follow it, so there are no deleted markers.
+ * hash_function_1 places the vertices on the ranks, so hash_function_2
+ * is used here.
+ *
+ * The table belongs to a GridTable and only the GridTable reads and
+ * writes it (GridTable::getCoverage and GridTable::setCoverageValue).
+ * A Vertex that is not in a GridTable has no entry here.
+ *
+ * \author Sébastien Boisvert
+ */
+class CoverageOverflowTable{
+
+	vector<CoverageOverflowEntry> m_entries;
+	LargeCount m_size;
+
+	uint64_t getSlot(const Kmer*key);
+	CoverageOverflowEntry*findEntry(const Kmer*key);
+	void grow();
+
+public:
+
+	void constructor();
+
+	/** get the coverage of a saturated vertex, 0 if it is not here */
+	CoverageDepth getCoverage(const Kmer*lowerKey);
+	void setCoverage(const Kmer*lowerKey,CoverageDepth coverage);
+	void removeCoverage(const Kmer*lowerKey);
+
+	LargeCount size();
+
+	void destructor();
+};
+
+#endif
@@ -0,0 +1,599 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "GraphCheckpoint.h"
+
+#include <code/KmerAcademyBuilder/CanonicalKmer.h>
+
+#include <RayPlatform/structures/MyHashTableIterator.h>
+#include <RayPlatform/memory/allocator.h>
+
+#include <iostream>
+#include <algorithm>
+#include <string.h>
+#include <stdlib.h>
+#include <stdio.h>
+using namespace std;
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+#ifndef _WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/** bytes written at once */
+#define GRAPH_CHECKPOINT_BUFFER_SIZE SIZE_4M
+
+/** fixed-size records written at once */
+#define GRAPH_CHECKPOINT_BATCH 65536
+
+/** the largest record: the varints, the edges and the coverage depth */
+#define GRAPH_CHECKPOINT_MAXIMUM_RECORD_SIZE (10*(KMER_U64_ARRAY_SIZE+1)+1)
+
+/*
+ * The word 0 is the most significant one, like in Kmer::operator<.
+ */
+class GraphCheckpointVertexComparator{
+public:
+	bool operator()(Vertex*a,Vertex*b)const{
+		return a->getKey()<b->getKey();
+	}
+};
+
+static uint8_t*writeVarint(uint8_t*output,uint64_t value){
+	while(value>=0x80){
+		*output++=(value&0x7f)|0x80;
+		value>>=7;
+	}
+
+	*output++=value;
+
+	return output;
+}
+
+/* returns NULL if the varint goes after end */
+static uint8_t*readVarint(uint8_t*input,uint8_t*end,uint64_t*value){
+	uint64_t result=0;
+	int shift=0;
+
+	while(input<end && shift<64){
+		uint8_t byte=*input++;
+		result|=((uint64_t)(byte&0x7f))<<shift;
+
+		if(!(byte&0x80)){
+			(*value)=result;
+			return input;
+		}
+
+		shift+=7;
+	}
+
+	return NULL;
+}
+
+void GraphCheckpoint::constructor(){
+	m_header=NULL;
+	m_records=NULL;
+	m_body=NULL;
+	m_content=NULL;
+	m_contentSize=0;
+	m_allocated=false;
+}
+
+bool GraphCheckpoint::hasMagicNumber(const char*file){
+	FILE*stream=fopen(file,"rb");
+
+	if(stream==NULL)
+		return false;
+
+	char magic[8];
+	bool found=fread(magic,1,8,stream)==8 && memcmp(magic,GRAPH_CHECKPOINT_MAGIC,8)==0;
+
+	fclose(stream);
+
+	return found;
+}
+
+bool GraphCheckpoint::write(const char*file,GridTable*graph,int kmerLength,
+		uint64_t buckets,int bucketsPerGroup,MinimizerPlacement*placement,uint32_t version){
+
+	#ifdef CONFIG_ASSERT
+	assert(version==GRAPH_CHECKPOINT_VERSION_RECORDS || version==GRAPH_CHECKPOINT_VERSION_VARINTS);
+	#endif
+
+	FILE*stream=fopen(file,"wb");
+
+	if(stream==NULL)
+		return false;
+
+	GraphCheckpointHeader header;
+	memset(&header,0,sizeof(GraphCheckpointHeader));
+	memcpy(header.m_magic,GRAPH_CHECKPOINT_MAGIC,8);
+	header.m_version=version;
+	header.m_kmerLength=kmerLength;
+	header.m_wordsPerKmer=KMER_U64_ARRAY_SIZE;
+	header.m_recordSize=0;
+	header.m_coverageSize=sizeof(CoverageDepth);
+	header.m_bucketsPerGroup=bucketsPerGroup;
+	header.m_buckets=buckets;
+	header.m_vertices=graph->getHashTable()->size();
+	header.m_placement=GRAPH_CHECKPOINT_PLACEMENT_HASH;
+
+	if(placement!=NULL){
+		header.m_placement=GRAPH_CHECKPOINT_PLACEMENT_MINIMIZERS;
+		header.m_minimizerLength=placement->getMinimizerLength();
+		header.m_placementChecksum=placement->getChecksum();
+	}
+
+	if(version==GRAPH_CHECKPOINT_VERSION_RECORDS)
+		header.m_recordSize=sizeof(GraphCheckpointRecord);
+
+	bool ok=fwrite(&header,sizeof(GraphCheckpointHeader),1,stream)==1;
+
+	LargeCount written=0;
+
+	if(ok && version==GRAPH_CHECKPOINT_VERSION_RECORDS)
+		ok=writeRecords(stream,graph,&written);
+	else if(ok)
+		ok=writeVarintRecords(stream,graph,&written);
+
+	if(fclose(stream)!=0)
+		ok=false;
+
+	#ifdef CONFIG_ASSERT
+	assert(!ok || written==header.m_vertices);
+	#endif
+
+	return ok;
+}
+
+/*
+ * The iterator visits the buckets in order, so the records are
+ * grouped like the buckets of the hash table.
+ * The padding of the records is cleared so that the files are the same
+ * for the same graph.
+ */
+bool GraphCheckpoint::writeRecords(FILE*stream,GridTable*graph,LargeCount*written){
+
+	GraphCheckpointRecord*batch=(GraphCheckpointRecord*)__Malloc(GRAPH_CHECKPOINT_BATCH*sizeof(GraphCheckpointRecord),
+		"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+	memset(batch,0,GRAPH_CHECKPOINT_BATCH*sizeof(GraphCheckpointRecord));
+
+	bool ok=true;
+	int batchSize=0;
+
+	MyHashTableIterator<Kmer,Vertex> iterator;
+	iterator.constructor(graph->getHashTable());
+
+	while(ok && iterator.hasNext()){
+		Vertex*vertex=iterator.next();
+		Kmer key=vertex->getKey();
+
+		GraphCheckpointRecord*record=batch+batchSize++;
+
+		for(int i=0;i<KMER_U64_ARRAY_SIZE;i++)
+			record->m_key[i]=key.getU64(i);
+
+		record->m_coverage=graph->getCoverage(vertex);
+		record->m_edges=vertex->getVertexEdges();
+
+		if(batchSize==GRAPH_CHECKPOINT_BATCH){
+			ok=(int)fwrite(batch,sizeof(GraphCheckpointRecord),batchSize,stream)==batchSize;
+			(*written)+=batchSize;
+			batchSize=0;
+		}
+	}
+
+	if(ok && batchSize>0){
+		ok=(int)fwrite(batch,sizeof(GraphCheckpointRecord),batchSize,stream)==batchSize;
+		(*written)+=batchSize;
+	}
+
+	__Free(batch,"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+
+	return ok;
+}
+
+/*
+ * Sort the vertices, not the k-mers: a pointer is smaller than a Kmer.
+ */
+bool GraphCheckpoint::writeVarintRecords(FILE*stream,GridTable*graph,LargeCount*written){
+
+	LargeCount vertices=graph->getHashTable()->size();
+
+	Vertex**sorted=(Vertex**)__Malloc((vertices+1)*sizeof(Vertex*),
+		"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+
+	LargeCount count=0;
+
+	MyHashTableIterator<Kmer,Vertex> iterator;
+	iterator.constructor(graph->getHashTable());
+
+	while(iterator.hasNext()){
+		#ifdef CONFIG_ASSERT
+		assert(count<vertices);
+		#endif
+
+		sorted[count++]=iterator.next();
+	}
+
+	std::sort(sorted,sorted+count,GraphCheckpointVertexComparator());
+
+	uint8_t*buffer=(uint8_t*)__Malloc(GRAPH_CHECKPOINT_BUFFER_SIZE,
+		"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+
+	bool ok=true;
+	uint8_t*output=buffer;
+	Kmer previous;
+
+	for(LargeIndex i=0;ok && i<count;i++){
+		Vertex*vertex=sorted[i];
+		Kmer key=vertex->getKey();
+
+/* the difference with the previous k-mer, with the borrows */
+		uint64_t borrow=0;
+		uint64_t delta[KMER_U64_ARRAY_SIZE];
+
+		for(int j=KMER_U64_ARRAY_SIZE-1;j>=0;j--){
+			uint64_t word=key.getU64(j);
+			uint64_t subtracted=previous.getU64(j)+borrow;
+
+			delta[j]=word-subtracted;
+			borrow=(subtracted<borrow || word<subtracted)?1:0;
+		}
+
+		for(int j=0;j<KMER_U64_ARRAY_SIZE;j++)
+			output=writeVarint(output,delta[j]);
+
+		*output++=vertex->getVertexEdges();
+		output=writeVarint(output,graph->getCoverage(vertex));
+
+		previous=key;
+
+		if(output+GRAPH_CHECKPOINT_MAXIMUM_RECORD_SIZE>buffer+GRAPH_CHECKPOINT_BUFFER_SIZE){
+			ok=fwrite(buffer,1,output-buffer,stream)==(size_t)(output-buffer);
+			output=buffer;
+		}
+	}
+
+	if(ok && output>buffer)
+		ok=fwrite(buffer,1,output-buffer,stream)==(size_t)(output-buffer);
+
+	__Free(buffer,"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+	__Free(sorted,"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+
+	(*written)=count;
+
+	return ok;
+}
+
+bool GraphCheckpoint::hasFixedSizeRecords(){
+	return m_header->m_version==GRAPH_CHECKPOINT_VERSION_RECORDS;
+}
+
+bool GraphCheckpoint::checkHeader(GraphCheckpointHeader*header,int kmerLength,MinimizerPlacement*placement){
+
+	if(memcmp(header->m_magic,GRAPH_CHECKPOINT_MAGIC,8)!=0)
+		return false;
+
+	if(header->m_version<GRAPH_CHECKPOINT_FIRST_VERSION_WITH_PLACEMENT){
+		cout<<"Error: GenomeGraph checkpoint version "<<header->m_version;
+		cout<<" does not record the placement of the k-mers, it must be written again"<<endl;
+		return false;
+	}
+
+	if(header->m_version!=GRAPH_CHECKPOINT_VERSION_RECORDS && header->m_version!=GRAPH_CHECKPOINT_VERSION_VARINTS){
+		cout<<"Error: GenomeGraph checkpoint version is "<<header->m_version;
+		cout<<", expected "<<GRAPH_CHECKPOINT_VERSION_RECORDS<<" or "<<GRAPH_CHECKPOINT_VERSION_VARINTS<<endl;
+		return false;
+	}
+
+	if((int)header->m_kmerLength!=kmerLength){
+		cout<<"Error: GenomeGraph checkpoint has k-mer length "<<header->m_kmerLength;
+		cout<<", expected "<<kmerLength<<endl;
+		return false;
+	}
+
+	uint32_t recordSize=0;
+
+	if(header->m_version==GRAPH_CHECKPOINT_VERSION_RECORDS)
+		recordSize=sizeof(GraphCheckpointRecord);
+
+	if(header->m_wordsPerKmer!=KMER_U64_ARRAY_SIZE || header->m_recordSize!=recordSize
+		|| header->m_coverageSize!=sizeof(CoverageDepth)){
+
+		cout<<"Error: GenomeGraph checkpoint was written with other compilation options";
+		cout<<" (CONFIG_MAXKMERLENGTH or CONFIG_MAXIMUM_COVERAGE)"<<endl;
+		return false;
+	}
+
+	uint32_t placementMode=GRAPH_CHECKPOINT_PLACEMENT_HASH;
+
+	if(placement!=NULL)
+		placementMode=GRAPH_CHECKPOINT_PLACEMENT_MINIMIZERS;
+
+	if(header->m_placement!=placementMode){
+		cout<<"Error: GenomeGraph checkpoint was written ";
+
+		if(header->m_placement==GRAPH_CHECKPOINT_PLACEMENT_MINIMIZERS)
+			cout<<"with";
+		else
+			cout<<"without";
+
+		cout<<" -minimizer-placement"<<endl;
+		return false;
+	}
+
+	if(placement!=NULL && (int)header->m_minimizerLength!=placement->getMinimizerLength()){
+		cout<<"Error: GenomeGraph checkpoint has minimizer length "<<header->m_minimizerLength;
+		cout<<", expected "<<placement->getMinimizerLength()<<endl;
+		return false;
+	}
+
+	if(placement!=NULL && header->m_placementChecksum!=placement->getChecksum()){
+		cout<<"Error: GenomeGraph checkpoint was written with another table of minimizers";
+		cout<<" (the checkpoint MinimizerPlacement is missing or the input files changed)"<<endl;
+		return false;
+	}
+
+	uint64_t expected=sizeof(GraphCheckpointHeader)+header->m_vertices*recordSize;
+
+	if(m_contentSize<expected){
+		cout<<"Error: GenomeGraph checkpoint is truncated"<<endl;
+		return false;
+	}
+
+	return true;
+}
+
+bool GraphCheckpoint::open(const char*file,int kmerLength,MinimizerPlacement*placement){
+
+	close();
+
+#ifndef _WIN32
+
+	int descriptor=::open(file,O_RDONLY);
+
+	if(descriptor<0)
+		return false;
+
+	struct stat status;
+
+	if(fstat(descriptor,&status)!=0 || status.st_size<(off_t)sizeof(GraphCheckpointHeader)){
+		::close(descriptor);
+		return false;
+	}
+
+	m_contentSize=status.st_size;
+
+	void*address=mmap(NULL,m_contentSize,PROT_READ,MAP_PRIVATE,descriptor,0);
+
+/* the mapping stays valid after the file is closed */
+	::close(descriptor);
+
+	if(address==MAP_FAILED){
+		m_contentSize=0;
+		return false;
+	}
+
+	madvise(address,m_contentSize,MADV_SEQUENTIAL);
+
+	m_content=(uint8_t*)address;
+	m_allocated=false;
+
+#else
+
+	FILE*stream=fopen(file,"rb");
+
+	if(stream==NULL)
+		return false;
+
+	fseek(stream,0,SEEK_END);
+	m_contentSize=ftell(stream);
+	fseek(stream,0,SEEK_SET);
+
+	m_content=(uint8_t*)__Malloc(m_contentSize,"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+	m_allocated=true;
+
+	bool ok=fread(m_content,1,m_contentSize,stream)==m_contentSize;
+
+	fclose(stream);
+
+	if(!ok || m_contentSize<sizeof(GraphCheckpointHeader)){
+		close();
+		return false;
+	}
+
+#endif
+
+	m_header=(GraphCheckpointHeader*)m_content;
+	m_body=m_content+sizeof(GraphCheckpointHeader);
+	m_records=(GraphCheckpointRecord*)m_body;
+
+	if(!checkHeader(m_header,kmerLength,placement)){
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+LargeCount GraphCheckpoint::getNumberOfVertices(){
+	if(m_header==NULL)
+		return 0;
+
+	return m_header->m_vertices;
+}
+
+GraphCheckpointRecord*GraphCheckpoint::getRecord(LargeIndex index){
+
+	#ifdef CONFIG_ASSERT
+	assert(hasFixedSizeRecords());
+	assert(index<getNumberOfVertices());
+	#endif
+
+	return m_records+index;
+}
+
+void GraphCheckpoint::getKey(LargeIndex index,Kmer*key){
+	GraphCheckpointRecord*record=getRecord(index);
+
+	for(int i=0;i<KMER_U64_ARRAY_SIZE;i++)
+		key->setU64(i,record->m_key[i]);
+}
+
+bool GraphCheckpoint::load(GridTable*graph,Rank rank){
+
+	if(hasFixedSizeRecords())
+		return loadRecords(graph,rank);
+
+	return loadVarintRecords(graph,rank);
+}
+
+/*
+ * The keys are already the lower k-mers: no reverse complement is
+ * computed and the edges are copied as a bitmap.
+ */
+bool GraphCheckpoint::loadRecords(GridTable*graph,Rank rank){
+
+	LargeCount vertices=getNumberOfVertices();
+
+	for(LargeIndex i=0;i<vertices;i++){
+		if(i%1000000==0){
+			cout<<"Rank "<<rank<<" loading checkpoint GenomeGraph ["<<i<<"/"<<vertices<<"]"<<endl;
+		}
+
+		Kmer key;
+		getKey(i,&key);
+
+		CanonicalKmer canonicalKey;
+		canonicalKey.constructorWithLowerKey(&key);
+
+		Vertex*vertex=graph->insert(&canonicalKey);
+
+		if(graph->inserted())
+			vertex->constructor();
+
+		GraphCheckpointRecord*record=getRecord(i);
+
+		graph->setCoverageValue(vertex,record->m_coverage);
+		vertex->setVertexEdges(record->m_edges);
+	}
+
+	cout<<"Rank "<<rank<<" loading checkpoint GenomeGraph ["<<vertices<<"/"<<vertices<<"]"<<endl;
+
+	return true;
+}
+
+bool GraphCheckpoint::loadVarintRecords(GridTable*graph,Rank rank){
+
+	LargeCount vertices=getNumberOfVertices();
+
+	uint8_t*input=m_body;
+	uint8_t*end=m_content+m_contentSize;
+
+	Kmer key;
+
+	for(LargeIndex i=0;i<vertices;i++){
+		if(i%1000000==0){
+			cout<<"Rank "<<rank<<" loading checkpoint GenomeGraph ["<<i<<"/"<<vertices<<"]"<<endl;
+		}
+
+		uint64_t delta[KMER_U64_ARRAY_SIZE];
+
+		for(int j=0;input!=NULL && j<KMER_U64_ARRAY_SIZE;j++)
+			input=readVarint(input,end,delta+j);
+
+		uint64_t coverage=0;
+
+		if(input!=NULL && input<end){
+			uint8_t edges=*input++;
+			input=readVarint(input,end,&coverage);
+
+			if(input!=NULL){
+
+/* add the difference to the previous k-mer, with the carries */
+				uint64_t carry=0;
+
+				for(int j=KMER_U64_ARRAY_SIZE-1;j>=0;j--){
+					uint64_t word=key.getU64(j)+carry;
+					carry=(word<carry)?1:0;
+
+					word+=delta[j];
+
+					if(word<delta[j])
+						carry=1;
+
+					key.setU64(j,word);
+				}
+
+				CanonicalKmer canonicalKey;
+				canonicalKey.constructorWithLowerKey(&key);
+
+				Vertex*vertex=graph->insert(&canonicalKey);
+
+				if(graph->inserted())
+					vertex->constructor();
+
+				graph->setCoverageValue(vertex,coverage);
+				vertex->setVertexEdges(edges);
+
+				continue;
+			}
+		}
+
+		cout<<"Error: GenomeGraph checkpoint is truncated"<<endl;
+		return false;
+	}
+
+	cout<<"Rank "<<rank<<" loading checkpoint GenomeGraph ["<<vertices<<"/"<<vertices<<"]"<<endl;
+
+	return true;
+}
+
+void GraphCheckpoint::close(){
+
+	if(m_content==NULL)
+		return;
+
+#ifndef _WIN32
+	if(!m_allocated)
+		munmap(m_content,m_contentSize);
+#endif
+
+	if(m_allocated)
+		__Free(m_content,"RAY_MALLOC_TYPE_GRAPH_CHECKPOINT",false);
+
+	m_content=NULL;
+	m_contentSize=0;
+	m_header=NULL;
+	m_records=NULL;
+	m_body=NULL;
+	m_allocated=false;
+}
+
+void GraphCheckpoint::destructor(){
+	close();
+}
@@ -0,0 +1,169 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _GraphCheckpoint_h
+#define _GraphCheckpoint_h
+
+#include "GridTable.h"
+
+#include <code/KmerAcademyBuilder/Kmer.h>
+#include <code/KmerAcademyBuilder/MinimizerPlacement.h>
+#include <code/Mock/constants.h>
+
+#include <RayPlatform/core/types.h>
+
+#include <stdint.h>
+#include <stdio.h>
+
+/** 8 bytes, the legacy checkpoint starts with a number of k-mers instead */
+#define GRAPH_CHECKPOINT_MAGIC "RayGraph"
+
+/** fixed-size records, for the GenomeGraph checkpoint */
+#define GRAPH_CHECKPOINT_VERSION_RECORDS 4
+
+/** varint records, for the graph written with -write-kmers */
+#define GRAPH_CHECKPOINT_VERSION_VARINTS 5
+
+/** the versions 2 and 3 did not record the placement of the k-mers */
+#define GRAPH_CHECKPOINT_FIRST_VERSION_WITH_PLACEMENT 4
+
+/** the k-mers are placed with hash_function_1 */
+#define GRAPH_CHECKPOINT_PLACEMENT_HASH 0
+
+/** the k-mers are placed with -minimizer-placement */
+#define GRAPH_CHECKPOINT_PLACEMENT_MINIMIZERS 1
+
+/**
+ * One vertex of the graph with fixed-size records, only the lower k-mer is stored.
+ * The edges are the 8-bit map of Vertex (4 parents, 4 children)
+ * for the lower k-mer.
+ */
+class GraphCheckpointRecord{
+public:
+	uint64_t m_key[KMER_U64_ARRAY_SIZE];
+	CoverageDepth m_coverage;
+	uint8_t m_edges;
+};
+
+/**
+ * The header, the records follow it.
+ * The sizes are there to refuse a checkpoint that was written with
+ * another CONFIG_MAXKMERLENGTH or CONFIG_MAXIMUM_COVERAGE.
+ * m_recordSize is 0 when the records have no fixed size.
+ * The placement is there to refuse a checkpoint whose vertices would
+ * be on other ranks (-minimizer-placement, -minimizer-length, or
+ * another table).
+ */
+class GraphCheckpointHeader{
+public:
+	char m_magic[8];
+	uint32_t m_version;
+	uint32_t m_kmerLength;
+	uint32_t m_wordsPerKmer;
+	uint32_t m_recordSize;
+	uint32_t m_coverageSize;
+	uint32_t m_bucketsPerGroup;
+	uint64_t m_buckets;
+	uint64_t m_vertices;
+	uint32_t m_placement;
+	uint32_t m_minimizerLength;
+	uint64_t m_placementChecksum;
+};
+
+/**
+ * A binary checkpoint for the GridTable.
+ *
+ * The legacy format (written by older versions) stores each k-mer of a pair with
+ * its coverage and its parents and children as complete k-mers, and it
+ * is read one field at a time.
+ *
+ * With GRAPH_CHECKPOINT_VERSION_RECORDS, there is one fixed-size record
+ * per vertex with the edge bitmap. The records are in the order of the buckets of the
+ * hash table and they can be used directly (read-only).
+ *
+ * With GRAPH_CHECKPOINT_VERSION_VARINTS, the lower k-mers are sorted and each one is
+ * stored as the difference with the previous one, one varint
+ * (7 bits per byte) per 64-bit word. The edge bitmap (1 byte) and
+ * the coverage depth (varint) follow. The sorted k-mers of a rank
+ * are close to each other, so a vertex takes about half the space of
+ * a fixed-size record, and much less than in the legacy format.
+ *
+ * The fixed-size records are the GenomeGraph checkpoint, the varint
+ * records are the binary graph written with -write-kmers
+ * (RayOutput/Rank<N>.kmers.raygraph). The versions 2 and 3 had the
+ * same records without the placement of the k-mers in the header.
+ * In both formats, the file is mapped in memory with mmap and the
+ * vertices are inserted in a GridTable.
+ *
+ * \author Sébastien Boisvert
+ */
+class GraphCheckpoint{
+
+	GraphCheckpointHeader*m_header;
+	GraphCheckpointRecord*m_records;
+
+	uint8_t*m_content;
+	uint64_t m_contentSize;
+
+	/** the records start here */
+	uint8_t*m_body;
+
+/** the content was read with fread because mmap is not available */
+	bool m_allocated;
+
+	bool checkHeader(GraphCheckpointHeader*header,int kmerLength,MinimizerPlacement*placement);
+
+	bool hasFixedSizeRecords();
+	bool writeRecords(FILE*stream,GridTable*graph,LargeCount*written);
+	bool writeVarintRecords(FILE*stream,GridTable*graph,LargeCount*written);
+	bool loadRecords(GridTable*graph,Rank rank);
+	bool loadVarintRecords(GridTable*graph,Rank rank);
+
+public:
+
+	void constructor();
+
+	/** check the magic number, the legacy format does not have one */
+	static bool hasMagicNumber(const char*file);
+
+	/**
+	 * write the vertices of a GridTable, version is GRAPH_CHECKPOINT_VERSION_RECORDS
+	 * or GRAPH_CHECKPOINT_VERSION_VARINTS, placement is NULL with hash_function_1
+	 */
+	bool write(const char*file,GridTable*graph,int kmerLength,
+		uint64_t buckets,int bucketsPerGroup,MinimizerPlacement*placement,uint32_t version);
+
+	/** map a checkpoint in memory, placement is NULL with hash_function_1 */
+	bool open(const char*file,int kmerLength,MinimizerPlacement*placement);
+
+	LargeCount getNumberOfVertices();
+
+	/** only for GRAPH_CHECKPOINT_VERSION_RECORDS */
+	GraphCheckpointRecord*getRecord(LargeIndex index);
+	void getKey(LargeIndex index,Kmer*key);
+
+	/** insert all the vertices in a GridTable, false if the file is damaged */
+	bool load(GridTable*graph,Rank rank);
+
+	void close();
+	void destructor();
+};
+
+#endif
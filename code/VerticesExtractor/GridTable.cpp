@@ -25,6 +25,7 @@
 #include <code/Mock/common_functions.h>
 
 #include <RayPlatform/core/OperatingSystem.h>
+#include <RayPlatform/structures/MyHashTableIterator.h>
 #include <RayPlatform/cryptography/crypto.h>
 
 #include <assert.h>
@@ -54,6 +55,10 @@ void GridTable::constructor(int rank,Parameters*parameters){
 	if(m_parameters->hasOption("-hash-table-verbosity"))
 		m_hashTable.toggleVerbosity();
 
+	m_coverageOverflow.constructor();
+
+	m_readAnnotations.constructor(m_parameters->showMemoryAllocations());
+
 	m_inserted=false;
 
 	if(m_parameters->showMemoryUsage()){
@@ -86,10 +91,21 @@ Vertex*GridTable::find(Kmer*key){
 	assert(key!=NULL);
 	#endif
 
-	Kmer lowerKey=key->complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
-	if(key->isLower(&lowerKey)){
-		lowerKey=*key;
-	}
+	CanonicalKmer canonicalKey;
+	canonicalKey.constructor(key,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+
+	return findLowerKey(canonicalKey.getLowerKey());
+}
+
+Vertex*GridTable::find(CanonicalKmer*key){
+	#ifdef CONFIG_ASSERT
+	assert(key!=NULL);
+	#endif
+
+	return findLowerKey(key->getLowerKey());
+}
+
+Vertex*GridTable::findLowerKey(Kmer*lowerKey){
 
 	m_findOperations++;
 
@@ -98,7 +114,7 @@ Vertex*GridTable::find(Kmer*key){
 		m_hashTable.toggleVerbosity();
 	}
 
-	Vertex*vertex= m_hashTable.find(&lowerKey);
+	Vertex*vertex= m_hashTable.find(lowerKey);
 
 	// turns off verbosity
 	if(m_verbose && m_findOperations%100000==0){
@@ -117,13 +133,24 @@ Vertex*GridTable::insert(Kmer*key){
 	assert(m_parameters!=NULL);
 	#endif
 
-	Kmer lowerKey=key->complementVertex(m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
-	if(key->isLower(&lowerKey)){
-		lowerKey=*key;
-	}
+	CanonicalKmer canonicalKey;
+	canonicalKey.constructor(key,m_parameters->getWordSize(),m_parameters->getColorSpaceMode());
+
+	return insertLowerKey(canonicalKey.getLowerKey());
+}
+
+Vertex*GridTable::insert(CanonicalKmer*key){
+	#ifdef CONFIG_ASSERT
+	assert(key!=NULL);
+	#endif
+
+	return insertLowerKey(key->getLowerKey());
+}
+
+Vertex*GridTable::insertLowerKey(Kmer*lowerKey){
 
 	LargeCount sizeBefore=m_hashTable.size();
-	Vertex*entry=m_hashTable.insert(&lowerKey);
+	Vertex*entry=m_hashTable.insert(lowerKey);
 	m_inserted=m_hashTable.size()>sizeBefore;
 
 	if(m_inserted){
@@ -172,6 +199,10 @@ void GridTable::addRead(Kmer*a,ReadAnnotation*e){
 	assert(e!=NULL);
 	#endif
 
+	#ifdef CONFIG_ASSERT
+	assert(!m_readAnnotations.isFrozen());
+	#endif
+
 	Vertex*i=find(a);
 	i->addRead(a,e);
 
@@ -234,7 +265,7 @@ vector<Direction> GridTable::getDirections(Kmer*a){
 
 	/* do a copy to track to check for a segmentation fault */
 	Vertex copy=*i;
-	assert(copy.getVertexCoverage() >= 1);
+	assert(copy.getCounter() >= 1);
 	#endif
 
 	return i->getDirections(a);
@@ -258,8 +289,122 @@ MyHashTable<Kmer,Vertex>*GridTable::getHashTable(){
 	return &m_hashTable;
 }
 
+/*
+ * The counter of the vertex, or the overflow table when it is saturated.
+ */
+CoverageDepth GridTable::getCoverage(Vertex*vertex){
+
+	CoverageDepth coverage=vertex->getCounter();
+
+	if(coverage!=VERTEX_COVERAGE_SATURATED)
+		return coverage;
+
+	Kmer key=vertex->getKey();
+	CoverageDepth overflow=m_coverageOverflow.getCoverage(&key);
+
+	if(overflow<VERTEX_COVERAGE_SATURATED)
+		return coverage;
+
+	return overflow;
+}
+
+/*
+ * Only the lower k-mer of the pair changes the coverage,
+ * like Vertex::setCoverage.
+ */
+void GridTable::setCoverage(Vertex*vertex,Kmer*key,CoverageDepth coverage){
+
+	if(!(*key==vertex->getKey()))
+		return;
+
+	CoverageDepth max=0;
+	max=max-1;// underflow.
+
+	if(getCoverage(vertex)==max) // maximum value
+		return;
+
+	setCoverageValue(vertex,coverage);
+}
+
+void GridTable::setCoverageValue(Vertex*vertex,CoverageDepth coverage){
+
+	Kmer key=vertex->getKey();
+
+	if(coverage<VERTEX_COVERAGE_SATURATED){
+
+		if(vertex->getCounter()==VERTEX_COVERAGE_SATURATED)
+			m_coverageOverflow.removeCoverage(&key);
+
+	}else{
+		m_coverageOverflow.setCoverage(&key,coverage);
+	}
+
+	vertex->setCoverageValue(coverage);
+}
+
+/*
+ * The annotations are counted first so that the table is
+ * allocated once.
+ */
+void GridTable::freezeReadAnnotations(){
+
+	if(m_readAnnotations.isFrozen())
+		return;
+
+	LargeCount annotations=0;
+
+	MyHashTableIterator<Kmer,Vertex> iterator;
+	iterator.constructor(&m_hashTable);
+
+	while(iterator.hasNext()){
+		Vertex*node=iterator.next();
+		Kmer key=node->getKey();
+
+		ReadAnnotation*annotation=node->getReads(&key);
+
+		while(annotation!=NULL){
+			annotations++;
+			annotation=annotation->getNext();
+		}
+	}
+
+	m_readAnnotations.allocate(annotations);
+
+	vector<ReadAnnotation> list;
+
+	iterator.constructor(&m_hashTable);
+
+	while(iterator.hasNext()){
+		Vertex*node=iterator.next();
+		Kmer key=node->getKey();
+
+		list.clear();
+
+		ReadAnnotation*annotation=node->getReads(&key);
+
+		while(annotation!=NULL){
+			list.push_back(*annotation);
+			annotation=annotation->getNext();
+		}
+
+		node->setFirstRead(m_readAnnotations.addAnnotations(&list));
+	}
+
+	m_readAnnotations.freeze();
+
+	cout<<"Rank "<<m_parameters->getRank()<<" GridTable: "<<m_readAnnotations.size()<<" read annotations in ";
+	cout<<m_readAnnotations.size()*sizeof(FrozenReadAnnotation)/1024<<" KiB"<<endl;
+}
+
+ReadAnnotationTable*GridTable::getReadAnnotationTable(){
+	return &m_readAnnotations;
+}
+
 void GridTable::printStatistics(){
 	m_hashTable.printProbeStatistics();
+
+	cout<<"Rank "<<m_parameters->getRank()<<" GridTable: "<<m_coverageOverflow.size();
+	cout<<" vertices with a coverage depth of at least "<<(CoverageDepth)VERTEX_COVERAGE_SATURATED<<endl;
 }
 
 void GridTable::completeResizing(){
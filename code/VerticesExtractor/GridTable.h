@@ -23,8 +23,11 @@
 #define _GridTable
 
 #include "Vertex.h"
+#include "CoverageOverflowTable.h"
 
 #include <code/KmerAcademyBuilder/Kmer.h>
+#include <code/KmerAcademyBuilder/CanonicalKmer.h>
+#include <code/SequencesIndexer/ReadAnnotationTable.h>
 #include <code/Mock/Parameters.h>
 
 #include <RayPlatform/structures/MyHashTable.h>
@@ -38,6 +41,13 @@
  */
 class GridTable{
 	MyHashTable<Kmer,Vertex> m_hashTable;
+
+	/** coverage depths that do not fit in the vertices */
+	CoverageOverflowTable m_coverageOverflow;
+
+	/** read annotations of the vertices after the indexing */
+	ReadAnnotationTable m_readAnnotations;
+
 	Parameters*m_parameters;
 	LargeCount m_size;
 	bool m_inserted;
@@ -47,15 +57,32 @@ class GridTable{
 	/** verbosity */
 	bool m_verbose;
 
+	Vertex*findLowerKey(Kmer*lowerKey);
+	Vertex*insertLowerKey(Kmer*lowerKey);
+
 public:
 	void constructor(Rank rank,Parameters*a);
 	LargeCount size();
 	Vertex*find(Kmer*key);
 	Vertex*insert(Kmer*key);
+
+/**
+ * These do not compute the reverse complement, the key
+ * is already canonical.
+ */
+	Vertex*find(CanonicalKmer*key);
+	Vertex*insert(CanonicalKmer*key);
 	bool inserted();
 
 	void addRead(Kmer*a,ReadAnnotation*e);
 	ReadAnnotation*getReads(Kmer*a);
+
+/**
+ * Move the read annotations of the vertices in the ReadAnnotationTable.
+ * After that, the allocator of the annotations can be cleared.
+ */
+	void freezeReadAnnotations();
+	ReadAnnotationTable*getReadAnnotationTable();
 	void addDirection(Kmer*a,Direction*d);
 	vector<Direction> getDirections(Kmer*a);
 	void clearDirections(Kmer*a);
@@ -64,6 +91,14 @@ public:
 	bool isAssembledByGreaterRank(Kmer*a,Rank origin);
 
 	MyHashTable<Kmer,Vertex>*getHashTable();
+
+	/** the complete coverage of a vertex of this table */
+	CoverageDepth getCoverage(Vertex*vertex);
+
+	/** the coverage of a vertex of this table, with the overflow table */
+	void setCoverage(Vertex*vertex,Kmer*key,CoverageDepth coverage);
+	void setCoverageValue(Vertex*vertex,CoverageDepth coverage);
+
 	void printStatistics();
 	void completeResizing();
 
@@ -72,30 +72,31 @@ bool Vertex::isAssembledByGreaterRank(Rank origin){
 	return origin<m_assembled;
 }
 
+/*
+ * The counter in the vertex is small, a value that does not fit
+ * saturates it. The GridTable keeps the complete value of its
+ * vertices (GridTable::setCoverageValue).
+ */
 void Vertex::setCoverageValue(CoverageDepth coverage) {
 
-	m_coverage_lower = coverage;
+	if(coverage<VERTEX_COVERAGE_SATURATED)
+		m_coverage_lower = coverage;
+	else
+		m_coverage_lower = VERTEX_COVERAGE_SATURATED;
 }
 
 void Vertex::setCoverage(Kmer*a,CoverageDepth coverage){
 	if(*a==m_lowerKey){
 
-		CoverageDepth max=0;
-		max=max-1;// underflow.
-
-		if(m_coverage_lower==max){ // maximum value
+		if(m_coverage_lower==VERTEX_COVERAGE_SATURATED){ // maximum value
 			return;
 		}
 
-		m_coverage_lower=coverage;
+		setCoverageValue(coverage);
 	}
 }
 
-CoverageDepth Vertex::getVertexCoverage() const{
-	return getCoverage(&m_lowerKey);
-}
-
-CoverageDepth Vertex::getCoverage(const Kmer*a) const{
+VertexCoverage Vertex::getCounter() const{
 	return m_coverage_lower;
 }
 
@@ -166,6 +167,10 @@ uint8_t Vertex::getVertexEdges() const{
 	return getEdges(&m_lowerKey);
 }
 
+void Vertex::setVertexEdges(uint8_t edges){
+	setEdgeSet(edges);
+}
+
 uint8_t Vertex::getEdges(const Kmer*a) const{
 	if(*a==m_lowerKey)
 		return m_edges_lower;
@@ -204,6 +209,14 @@ ReadAnnotation*Vertex::getReads(Kmer*vertex){
 	return m_readsStartingHere;
 }
 
+ReadAnnotationCursor Vertex::getFirstRead(){
+	return m_firstRead;
+}
+
+void Vertex::setFirstRead(ReadAnnotationCursor cursor){
+	m_firstRead=cursor;
+}
+
 vector<Direction> Vertex::getDirections(Kmer*vertex){
 	bool seekLower=false;
 
@@ -254,24 +267,6 @@ void Vertex::clearDirections(Kmer*a){
 	m_directions=NULL;
 }
 
-void Vertex::write(Kmer*key, ostream*f,int kmerLength){
-	int coverage=getCoverage(key);
-	key->write(f);
-	f->write((char*)&coverage,sizeof(int));
-	vector<Kmer> parents=getIngoingEdges(key,kmerLength);
-	vector<Kmer> children=getOutgoingEdges(key,kmerLength);
-	int numberOfParents=parents.size();;
-	f->write((char*)&numberOfParents,sizeof(int));
-	for(int i=0;i<(int)parents.size();i++){
-		parents[i].write(f);
-	}
-	int numberOfChildren=children.size();
-	f->write((char*)&numberOfChildren,sizeof(int));
-	for(int i=0;i<(int)children.size();i++){
-		children[i].write(f);
-	}
-}
-
 void Vertex::writeAnnotations(Kmer*key,ostream*f,int kmerLength,bool color){
 	key->write(f);
 
@@ -420,13 +415,24 @@ Direction*Vertex::getFirstDirection()const{
 }
 
 int Vertex::load(const char * buffer) {
+	CoverageDepth coverage = 0;
+	return load(buffer, &coverage);
+}
+
+/*
+ * The complete coverage is transported, not the counter.
+ * It is returned to the caller, the vertex gets the counter.
+ */
+int Vertex::load(const char * buffer, CoverageDepth * coverage) {
 	int position = 0;
 	position += m_lowerKey.load(buffer);
 
-	int bytes = sizeof(m_coverage_lower);
-	memcpy(&m_coverage_lower, buffer + position, bytes);
+	int bytes = sizeof(CoverageDepth);
+	memcpy(coverage, buffer + position, bytes);
 	position += bytes;
 
+	setCoverageValue(*coverage);
+
 	bytes = sizeof(m_edges_lower);
 	memcpy(&m_edges_lower, buffer + position, bytes);
 	position += bytes;
@@ -436,12 +442,20 @@ int Vertex::load(const char * buffer) {
 }
 
 int Vertex::dump(char * buffer) const {
+	return dump(buffer, getCounter());
+}
+
+/*
+ * The coverage is given because the counter of the vertex can be
+ * saturated.
+ */
+int Vertex::dump(char * buffer, CoverageDepth coverage) const {
 
 	int position = 0;
 	position += m_lowerKey.dump(buffer);
 
-	int bytes = sizeof(m_coverage_lower);
-	memcpy(buffer + position, &m_coverage_lower, bytes);
+	int bytes = sizeof(coverage);
+	memcpy(buffer + position, &coverage, bytes);
 	position += bytes;
 
 	uint8_t edges = getEdgeSet();
@@ -462,14 +476,14 @@ int Vertex::getRequiredNumberOfBytes() const {
 
 	//cout << "DEBUG sizeof(m_coverage_lower) is " << sizeof(m_coverage_lower) << endl;
 
-	return m_lowerKey.getRequiredNumberOfBytes() + sizeof(m_coverage_lower) + sizeof(m_edges_lower);
+	return m_lowerKey.getRequiredNumberOfBytes() + sizeof(CoverageDepth) + sizeof(m_edges_lower);
 }
 
 void Vertex::print(int kmerLength, bool colorSpaceMode) const {
 
 	cout << " Vertex key= ";
 	cout << m_lowerKey.idToWord(kmerLength, colorSpaceMode);
-	cout << " " << getVertexCoverage();
+	cout << " " << getCounter();
 	cout << " parents: " << getIngoingEdges(&m_lowerKey, kmerLength).size();
 	cout << " children: " << getOutgoingEdges(&m_lowerKey, kmerLength).size();
 	cout << endl;
@@ -22,7 +22,7 @@
 #ifndef _Vertex
 #define _Vertex
 
-#include <code/SequencesIndexer/ReadAnnotation.h>
+#include <code/SequencesIndexer/ReadAnnotationTable.h>
 #include <code/SeedExtender/Direction.h>
 #include <code/KmerAcademyBuilder/Kmer.h>
 #include <code/Mock/common_functions.h>
@@ -142,13 +142,22 @@ private:
 /*
  * 	read annotations
  * 	which reads start here?
+ *
+ * 	While the sequences are indexed, this is a linked list.
+ * 	After GridTable::freezeReadAnnotations, this is the cursor of
+ * 	the first annotation in the ReadAnnotationTable of the rank.
  */
-	ReadAnnotation*m_readsStartingHere;
+	union{
+		ReadAnnotation*m_readsStartingHere;
+		ReadAnnotationCursor m_firstRead;
+	};
 
 /*
  *	The coverage of the vertex
+ *	When it is VERTEX_COVERAGE_SATURATED, the coverage of a vertex
+ *	of the graph is in the CoverageOverflowTable of its GridTable.
  */
-	CoverageDepth m_coverage_lower;
+	VertexCoverage m_coverage_lower;
 
 /**
  * TODO: there should be a sister class that does not store
@@ -186,8 +195,13 @@ public:
 	void constructor();
 	void setCoverage(Kmer*a,CoverageDepth coverage);
 	void setCoverageValue(CoverageDepth coverage);
-	CoverageDepth getCoverage(const Kmer*p) const;
-	CoverageDepth getVertexCoverage() const;
+
+/**
+ * The saturating counter, it is VERTEX_COVERAGE_SATURATED for
+ * a coverage that does not fit. GridTable::getCoverage has the
+ * coverage depth of a vertex of the graph.
+ */
+	VertexCoverage getCounter() const;
 
 	// TODO: add methods to add parents and children without
 	// having to provide the base kmer.
@@ -212,12 +226,22 @@ public:
 	uint8_t getEdges(const Kmer*a) const;
 
 	uint8_t getVertexEdges() const;
+
+/**
+ * set the edges of the lower k-mer, this is the bitmap
+ * returned by getVertexEdges
+ */
+	void setVertexEdges(uint8_t edges);
 	void deleteIngoingEdge(Kmer*vertex,Kmer*a,int k);
 	void deleteOutgoingEdge(Kmer*vertex,Kmer*a,int k);
 
 
 	void addRead(Kmer*a,ReadAnnotation*e);
 	ReadAnnotation*getReads(Kmer*a);
+
+/** only after GridTable::freezeReadAnnotations */
+	ReadAnnotationCursor getFirstRead();
+	void setFirstRead(ReadAnnotationCursor cursor);
 	void addDirection(Kmer*a,Direction*d);
 	vector<Direction> getDirections(Kmer*a);
 	void clearDirections(Kmer*a);
@@ -226,7 +250,6 @@ public:
 	bool isAssembled();
 	bool isAssembledByGreaterRank(Rank origin);
 
-	void write(Kmer*key,ostream*f,int kmerLength);
 	void writeAnnotations(Kmer*key,ostream*f,int kmerLength,bool color);
 
 	VirtualKmerColorHandle getVirtualColor();
@@ -238,8 +261,13 @@ public:
 
 	Direction*getFirstDirection()const;
 
+	/** with the counter as the coverage, for a vertex that is not in a GridTable */
 	int load(const char * buffer);
 	int dump(char * buffer) const;
+
+	/** the same with the complete coverage, which may not fit in the vertex */
+	int load(const char * buffer, CoverageDepth * coverage);
+	int dump(char * buffer, CoverageDepth coverage) const;
 	int getRequiredNumberOfBytes() const;
 
 	void print(int kmerLength, bool colorSpaceMode) const;
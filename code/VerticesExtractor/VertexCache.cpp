@@ -0,0 +1,228 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#include "VertexCache.h"
+
+#include <RayPlatform/memory/allocator.h>
+
+#include <iostream>
+#include <string.h>
+using namespace std;
+
+#ifdef CONFIG_ASSERT
+#include <assert.h>
+#endif
+
+void VertexCache::constructor(uint64_t entries,bool showMemoryAllocations){
+
+	m_entries=NULL;
+	m_hands=NULL;
+	m_sets=0;
+	m_showMemoryAllocations=showMemoryAllocations;
+
+	resetStatistics();
+
+	if(entries<VERTEX_CACHE_WAYS)
+		return;
+
+/* the number of sets is a power of 2 */
+	m_sets=1;
+	while(m_sets*2*VERTEX_CACHE_WAYS<=entries)
+		m_sets*=2;
+
+	m_entries=(VertexCacheEntry*)__Malloc(m_sets*VERTEX_CACHE_WAYS*sizeof(VertexCacheEntry),
+		"RAY_MALLOC_TYPE_VERTEX_CACHE",m_showMemoryAllocations);
+
+/* the entries hold a Kmer, so they are not cleared with memset */
+	VertexCacheEntry emptyEntry;
+	emptyEntry.m_coverage=0;
+	emptyEntry.m_edges=0;
+	emptyEntry.m_flags=0;
+
+	for(uint64_t i=0;i<m_sets*VERTEX_CACHE_WAYS;i++)
+		m_entries[i]=emptyEntry;
+
+	m_hands=(uint8_t*)__Malloc(m_sets*sizeof(uint8_t),
+		"RAY_MALLOC_TYPE_VERTEX_CACHE",m_showMemoryAllocations);
+	memset(m_hands,0,m_sets*sizeof(uint8_t));
+}
+
+bool VertexCache::isEnabled(){
+	return m_entries!=NULL;
+}
+
+/*
+ * hash_function_1 is used to place the vertices on the ranks, so
+ * the other one is used here.
+ */
+VertexCacheEntry*VertexCache::findEntry(const Kmer*key){
+
+	VertexCacheEntry*set=m_entries+(key->hash_function_2()&(m_sets-1))*VERTEX_CACHE_WAYS;
+
+	for(int i=0;i<VERTEX_CACHE_WAYS;i++){
+		VertexCacheEntry*entry=set+i;
+
+		if((entry->m_flags & VERTEX_CACHE_FLAG_VALID) && entry->m_key==*key)
+			return entry;
+	}
+
+	return NULL;
+}
+
+VertexCacheEntry*VertexCache::getFreeEntry(const Kmer*key){
+
+	uint64_t setIndex=key->hash_function_2()&(m_sets-1);
+	VertexCacheEntry*set=m_entries+setIndex*VERTEX_CACHE_WAYS;
+
+	for(int i=0;i<VERTEX_CACHE_WAYS;i++){
+		if(!(set[i].m_flags & VERTEX_CACHE_FLAG_VALID))
+			return set+i;
+	}
+
+/* the hand clears the referenced bits until it finds an entry without one */
+	while(1){
+		VertexCacheEntry*entry=set+m_hands[setIndex];
+		m_hands[setIndex]=(m_hands[setIndex]+1)%VERTEX_CACHE_WAYS;
+
+		if(entry->m_flags & VERTEX_CACHE_FLAG_REFERENCED){
+			entry->m_flags&= ~VERTEX_CACHE_FLAG_REFERENCED;
+			continue;
+		}
+
+		m_evictions++;
+		entry->m_flags=0;
+
+		return entry;
+	}
+
+	return NULL;
+}
+
+bool VertexCache::getCoverage(const Kmer*key,CoverageDepth*coverage){
+
+	if(!isEnabled())
+		return false;
+
+	VertexCacheEntry*entry=findEntry(key);
+
+	if(entry==NULL){
+		m_misses++;
+		return false;
+	}
+
+	entry->m_flags|=VERTEX_CACHE_FLAG_REFERENCED;
+	*coverage=entry->m_coverage;
+	m_hits++;
+
+	return true;
+}
+
+bool VertexCache::getVertex(const Kmer*key,uint8_t*edges,CoverageDepth*coverage){
+
+	if(!isEnabled())
+		return false;
+
+	VertexCacheEntry*entry=findEntry(key);
+
+	if(entry==NULL || !(entry->m_flags & VERTEX_CACHE_FLAG_EDGES)){
+		m_misses++;
+		return false;
+	}
+
+	entry->m_flags|=VERTEX_CACHE_FLAG_REFERENCED;
+	*edges=entry->m_edges;
+	*coverage=entry->m_coverage;
+	m_hits++;
+
+	return true;
+}
+
+void VertexCache::addCoverage(const Kmer*key,CoverageDepth coverage){
+
+	if(!isEnabled())
+		return;
+
+	VertexCacheEntry*entry=findEntry(key);
+
+	if(entry!=NULL){
+		#ifdef CONFIG_ASSERT
+		assert(entry->m_coverage==coverage);
+		#endif
+		return;
+	}
+
+	entry=getFreeEntry(key);
+	entry->m_key=*key;
+	entry->m_coverage=coverage;
+	entry->m_edges=0;
+	entry->m_flags=VERTEX_CACHE_FLAG_VALID;
+}
+
+void VertexCache::addVertex(const Kmer*key,uint8_t edges,CoverageDepth coverage){
+
+	if(!isEnabled())
+		return;
+
+	VertexCacheEntry*entry=findEntry(key);
+
+	if(entry==NULL){
+		entry=getFreeEntry(key);
+		entry->m_key=*key;
+		entry->m_flags=VERTEX_CACHE_FLAG_VALID;
+	}
+
+	entry->m_coverage=coverage;
+	entry->m_edges=edges;
+	entry->m_flags|=VERTEX_CACHE_FLAG_EDGES;
+}
+
+void VertexCache::printStatistics(Rank rank,const char*step){
+
+	if(!isEnabled())
+		return;
+
+	LargeCount queries=m_hits+m_misses;
+	double ratio=0;
+
+	if(queries>0)
+		ratio=(100.0*m_hits)/queries;
+
+	cout<<"Rank "<<rank<<" VertexCache ("<<step<<"): "<<m_hits<<" hits, "<<m_misses<<" misses (";
+	cout<<ratio<<"% hits), "<<m_evictions<<" evictions, "<<m_sets*VERTEX_CACHE_WAYS<<" entries"<<endl;
+}
+
+void VertexCache::resetStatistics(){
+	m_hits=0;
+	m_misses=0;
+	m_evictions=0;
+}
+
+void VertexCache::destructor(){
+
+	if(m_entries!=NULL)
+		__Free(m_entries,"RAY_MALLOC_TYPE_VERTEX_CACHE",m_showMemoryAllocations);
+
+	if(m_hands!=NULL)
+		__Free(m_hands,"RAY_MALLOC_TYPE_VERTEX_CACHE",m_showMemoryAllocations);
+
+	m_entries=NULL;
+	m_hands=NULL;
+	m_sets=0;
+}
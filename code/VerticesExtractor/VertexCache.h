@@ -0,0 +1,112 @@
+/*
+    Ray -- Parallel genome assemblies for parallel DNA sequencing
+    Copyright (C) 2013 Sébastien Boisvert
+
+	http://DeNovoAssembler.SourceForge.Net/
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, version 3 of the License.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You have received a copy of the GNU General Public License
+    along with this program (gpl-3.0.txt).
+	see <http://www.gnu.org/licenses/>
+*/
+
+#ifndef _VertexCache_h
+#define _VertexCache_h
+
+#include <code/KmerAcademyBuilder/Kmer.h>
+#include <code/Mock/constants.h>
+
+#include <RayPlatform/core/types.h>
+
+#include <stdint.h>
+
+/** the entry has a coverage depth */
+#define VERTEX_CACHE_FLAG_VALID 0x1
+/** the entry has an edge bitmap too */
+#define VERTEX_CACHE_FLAG_EDGES 0x2
+/** the entry was used since the clock hand passed */
+#define VERTEX_CACHE_FLAG_REFERENCED 0x4
+
+/** entries in a set */
+#define VERTEX_CACHE_WAYS 4
+
+/** default number of entries, changed with -vertex-cache-entries */
+#define VERTEX_CACHE_DEFAULT_ENTRIES 131072
+
+/**
+ * A cached vertex. The edge bitmap is the one of this k-mer
+ * (not of its reverse complement).
+ */
+class VertexCacheEntry{
+public:
+	Kmer m_key;
+	CoverageDepth m_coverage;
+	uint8_t m_edges;
+	uint8_t m_flags;
+};
+
+/**
+ * A bounded cache for the vertices stored on other ranks.
+ *
+ * After the graph is built (and purged), the coverage depth and the
+ * edges of a vertex do not change anymore, so the answers of
+ * RAY_MPI_TAG_REQUEST_VERTEX_COVERAGE, RAY_MPI_TAG_GET_VERTEX_EDGES_COMPACT
+ * and RAY_MPI_TAG_VERTEX_INFO can be kept on the rank that asked.
+ * The assembled flag and the read annotations change and they are not
+ * cached here.
+ *
+ * The cache is set-associative (VERTEX_CACHE_WAYS entries per set)
+ * and a clock hand in each set evicts entries that were not used
+ * since it last passed (CLOCK, an approximation of LRU).
+ *
+ * There is one cache per rank, it is shared by the seeding and the
+ * extension.
+ *
+ * \author Sébastien Boisvert
+ */
+class VertexCache{
+
+	VertexCacheEntry*m_entries;
+	uint8_t*m_hands;
+	uint64_t m_sets;
+
+	LargeCount m_hits;
+	LargeCount m_misses;
+	LargeCount m_evictions;
+
+	bool m_showMemoryAllocations;
+
+	VertexCacheEntry*findEntry(const Kmer*key);
+	VertexCacheEntry*getFreeEntry(const Kmer*key);
+
+public:
+
+	/** entries is rounded down to a power of 2, 0 disables the cache */
+	void constructor(uint64_t entries,bool showMemoryAllocations);
+
+	bool isEnabled();
+
+	/** returns true and fills coverage if the vertex is in the cache */
+	bool getCoverage(const Kmer*key,CoverageDepth*coverage);
+
+	/** returns true and fills edges and coverage if the edges are in the cache */
+	bool getVertex(const Kmer*key,uint8_t*edges,CoverageDepth*coverage);
+
+	void addCoverage(const Kmer*key,CoverageDepth coverage);
+	void addVertex(const Kmer*key,uint8_t edges,CoverageDepth coverage);
+
+	void printStatistics(Rank rank,const char*step);
+	void resetStatistics();
+
+	void destructor();
+};
+
+#endif